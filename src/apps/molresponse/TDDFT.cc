@@ -3543,6 +3543,8 @@ Tensor<double> TDDFT::CreateGroundHamiltonian(World &world,
   } else {  // DFT
 
     XCOperator<double, 3> xcop = create_XCOperator(world, f, r_params.xc());
+    MADNESS_CHECK_THROW((*xcop.xc).hf_exchange_sr_coefficient() == 0.0,
+                        "molresponse: range-separated hybrids are not implemented");
 
     real_function_3d v_xc = xcop.make_xc_potential();
     v = v + v_xc;
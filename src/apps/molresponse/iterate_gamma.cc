@@ -57,6 +57,8 @@ vecfuncT K(vecfuncT& ket, vecfuncT& bra, vecfuncT& vf) {
 X_space TDDFT::compute_gamma_full(World& world,
                                   X_space& Chi,
                                   const XCOperator<double, 3> &xc) {
+  MADNESS_CHECK_THROW(xcf.hf_exchange_sr_coefficient() == 0.0,
+                      "molresponse: range-separated hybrids are not implemented");
   size_t m = Chi.num_states();
   size_t n = Chi.num_orbitals();
   //  copy old pmap
@@ -204,6 +206,8 @@ X_space TDDFT::compute_gamma_full(World& world,
 X_space TDDFT::compute_gamma_static(World& world,
                                     X_space& Chi,
                                     XCOperator<double, 3> xc) {
+  MADNESS_CHECK_THROW(xcf.hf_exchange_sr_coefficient() == 0.0,
+                      "molresponse: range-separated hybrids are not implemented");
   size_t m = r_params.num_states();
   size_t n = r_params.num_orbitals();
   // shallow copy
@@ -307,6 +311,8 @@ X_space TDDFT::compute_gamma_static(World& world,
 X_space TDDFT::compute_gamma_tda(World& world,
                                  X_space& Chi,
                                  XCOperator<double, 3> xc) {
+  MADNESS_CHECK_THROW(xcf.hf_exchange_sr_coefficient() == 0.0,
+                      "molresponse: range-separated hybrids are not implemented");
   size_t m = Chi.num_states();
   size_t n = Chi.num_orbitals();
 
@@ -422,6 +428,8 @@ X_space TDDFT::compute_V0X(World& world,
                            X_space& Chi,
                            XCOperator<double, 3> xc,
                            bool compute_Y) {
+  MADNESS_CHECK_THROW(xcf.hf_exchange_sr_coefficient() == 0.0,
+                      "molresponse: range-separated hybrids are not implemented");
   // Start a timer
 
   size_t m = Chi.num_states();
@@ -77,6 +77,7 @@ struct InputParameters {
   int nio;            // Number of IO nodes
   double tScale;      // Scaling parameter for optimization
   double target_time; // Target end-time for the simulation
+  std::vector<double> fields; // Field strengths of additional states propagated together with F
 
   void read(const char* filename) {
     std::ifstream f(filename);
@@ -178,6 +179,15 @@ struct InputParameters {
             f >> tScale;
             printf("         tScale = %.5f\n", tScale);
         }
+        else if (tag == "fields") {
+            int nfield;
+            f >> nfield;
+            fields.resize(nfield);
+            for (int i=0; i<nfield; i++) f >> fields[i];
+            printf("         fields =");
+            for (int i=0; i<nfield; i++) printf(" %.6f", fields[i]);
+            printf("\n");
+        }
         else {
             MADNESS_EXCEPTION("unknown input option", 0);
         }
@@ -189,7 +199,7 @@ struct InputParameters {
     ar & L & Lsmall & Llarge & F & omega & ncycle & natom & Z;
     ar & archive::wrap(&(R[0][0]), 3*MAXNATOM);
     ar & k & thresh & safety & cut & iState & prefix & ndump & nplot & nprint & nloadbal & nio;
-    ar & target_time & tScale;
+    ar & target_time & tScale & fields;
   }
 };
 
@@ -231,21 +241,27 @@ typedef Convolution1D<double_complex> complex_operatorT;
         template <typename Archive> void serialize(Archive& ar) {}
     };
 
-complex_functionT APPLY(const complex_operatorT* q1d, const complex_functionT& psi) {
-    complex_functionT r = psi;  // Shallow copy violates constness !!!!!!!!!!!!!!!!!
-    coordT lo, hi;
-    lo[2] = -10;
-    hi[2] = +10;
-
-    r.reconstruct();
-    r.broaden();
-    r.broaden();
-    r.broaden();
-    r.broaden();
+// Applies the free-particle propagator to all states together.  The pushes
+// of all states in one direction share a single fence and the cached
+// operator blocks.  The 1d push is linear and accepts coefficients at any
+// level of the tree, so the partial results stay in the redundant (not
+// summed down) representation until the final direction.
+std::vector<complex_functionT> APPLY(World& world, const complex_operatorT* q1d,
+                                     const std::vector<complex_functionT>& psi) {
+    std::vector<complex_functionT> r = psi;  // Shallow copy violates constness !!!!!!!!!!!!!!!!!
+
+    reconstruct(world, r);
+    for (int i=0; i<4; i++) {
+        for (unsigned int s=0; s<r.size(); s++) r[s].broaden(FunctionDefaults<3>::get_bc(), false);
+        world.gop.fence();
+    }
 
-    r = apply_1d_realspace_push(*q1d, r, 2); r.sum_down();
-    r = apply_1d_realspace_push(*q1d, r, 1); r.sum_down();
-    r = apply_1d_realspace_push(*q1d, r, 0); r.sum_down();
+    for (int axis=2; axis>=0; axis--) {
+        for (unsigned int s=0; s<r.size(); s++) r[s] = apply_1d_realspace_push(*q1d, r[s], axis, false);
+        world.gop.fence();
+    }
+    for (unsigned int s=0; s<r.size(); s++) r[s].sum_down(false);
+    world.gop.fence();
 
     return r;
 }
@@ -393,15 +409,25 @@ double zdipole(const coordT& r) {
     return r[2];
 }
 
+// Number of states propagated together ... state 0 sees field F, state i>0 sees fields[i-1]
+int nstate() {
+    return 1 + param.fields.size();
+}
+
+// Peak field strength seen by a state
+double field_strength(int state) {
+    return state ? param.fields[state-1] : param.F;
+}
+
 // Strength of the laser field at time t
-double laser(double t) {
+double laser(double t, int state=0) {
     double omegat = param.omega*t;
 
     if (omegat < 0.0 || omegat/(2*param.ncycle) > constants::pi) return 0.0;
 
     double envelope = sin(omegat/(2*param.ncycle));
     envelope *= envelope;
-    return param.F*envelope*sin(omegat);
+    return field_strength(state)*envelope*sin(omegat);
 }
 
 double myreal(double t) {return t;}
@@ -487,52 +513,67 @@ void converge2s(World& world, functionT& potn, functionT& psi, double& eps) {
     }
 }
 
-complex_functionT chin_chen(const complex_functionT& expV_0,
-                            const complex_functionT& expV_tilde,
-                            const complex_functionT& expV_1,
-                            const complex_operatorT* G,
-                            const complex_functionT& psi0) {
+// Number of coefficients in all states
+std::size_t total_size(const std::vector<complex_functionT>& psi) {
+    std::size_t size = 0;
+    for (unsigned int s=0; s<psi.size(); s++) size += psi[s].size();
+    return size;
+}
+
+// Multiplies each state by its own exponential of the potential with a single fence
+std::vector<complex_functionT> apply_expV(World& world,
+                                          const std::vector<complex_functionT>& expV,
+                                          const std::vector<complex_functionT>& psi) {
+    return mul(world, expV, psi);
+}
+
+std::vector<complex_functionT> chin_chen(World& world,
+                                         const std::vector<complex_functionT>& expV_0,
+                                         const std::vector<complex_functionT>& expV_tilde,
+                                         const std::vector<complex_functionT>& expV_1,
+                                         const complex_operatorT* G,
+                                         const std::vector<complex_functionT>& psi0) {
     // psi(t) = exp(-i*V(t)*t/6) exp(-i*T*t/2) exp(-i*2*Vtilde(t/2)*t/3) exp(-i*T*t/2) exp(-i*V(0)*t/6)
     // .             expV_1            G               expV_tilde             G             expV_0
 
-    complex_functionT psi1;
+    std::vector<complex_functionT> psi1;
 
     double t0 = wall_time();
-    psi1 = expV_0*psi0;     psi1.truncate();
+    psi1 = apply_expV(world, expV_0, psi0);     truncate(world, psi1);
     double t1 = wall_time();
-    psi1 = APPLY(G,psi1);   psi1.truncate();
+    psi1 = APPLY(world, G, psi1);               truncate(world, psi1);
 
     double t2 = wall_time();
-    psi1 = expV_tilde*psi1; psi1.truncate();
+    psi1 = apply_expV(world, expV_tilde, psi1); truncate(world, psi1);
     double t3 = wall_time();
 
-    psi1 = APPLY(G,psi1);   psi1.truncate();
+    psi1 = APPLY(world, G, psi1);               truncate(world, psi1);
     double t4 = wall_time();
-    psi1 = expV_1*psi1;     psi1.truncate(param.thresh);
+    psi1 = apply_expV(world, expV_1, psi1);     truncate(world, psi1, param.thresh);
     double t5 = wall_time();
 
-    if (psi1.world().rank() == 0) {
+    if (world.rank() == 0) {
         printf("chin-chen: %.2f %.2f %.2f %.2f %.2f\n", t1-t0, t2-t1, t3-t2, t4-t3, t5-t4);
     }
 
     return psi1;
 }
 
-complex_functionT trotter(World& world,
-                          const complex_functionT& expV,
-                          const complex_operatorT* G,
-                          const complex_functionT& psi0) {
+std::vector<complex_functionT> trotter(World& world,
+                                       const std::vector<complex_functionT>& expV,
+                                       const complex_operatorT* G,
+                                       const std::vector<complex_functionT>& psi0) {
     //    psi(t) = exp(-i*T*t/2) exp(-i*V(t/2)*t) exp(-i*T*t/2) psi(0)
 
-    complex_functionT psi1;
+    std::vector<complex_functionT> psi1;
 
-    unsigned long size = psi0.size();
+    std::size_t size = total_size(psi0);
     if (world.rank() == 0) print("APPLYING G", size);
-    psi1 = APPLY(G,psi0);  psi1.truncate();  size = psi1.size();
+    psi1 = APPLY(world, G, psi0);            truncate(world, psi1);  size = total_size(psi1);
     if (world.rank() == 0) print("APPLYING expV", size);
-    psi1 = expV*psi1;      psi1.truncate();  size = psi1.size();
+    psi1 = apply_expV(world, expV, psi1);    truncate(world, psi1);  size = total_size(psi1);
     if (world.rank() == 0) print("APPLYING G again", size);
-    psi1 = APPLY(G,psi1);  psi1.truncate(param.thresh);  size = psi1.size();
+    psi1 = APPLY(world, G, psi1);            truncate(world, psi1, param.thresh);  size = total_size(psi1);
     if (world.rank() == 0) print("DONE", size);
 
     return psi1;
@@ -578,7 +619,7 @@ void print_stats_header(World& world) {
 void print_stats(World& world, int step, double t, const functionT& v,
                  const functionT& x, const functionT& y, const functionT& z,
                  const functionT& dV_dz,
-                 const complex_functionT& psi0, const complex_functionT& psi) {
+                 const complex_functionT& psi0, const complex_functionT& psi, int state=0) {
     double norm = psi.norm2();
     double current_energy = energy(world, psi, v);
     double xdip = real(inner(psi, x*psi))/(norm*norm);
@@ -587,42 +628,44 @@ void print_stats(World& world, int step, double t, const functionT& v,
     double overlap0 = std::abs(psi.inner(psi0))/norm;
     double accel = real(psi.inner(psi*dV_dz))/(norm*norm);
     if (world.rank() == 0) {
-        printf("%7d %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %9.1f\n", step, t, laser(t), current_energy, norm, overlap0, xdip, ydip, zdip, accel, wall_time());
+        printf("%7d %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %16.8e %9.1f\n", step, t, laser(t,state), current_energy, norm, overlap0, xdip, ydip, zdip, accel, wall_time());
     }
 }
 
-const char* wave_function_filename(int step) {
+// Files of state 0 keep the single-state names so that old restarts still work
+const char* wave_function_filename(int step, int state=0) {
     static char fname[256];
-    sprintf(fname, "%s-%5.5d", param.prefix.c_str(), step);
+    if (state) sprintf(fname, "%s%d-%5.5d", param.prefix.c_str(), state, step);
+    else sprintf(fname, "%s-%5.5d", param.prefix.c_str(), step);
     return fname;
 }
 
-const char* wave_function_small_plot_filename(int step) {
+const char* wave_function_small_plot_filename(int step, int state=0) {
     static char fname[256];
-    sprintf(fname, "%s-%5.5dS.dx", param.prefix.c_str(), step);
+    sprintf(fname, "%sS.dx", wave_function_filename(step, state));
     return fname;
 }
 
-const char* wave_function_large_plot_filename(int step) {
+const char* wave_function_large_plot_filename(int step, int state=0) {
     static char fname[256];
-    sprintf(fname, "%s-%5.5dL.dx", param.prefix.c_str(), step);
+    sprintf(fname, "%sL.dx", wave_function_filename(step, state));
     return fname;
 }
 
-complex_functionT wave_function_load(World& world, int step) {
+complex_functionT wave_function_load(World& world, int step, int state=0) {
     complex_functionT psi;
-    archive::ParallelInputArchive ar(world, wave_function_filename(step));
+    archive::ParallelInputArchive ar(world, wave_function_filename(step, state));
     ar & psi;
     return psi;
 }
 
-void wave_function_store(World& world, int step, const complex_functionT& psi) {
-    archive::ParallelOutputArchive ar(world, wave_function_filename(step), param.nio);
+void wave_function_store(World& world, int step, const complex_functionT& psi, int state=0) {
+    archive::ParallelOutputArchive ar(world, wave_function_filename(step, state), param.nio);
     ar & psi;
 }
 
-bool wave_function_exists(World& world, int step) {
-    return archive::ParallelInputArchive<madness::archive::BinaryFstreamInputArchive>::exists(world, wave_function_filename(step));
+bool wave_function_exists(World& world, int step, int state=0) {
+    return archive::ParallelInputArchive<madness::archive::BinaryFstreamInputArchive>::exists(world, wave_function_filename(step, state));
 }
 
 void doplot(World& world, int step, const complex_functionT& psi, double Lplot, long numpt, const char* fname) {
@@ -636,7 +679,7 @@ void doplot(World& world, int step, const complex_functionT& psi, double Lplot,
 }
 
 
-void line_plot(World& world, int step, complex_functionT& psi) {
+void line_plot(World& world, int step, complex_functionT& psi, int state=0) {
     static const int npt = 10001;
     double_complex v[10001];
     psi.reconstruct();
@@ -652,7 +695,7 @@ void line_plot(World& world, int step, complex_functionT& psi) {
     world.gop.sum(v, npt);
     if (world.rank() == 0) {
         char buf[256];
-        sprintf(buf, "%s.lineplot", wave_function_filename(step));
+        sprintf(buf, "%s.lineplot", wave_function_filename(step, state));
         std::ofstream f(buf);
         f.precision(10);
         for (int i=0; i<npt; i++) {
@@ -686,12 +729,12 @@ struct lbcost {
 
 void preloadbal(World& world,
                 functionT& potn,
-                complex_functionT& psi) {
+                std::vector<complex_functionT>& psi) {
     if (world.size() < 2) return;
     if (world.rank() == 0) print("starting preLB");
     LoadBalanceDeux<3> lb(world);
     lb.add_tree(potn, lbcost<double,3>(1.0,1.0));
-    lb.add_tree(psi, lbcost<double_complex,3>(1.0,1.0));
+    for (unsigned int s=0; s<psi.size(); s++) lb.add_tree(psi[s], lbcost<double_complex,3>(1.0,1.0));
     FunctionDefaults<3>::redistribute(world,lb.load_balance(2.0, false));
     world.gop.fence();
     //if (world.rank() == 0) print("Verifying psi");
@@ -700,16 +743,18 @@ void preloadbal(World& world,
 
 void loadbal(World& world,
              functionT& potn,
-             complex_functionT& psi) {
+             std::vector<complex_functionT>& psi) {
     if (world.size() < 2) return;
     if (world.rank() == 0) print("starting LB");
     LoadBalanceDeux<3> lb(world);
     lb.add_tree(potn, lbcost<double,3>(1.0,1.0));
 
-    psi.reconstruct();
-    psi.broaden();
-    psi.broaden();
-    lb.add_tree(psi, lbcost<double_complex,3>(1.0,1.0));
+    reconstruct(world, psi);
+    for (unsigned int s=0; s<psi.size(); s++) {
+        psi[s].broaden();
+        psi[s].broaden();
+        lb.add_tree(psi[s], lbcost<double_complex,3>(1.0,1.0));
+    }
     FunctionDefaults<3>::redistribute(world,lb.load_balance(2.0, false));
     world.gop.fence();
     //if (world.rank() == 0) print("Verifying potn");
@@ -717,7 +762,7 @@ void loadbal(World& world,
     //if (world.rank() == 0) print("Verifying psi");
     //psi.verify_tree();
     world.gop.fence();
-    psi.truncate();
+    truncate(world, psi);
     world.gop.fence();
     //if (world.rank() == 0) print("Verifying psi (compressed and truncated)");
     //psi.verify_tree();
@@ -750,7 +795,9 @@ void propagate(World& world, int step0) {
 
     int step = step0;  // The current step
     double t = step0 * time_step - zero_field_time;        // The current time
-    complex_functionT psi = wave_function_load(world, step); // The wave function at time t
+    const int ns = nstate();
+    std::vector<complex_functionT> psi(ns); // The wave functions at time t ... all states start from state 0 at step 0
+    for (int s=0; s<ns; s++) psi[s] = wave_function_load(world, step, step ? s : 0);
     //    if (world.rank() == 0) print("verifying psi after load");
     //world.gop.fence();
     //psi.verify_tree();
@@ -780,7 +827,8 @@ void propagate(World& world, int step0) {
     // Wave function at time t=0 for printing statistics
     complex_functionT psi0 = wave_function_load(world, 0);
 
-    functionT vt = potn+laser(t)*z; // The total potential at time t
+    std::vector<functionT> vt(ns); // The total potentials at time t
+    for (int s=0; s<ns; s++) vt[s] = potn+laser(t,s)*z;
 
     loadbal(world, potn, psi);
 
@@ -795,6 +843,7 @@ void propagate(World& world, int step0) {
         printf(" no field time = %.6f\n", zero_field_time);
         printf("   target time = %.2f\n", param.target_time);
         printf("         nstep = %d\n", nstep);
+        printf("        nstate = %d\n", ns);
         printf("\n");
         printf("  restart step = %d\n", step0);
         printf("  restart time = %.6f\n", t);
@@ -802,17 +851,17 @@ void propagate(World& world, int step0) {
     }
 
     print_stats_header(world);
-    {
+    for (int s=0; s<ns; s++) {
         // Make gradient of potential at time t in z direction to compute HHG
         functionT dV_dz = copy(dpotn_dz);
-        dV_dz.add_scalar(laser(t));
+        dV_dz.add_scalar(laser(t,s));
 
-        print_stats(world, step, t, vt, x, y, z, dV_dz, psi0, psi);
-        line_plot(world, step, psi);
+        print_stats(world, step, t, vt[s], x, y, z, dV_dz, psi0, psi[s], s);
+        line_plot(world, step, psi[s], s);
     }
     world.gop.fence();
 
-    psi.truncate();
+    truncate(world, psi);
 
     bool use_trotter = false;
     while (step < nstep) {
@@ -822,76 +871,85 @@ void propagate(World& world, int step0) {
             loadbal(world, potn, psi);
         t1 = wall_time();
 
-        long depth = psi.max_depth(); long size=psi.size();
+        long depth = 0; long size = total_size(psi);
+        for (int s=0; s<ns; s++) depth = std::max(depth, long(psi[s].max_depth()));
+        t2 = t3 = t4 = t5 = t6 = t7 = t8 = t9 = t10 = t1;
         if (use_trotter) {
-            // Make the potential at time t + step/2
-            functionT vhalf = potn + laser(t+0.5*time_step)*z;
-
-            // Apply Trotter to advance from time t to time t+step
-            complex_functionT expV = make_exp(time_step, vhalf);
+            // Apply Trotter to advance all states from time t to time t+step
+            std::vector<complex_functionT> expV(ns);
+            for (int s=0; s<ns; s++) {
+                // Make the potential at time t + step/2
+                functionT vhalf = potn + laser(t+0.5*time_step,s)*z;
+                expV[s] = make_exp(time_step, vhalf);
+            }
             psi = trotter(world, expV, G, psi);
         }
         else { // Chin-Chen
-            // Make z-component of del V at time tstep/2
-
-            functionT dV_dz = copy(dpotn_dz);
-            t2 = wall_time();
-            dV_dz.add_scalar(laser(t+0.5*time_step));
-
-            // Make Vtilde at time tstep/2
-            functionT Vtilde = potn + laser(t+0.5*time_step)*z;
-            t3 = wall_time();
-
-            //functionT dvsq = dpotn_dx_sq + dpotn_dy_sq + dV_dz*dV_dz;
-            world.gop.fence();
-            functionT dV_dz_sq = dV_dz*dV_dz;
-            world.gop.fence();
-            dV_dz_sq.compress();
-            world.gop.fence();
-            functionT dvsq = dpotn_dx_sq + dpotn_dy_sq + dV_dz_sq;
-            world.gop.fence();
-            dV_dz_sq.clear();
-
-            t4 = wall_time();
-            Vtilde.gaxpy(1.0, dvsq, -time_step*time_step/48.0);
-            t5 = wall_time();
-
-            // Exponentiate potentials
-            complex_functionT expv_0     = make_exp(time_step/6.0, vt);
-            t6 = wall_time();
-            complex_functionT expv_tilde = make_exp(2.0*time_step/3.0, Vtilde);
-            t7 = wall_time();
-            complex_functionT expv_1     = make_exp(time_step/6.0, potn + laser(t+time_step)*z);
-            t8 = wall_time();
-
-            // Free up some memory
-            dV_dz.clear();
-            Vtilde.clear();
-            dvsq.clear();
-            world.gop.fence();
-            t9 = wall_time();
+            std::vector<complex_functionT> expv_0(ns), expv_tilde(ns), expv_1(ns);
+            for (int s=0; s<ns; s++) {
+                // Make z-component of del V at time tstep/2
+
+                functionT dV_dz = copy(dpotn_dz);
+                t2 = wall_time();
+                dV_dz.add_scalar(laser(t+0.5*time_step,s));
+
+                // Make Vtilde at time tstep/2
+                functionT Vtilde = potn + laser(t+0.5*time_step,s)*z;
+                t3 = wall_time();
+
+                //functionT dvsq = dpotn_dx_sq + dpotn_dy_sq + dV_dz*dV_dz;
+                world.gop.fence();
+                functionT dV_dz_sq = dV_dz*dV_dz;
+                world.gop.fence();
+                dV_dz_sq.compress();
+                world.gop.fence();
+                functionT dvsq = dpotn_dx_sq + dpotn_dy_sq + dV_dz_sq;
+                world.gop.fence();
+                dV_dz_sq.clear();
+
+                t4 = wall_time();
+                Vtilde.gaxpy(1.0, dvsq, -time_step*time_step/48.0);
+                t5 = wall_time();
+
+                // Exponentiate potentials
+                expv_0[s]     = make_exp(time_step/6.0, vt[s]);
+                t6 = wall_time();
+                expv_tilde[s] = make_exp(2.0*time_step/3.0, Vtilde);
+                t7 = wall_time();
+                expv_1[s]     = make_exp(time_step/6.0, potn + laser(t+time_step,s)*z);
+                t8 = wall_time();
+
+                // Free up some memory
+                dV_dz.clear();
+                Vtilde.clear();
+                dvsq.clear();
+                world.gop.fence();
+                t9 = wall_time();
+            }
 
-            // Apply Chin-Chen
-            psi = chin_chen(expv_0, expv_tilde, expv_1, G, psi);
+            // Apply Chin-Chen to all states together
+            psi = chin_chen(world, expv_0, expv_tilde, expv_1, G, psi);
             t10 = wall_time();
         }
 
         // Update counters, print info, dump/plot as necessary
         step++;
         t += time_step;
-        vt = potn+laser(t)*z;
+        for (int s=0; s<ns; s++) vt[s] = potn+laser(t,s)*z;
 
 
         {
-            // Make gradient of potential at time t in z direction to compute HHG
-            functionT dV_dz = copy(dpotn_dz);
-            t11 = wall_time();
-            dV_dz.add_scalar(laser(t));
-            t12 = wall_time();
-
+            t11 = t12 = wall_time();
             if ((step%param.nprint) == 0 || step==nstep) {
-                print_stats(world, step, t, vt, x, y, z, dV_dz, psi0, psi);
-                line_plot(world, step, psi);
+                for (int s=0; s<ns; s++) {
+                    // Make gradient of potential at time t in z direction to compute HHG
+                    functionT dV_dz = copy(dpotn_dz);
+                    dV_dz.add_scalar(laser(t,s));
+                    t12 = wall_time();
+
+                    print_stats(world, step, t, vt[s], x, y, z, dV_dz, psi0, psi[s], s);
+                    line_plot(world, step, psi[s], s);
+                }
                 if (world.rank() == 0) print(step, "depth", depth, "size", size);
             }
 
@@ -903,7 +961,7 @@ void propagate(World& world, int step0) {
 
         if ((step%param.ndump) == 0 || step==nstep) {
             double start = wall_time();
-            wave_function_store(world, step, psi);
+            for (int s=0; s<ns; s++) wave_function_store(world, step, psi[s], s);
             // Update the restart file for automatic restarting
             if (world.rank() == 0) {
                 std::ofstream("restart") << step << std::endl;
@@ -913,8 +971,10 @@ void propagate(World& world, int step0) {
         }
 
         if ((step%param.nplot) == 0 || step==nstep) {
-            doplot(world, step, psi, param.Lsmall, 201, wave_function_small_plot_filename(step));
-            doplot(world, step, psi, param.Llarge, 201, wave_function_large_plot_filename(step));
+            for (int s=0; s<ns; s++) {
+                doplot(world, step, psi[s], param.Lsmall, 201, wave_function_small_plot_filename(step, s));
+                doplot(world, step, psi[s], param.Llarge, 201, wave_function_large_plot_filename(step, s));
+            }
         }
     }
 }
@@ -76,6 +76,20 @@ class RealVecLinearOp : public Operator<Vector<double, 3> > {
 		}
 };
 
+/// the arbitrary real vector operator applied to a block of vectors
+class RealVecBlockLinearOp : public BlockOperator<Vector<double, 3> > {
+	protected:
+		void action(const std::vector<Vector<double, 3> > &invec,
+			std::vector<Vector<double, 3> > &outvec) const {
+
+			outvec.resize(invec.size());
+			for(std::size_t i = 0; i < invec.size(); ++i)
+				op.applyOp(invec[i], outvec[i]);
+		}
+
+		RealVecLinearOp op;
+};
+
 /// the identity operator for complex vectors
 class ComplexVecIdentOp : public Operator<Vector<std::complex<double>, 3> > {
 	protected:
@@ -162,7 +176,7 @@ class ComplexFuncLinearOp : public Operator<Function<std::complex<double>, 3> >
 
 
 /// test functions: true for success, false for failure
-const int NTESTS = 12;
+const int NTESTS = 13;
 bool realvec0();
 bool realvec1();
 bool realvec2();
@@ -175,6 +189,7 @@ bool realfunc2();
 bool cplxfunc0();
 bool cplxfunc1();
 bool cplxfunc2();
+bool realvecblock();
 
 /// pointer to the world
 World *worldptr;
@@ -212,6 +227,8 @@ int main(int argc, char **argv) {
 	sprintf(names[10], "Testing complex functions, 1-step convergence");
 	tests[11] = cplxfunc2;
 	sprintf(names[11], "Testing complex functions, >1-step convergence");
+	tests[12] = realvecblock;
+	sprintf(names[12], "Testing block of real vectors, mixed convergence");
 
    initialize(argc, argv);
 	World world(SafeMPI::COMM_WORLD);
@@ -499,3 +516,27 @@ bool cplxfunc2() {
 	b.truncate();
 	return space.norm(x-b) < 2.0e-3;
 }
+
+/// test a block of real vectors, one of which converges on the zeroth step
+bool realvecblock() {
+	RealVecBlockLinearOp lo;
+	VectorSpace<double, 3> space(*worldptr);
+	std::vector<Vector<double, 3> > x(3), b(3), sol(3);
+	double resid_thresh = 5.0e-4;
+	double update_thresh = 1.0e-10;
+	int maxiters = 10;
+
+	sol[0][0] = 0.0; sol[0][1] = 2.0; sol[0][2] = 1.0;
+	sol[1][0] = 1.0; sol[1][1] = 0.0; sol[1][2] = 0.0;
+	sol[2] = sol[0];
+	lo.applyOp(sol, b);
+	x[0] = 0.0;
+	x[1] = 0.0;
+	x[2] = sol[2];
+
+	BlockGMRES(space, lo, b, x, maxiters, resid_thresh, update_thresh, true);
+	bool success = true;
+	for(int i = 0; i < 3; ++i)
+		success = success && space.norm(x[i]-sol[i]) < 5.0e-4;
+	return success;
+}
@@ -517,6 +517,9 @@ double CC2::solve_mp2_coupled(Pairs<CCPair>& doubles) {
    const int nocc=CCOPS.mo_ket().size();
    auto triangular_map=PairVectorMap::triangular_map(nfreeze,nocc);
 
+   // all taskqs below share the same subworlds
+   auto subworld_pool=SubworldPool::create(world, world.size());
+
    // make vector holding CCPairs for partitioner of MacroTask
    std::vector<CCPair> pair_vec=Pairs<CCPair>::pairs2vector(doubles,triangular_map);
 
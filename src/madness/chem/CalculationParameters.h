@@ -87,7 +87,9 @@ struct CalculationParameters : public QCCalculationParametersBase {
 		initialize<bool>  ("restartao",false,"if true restart from orbitals projected into AO basis (STO3G) on disk");
 		initialize<bool>  ("no_compute",false,"if true use orbitals on disk, set value to computed");
 		initialize<bool>  ("save",true,"if true save orbitals to disk");
+		initialize<bool>  ("save_parallel",false,"if true every process writes its part of the orbitals to its own file; not readable by the response codes");
 		initialize<int>   ("maxsub",10,"size of iterative subspace ... set to 0 or 1 to disable");
+		initialize<double> ("subspace_thresh",0.0,"truncation threshold of the stored KAIN subspace history ... set to 0 to store at full precision");
 		initialize<double> ("orbitalshift",0.0,"scf orbital shift: shift the occ orbitals to lower energies");
 		initialize<int>    ("npt_plot",101,"no. of points to use in each dim for plots");
 //		initialize<Tensor<double> > ("plot_cell",Tensor<double>(),"lo hi in each dimension for plotting (default is all space)");
@@ -196,11 +198,13 @@ struct CalculationParameters : public QCCalculationParametersBase {
 
 	std::vector<double> protocol() const {return get<std::vector<double> >("protocol");}
 	bool save() const {return get<bool>("save");}
+	bool save_parallel() const {return get<bool>("save_parallel");}
 	bool restart() const {return get<bool>("restart");}
 	bool restartao() const {return get<bool>("restartao");}
 	bool restart_cphf() const {return get<bool>("restart_cphf");}
 
 	int maxsub() const {return get<int>("maxsub");}
+	double subspace_thresh() const {return get<double>("subspace_thresh");}
 	double maxrotn() const {return get<double>("maxrotn");}
 
 	int vnucextra() const {return get<int>("vnucextra");}
@@ -230,7 +230,7 @@ void SCF::copy_data(World& world, const SCF& other) {
 void SCF::save_mos(World& world) {
     PROFILE_MEMBER_FUNC(SCF);
     auto archivename=param.prefix()+".restartdata";
-    archive::ParallelOutputArchive<archive::BinaryFstreamOutputArchive> ar(world, archivename.c_str(), param.get<int>("nio"));
+    archive::ParallelOutputArchive<archive::BinaryPosixOutputArchive> ar(world, archivename.c_str(), param.get<int>("nio"));
     // IF YOU CHANGE ANYTHING HERE MAKE SURE TO UPDATE THIS VERSION NUMBER
     /*
      * After spin restricted
@@ -239,7 +239,8 @@ void SCF::save_mos(World& world) {
       Molecule molecule;
       std::string xc;
       */
-    unsigned int version = 2;
+    // version 3 is version 2 with the orbitals in separate files, cf save_function_parallel
+    unsigned int version = param.save_parallel() ? 3 : 2;
     ar & version;
     ar & current_energy & param.spin_restricted();
     ar & param.L() & FunctionDefaults<3>::get_k() & molecule & param.xc();
@@ -247,11 +248,13 @@ void SCF::save_mos(World& world) {
 
     ar & (unsigned int) (amo.size());
     ar & aeps & aocc & aset;
-    for (unsigned int i = 0; i < amo.size(); ++i) ar & amo[i];
+    if (version == 3) save_function_parallel(world, amo, archivename + "_amo");
+    else for (unsigned int i = 0; i < amo.size(); ++i) ar & amo[i];
     if (!param.spin_restricted()) {
         ar & (unsigned int) (bmo.size());
         ar & beps & bocc & bset;
-        for (unsigned int i = 0; i < bmo.size(); ++i) ar & bmo[i];
+        if (version == 3) save_function_parallel(world, bmo, archivename + "_bmo");
+        else for (unsigned int i = 0; i < bmo.size(); ++i) ar & bmo[i];
     }
 
     // Do not make a restartaodata file if nwchem orbitals used,
@@ -278,7 +281,7 @@ void SCF::load_mos(World& world) {
     amo.clear();
     bmo.clear();
 
-    archive::ParallelInputArchive<archive::BinaryFstreamInputArchive> ar(world, param.prefix()+".restartdata");
+    archive::ParallelInputArchive<archive::BinaryPosixInputArchive> ar(world, param.prefix()+".restartdata");
 
     /*
       File format:
@@ -296,6 +299,9 @@ void SCF::load_mos(World& world) {
       for i from 0 to nalpha-1:
       .   Function<double,3> amo[i]
       repeat for beta if !spinrestricted
+
+      version 3 stores the orbitals with save_function_parallel in
+      restartdata_amo and restartdata_bmo instead
      */
     // Local copies for a basic check
     double L;
@@ -305,7 +311,7 @@ void SCF::load_mos(World& world) {
 
     ar & archive_version;
 
-    if (archive_version != version) {
+    if (archive_version != version and archive_version != 3) {
         if (world.rank() == 0)
             print(
                     "Loading from a different version of archive. Archive version", archive_version, "MADNESS version",
@@ -337,8 +343,13 @@ void SCF::load_mos(World& world) {
         print("Restarting from this molecular geometry");
         molecule.print();
     }
-    amo.resize(nmo);
-    for (unsigned int i = 0; i < amo.size(); ++i) ar & amo[i];
+    if (archive_version == 3) {
+        load_function_parallel(world, amo, param.prefix() + ".restartdata_amo");
+        MADNESS_CHECK(amo.size() == nmo);
+    } else {
+        amo.resize(nmo);
+        for (unsigned int i = 0; i < amo.size(); ++i) ar & amo[i];
+    }
     unsigned int n_core = molecule.n_core_orb_all();
     if (nmo > unsigned(param.nmo_alpha())) {
         aset = vector<int>(aset.begin() + n_core, aset.begin() + n_core + param.nmo_alpha());
@@ -370,8 +381,13 @@ void SCF::load_mos(World& world) {
             ar & nmo;
             ar & beps & bocc & bset;
 
-            bmo.resize(nmo);
-            for (unsigned int i = 0; i < bmo.size(); ++i) ar & bmo[i];
+            if (archive_version == 3) {
+                load_function_parallel(world, bmo, param.prefix() + ".restartdata_bmo");
+                MADNESS_CHECK(bmo.size() == nmo);
+            } else {
+                bmo.resize(nmo);
+                for (unsigned int i = 0; i < bmo.size(); ++i) ar & bmo[i];
+            }
 
             if (nmo > unsigned(param.nmo_beta())) {
                 bset = vector<int>(bset.begin() + n_core, bset.begin() + n_core + param.nmo_beta());
@@ -443,24 +459,48 @@ void SCF::do_plots(World& world) {
 
 void SCF::project(World& world) {
     PROFILE_MEMBER_FUNC(SCF);
-    reconstruct(world, amo);
-    for (unsigned int i = 0; i < amo.size(); ++i) {
-        amo[i] = madness::project(amo[i], FunctionDefaults<3>::get_k(),
-                                  FunctionDefaults<3>::get_thresh(), false);
-    }
-    world.gop.fence();
+    project_to_protocol(world, amo);
     truncate(world, amo);
     normalize(world, amo);
-    if (param.nbeta() && !param.spin_restricted()) {
-        reconstruct(world, bmo);
-        for (unsigned int i = 0; i < bmo.size(); ++i) {
-            bmo[i] = madness::project(bmo[i], FunctionDefaults<3>::get_k(),
-                                      FunctionDefaults<3>::get_thresh(), false);
-        }
-        world.gop.fence();
+    const bool do_beta = param.nbeta() && !param.spin_restricted();
+    if (do_beta) {
+        project_to_protocol(world, bmo);
         truncate(world, bmo);
         normalize(world, bmo);
     }
+
+    // carry the KAIN subspace over to the next solve, if it matches the orbitals
+    const std::size_t nmo = amo.size() + (do_beta ? bmo.size() : 0);
+    kain_carry = (kain_subspace.size() > 0) and (kain_subspace[0].first.size() == nmo);
+    if (kain_carry) {
+        for (pairvecfuncT& vr : kain_subspace) {
+            project_to_protocol(world, vr.first);
+            project_to_protocol(world, vr.second);
+            compress(world, vr.first, false);
+            compress(world, vr.second, false);
+        }
+        world.gop.fence();
+    } else {
+        kain_subspace.clear();
+        kain_Q = tensorT();
+    }
+}
+
+void SCF::project_to_protocol(World& world, vecfuncT& v) const {
+    PROFILE_MEMBER_FUNC(SCF);
+    if (v.empty()) return;
+    const int k = FunctionDefaults<3>::get_k();
+    const double thresh = FunctionDefaults<3>::get_thresh();
+    reconstruct(world, v);
+    bool same_k = true;
+    for (const functionT& f : v) if (f.is_initialized() and f.k() != k) same_k = false;
+    if (same_k) {
+        set_thresh(world, v, thresh, false);
+        refine(world, v);
+    } else {
+        for (functionT& f : v) f = madness::project(f, k, thresh, false);
+        world.gop.fence();
+    }
 }
 
 void SCF::make_nuclear_potential(World& world) {
@@ -1243,11 +1283,20 @@ vecfuncT SCF::apply_potential(World& world, const tensorT& occ,
 
     END_TIMER(world, "V*psi");
     print_meminfo(world.rank(), "V*psi");
-    if (xc.hf_exchange_coefficient()) {
+    if (xc.has_hf_exchange()) {
         START_TIMER(world);
         //            vecfuncT Kamo = apply_hf_exchange(world, occ, amo, amo);
-        Exchange<double, 3> K = Exchange<double, 3>(world, this, ispin).set_symmetric(true);
-        vecfuncT Kamo = K(amo);
+        // exact exchange, possibly range-separated: alpha K + beta K_sr
+        vecfuncT Kamo = zero_functions_compressed<double, 3>(world, amo.size());
+        if (xc.hf_exchange_coefficient()) {
+            Exchange<double, 3> K = Exchange<double, 3>(world, this, ispin).set_symmetric(true);
+            gaxpy(world, 1.0, Kamo, xc.hf_exchange_coefficient(), K(amo));
+        }
+        if (xc.hf_exchange_sr_coefficient()) {
+            Exchange<double, 3> Ksr = Exchange<double, 3>(world, this, ispin).set_symmetric(true)
+                    .set_attenuation(Exchange<double, 3>::short_range, xc.hf_exchange_omega());
+            gaxpy(world, 1.0, Kamo, xc.hf_exchange_sr_coefficient(), Ksr(amo));
+        }
         tensorT excv = inner(world, Kamo, amo);
         double exchf = 0.0;
         for (unsigned long i = 0; i < amo.size(); ++i) {
@@ -1255,10 +1304,10 @@ vecfuncT SCF::apply_potential(World& world, const tensorT& occ,
         }
         if (!xc.is_spin_polarized())
             exchf *= 2.0;
-        gaxpy(world, 1.0, Vpsi, -xc.hf_exchange_coefficient(), Kamo);
+        gaxpy(world, 1.0, Vpsi, -1.0, Kamo);
         Kamo.clear();
         END_TIMER(world, "HF exchange");
-        exc = exchf * xc.hf_exchange_coefficient() + exc;
+        exc = exchf + exc;
     }
     // need to come back to this for psp - when is this used?
     if (molecule.parameters.pure_ae()) {
@@ -1774,6 +1823,14 @@ void SCF::update_subspace(World& world, vecfuncT& Vpsia, vecfuncT& Vpsib,
     }
     world.gop.fence();
     END_TIMER(world, "Subspace transform");
+
+    // the new orbitals used the full-precision iterate, keep only a truncated copy in the history
+    if (param.subspace_thresh() > 0.0 and param.maxsub() > 1) {
+        vecfuncT& vs = subspace.back().first;
+        vs = copy(world, vs);
+        truncate(world, vs, param.subspace_thresh(), false);
+        truncate(world, subspace.back().second, param.subspace_thresh());
+    }
     if (param.maxsub() <= 1) {
         subspace.clear();
     } else if (subspace.size() == size_t(param.maxsub())) {
@@ -1934,6 +1991,13 @@ void SCF::solve(World& world) {
     double update_residual = 0.0, bsh_residual = 0.0;
     subspaceT subspace;
     tensorT Q;
+    // continue with the subspace of the previous protocol step, cf project()
+    if (kain_carry) {
+        subspace.swap(kain_subspace);
+        Q = kain_Q;
+    }
+    kain_subspace.clear();
+    kain_carry = false;
     bool do_this_iter = true;
     bool converged = false;
 
@@ -2217,6 +2281,10 @@ void SCF::solve(World& world) {
 
     }
 
+    // keep the subspace for the next protocol step
+    kain_subspace.swap(subspace);
+    kain_Q = Q;
+
     // compute the dipole moment
     functionT rho = make_density(world, aocc, amo);
     if (!param.spin_restricted()) {
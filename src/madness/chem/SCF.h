@@ -43,6 +43,8 @@
 //#define WORLD_INSTANTIATE_STATIC_TEMPLATES
 
 #include <memory>
+#include <map>
+#include <tuple>
 
 #include<madness/chem/molecular_functors.h>
 #include <madness/mra/mra.h>
@@ -202,6 +204,15 @@ public:
     poperatorT coulop;
     std::vector<std::shared_ptr<real_derivative_3d> > gradop;
     double vtol;
+
+    /// Coulomb operators of previous protocol steps, keyed by k, lo and thresh
+    std::map<std::tuple<int,double,double>, poperatorT> coulop_cache;
+
+    /// the KAIN subspace of the last call to solve, carried over to the
+    /// next protocol step by project()
+    subspaceT kain_subspace;
+    tensorT kain_Q;
+    bool kain_carry=false;
     double current_energy;
     //double esol;//etot;
     //double vacuo_energy;
@@ -269,10 +280,10 @@ public:
         FunctionDefaults<NDIM>::set_apply_randomize(false);
         FunctionDefaults<NDIM>::set_project_randomize(false);
         FunctionDefaults<NDIM>::set_cubic_cell(-param.L(), param.L());
-        GaussianConvolution1DCache<double>::map.clear();
+        // the 1d convolutions are cached per k and remain valid, don't clear them
         double safety = 0.1;
         vtol = FunctionDefaults<NDIM>::get_thresh() * safety;
-        coulop = poperatorT(CoulombOperatorPtr(world, param.lo(), thresh));
+        coulop = coulomb_operator(world, param.lo(), thresh);
         gradop = gradient_operator<double, 3>(world);
 
         mask = functionT(factoryT(world).f(mask3).initial_level(4).norefine());
@@ -306,6 +317,22 @@ public:
 
     void project(World& world);
 
+    /// bring functions of the previous protocol step to the current k and thresh
+
+    /// if k is unchanged only the boxes failing the refinement test at the
+    /// current threshold are refined, otherwise the functions are projected
+    void project_to_protocol(World& world, vecfuncT& v) const;
+
+    /// the Coulomb operator for the current k, reused if it has been made before
+    poperatorT coulomb_operator(World& world, const double lo, const double thresh) {
+        const auto key=std::make_tuple(FunctionDefaults<3>::get_k(), lo, thresh);
+        auto it=coulop_cache.find(key);
+        if (it!=coulop_cache.end()) return it->second;
+        poperatorT op(CoulombOperatorPtr(world, lo, thresh));
+        coulop_cache[key]=op;
+        return op;
+    }
+
     void make_nuclear_potential(World& world);
 
     vecfuncT project_ao_basis(World& world, const AtomicBasisSet& aobasis);
@@ -710,6 +710,12 @@ Exchange<T,NDIM>& Exchange<T,NDIM>::set_printlevel(const long& level) {
     return *this;
 }
 
+template<typename T, std::size_t NDIM>
+Exchange<T,NDIM>& Exchange<T,NDIM>::set_attenuation(const Attenuation& att, const double omega) {
+    impl->set_attenuation(att,omega);
+    return *this;
+}
+
 template<>
 Fock<double, 3>::Fock(World &world, const Nemo *nemo) : world(world) {
     auto tmp = nemo->make_fock_operator();
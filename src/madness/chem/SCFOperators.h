@@ -114,6 +114,13 @@ public:
         small_memory, large_memory, multiworld_efficient
     };
 
+    /// the interaction kernel of the exchange operator, cf set_attenuation
+    enum Attenuation {
+        full_range,     ///< 1/r, conventional exact exchange
+        short_range,    ///< erfc(omega r)/r, screened exchange, e.g. HSE
+        long_range      ///< erf(omega r)/r, long-range corrected exchange, e.g. CAM-B3LYP
+    };
+
     /// default ctor
     Exchange() = default;
 
@@ -135,6 +142,14 @@ public:
 
     Exchange& set_printlevel(const long& level);
 
+    /// use a range-separated kernel for the exchange operator
+
+    /// the short-range kernel has no diffuse terms and is much cheaper to
+    /// apply than 1/r, cf ErfcCoulombOperator
+    /// @param[in]  att     full_range, short_range or long_range
+    /// @param[in]  omega   the range-separation parameter
+    Exchange& set_attenuation(const Attenuation& att, const double omega=0.0);
+
     Exchange& set_taskq(std::shared_ptr<MacroTaskQ> taskq1) {
         this->taskq=taskq1;
         return *this;
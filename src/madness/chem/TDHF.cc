@@ -98,6 +98,8 @@ void TDHF::prepare_calculation() {
 
     if (not parameters.no_compute()) {
 
+        MADNESS_CHECK_THROW(get_calc()->xc.hf_exchange_sr_coefficient() == 0.0,
+                            "TDHF: range-separated hybrids are not implemented");
         bool need_hf = (get_calc()->xc.hf_exchange_coefficient() != 0.0) and (parameters.do_oep() == false);
         if (need_hf) {
             msg.subsection("Computing Exchange Intermediate");
@@ -100,13 +100,17 @@ public:
 	virtual ~NuclearCorrelationFactor() {};
 
 	/// initialize the regularized potentials U1 and U2
+
+	/// nothing is done if they are present for the current geometry and threshold
 	void initialize(const double vtol1) {
 
 	    // set threshold for projections
 	    vtol=vtol1;
+	    if (U1_function.size()==3 and U_stamp==current_stamp()) return;
 
 		// construct the potential functions
 		// keep tighter threshold for orthogonalization
+		U1_function.clear();
 		for (int axis=0; axis<3; ++axis) {
 			functorT U1f=functorT(new U1_functor(this,axis));
 			U1_function.push_back(real_factory_3d(world).thresh(vtol)
@@ -127,6 +131,7 @@ public:
 		tmp.set_thresh(FunctionDefaults<3>::get_thresh());
 		U2_function+=tmp;
 		U2_function.truncate();
+		U_stamp=current_stamp();
 	}
 
 	virtual corrfactype type() const = 0;
@@ -151,18 +156,12 @@ public:
 
 	/// return the nuclear correlation factor
 	virtual real_function_3d function() const {
-		functorT Rf=functorT(new R_functor(this,1));
-		real_function_3d r=real_factory_3d(world).thresh(vtol)
-				.functor(Rf).truncate_on_project();
-		return r;
+		return cached_function("R",R_functor(this,1));
 	}
 
 	/// return the square of the nuclear correlation factor
 	virtual real_function_3d square() const {
-	    R_functor r(this,2);
-		real_function_3d R2=real_factory_3d(world).thresh(vtol)
-				.functor(r).truncate_on_project();
-		return R2;
+		return cached_function("R2",R_functor(this,2));
 	}
 
     /// return the square of the nuclear correlation factor multiplied with
@@ -170,18 +169,13 @@ public:
 
     /// @return R^2 * \frac{\partial Z_A/r_{1A}}{\partial X_A}
     virtual real_function_3d square_times_V_derivative(const int iatom, const int axis) const {
-        square_times_V_derivative_functor func(this,molecule,iatom,axis);
-        real_function_3d R2=real_factory_3d(world).thresh(vtol)
-                .functor(func).truncate_on_project();
-        return R2;
+        return cached_function("R2dV_"+std::to_string(iatom)+"_"+std::to_string(axis),
+                square_times_V_derivative_functor(this,molecule,iatom,axis));
     }
 
 	/// return the inverse nuclear correlation factor
 	virtual real_function_3d inverse() const {
-	    R_functor r(this,-1);
-		real_function_3d R_inverse=real_factory_3d(world).thresh(vtol)
-				.functor(r).truncate_on_project();
-		return R_inverse;
+		return cached_function("R-1",R_functor(this,-1));
 	}
 
 	/// return the U1 term of the correlation function
@@ -201,6 +195,11 @@ public:
 	/// return the U2 term of the correlation function
 	virtual const real_function_3d U2() const  {return U2_function;}
 
+	/// drop the cached projections of function(), square(), etc
+	void clear_cache() const {
+		cache.clear();
+	}
+
 private:
 
 	/// the world
@@ -221,6 +220,108 @@ private:
 	/// the purely local U2 potential, having absorbed the nuclear pot V_nuc
 	real_function_3d U2_function;
 
+	/// the projected functions returned by function(), square(), etc
+	mutable std::map<std::string,real_function_3d> cache;
+
+	/// geometry, threshold and polynomial order a set of projections is valid for
+	struct ProjectionStamp {
+		Tensor<double> geometry;
+		double vtol=-1.0;
+		int k=-1;
+
+		bool operator==(const ProjectionStamp& other) const {
+			return (vtol==other.vtol) and (k==other.k)
+					and (geometry.size()==other.geometry.size())
+					and (geometry.size()==0 or (geometry-other.geometry).normf()==0.0);
+		}
+	};
+
+	/// the stamp of the cached functions returned by function(), square(), etc
+	mutable ProjectionStamp cache_stamp;
+
+	/// the stamp of U1_function and U2_function, set where they are projected
+	ProjectionStamp U_stamp;
+
+	/// the stamp for the current geometry, threshold and polynomial order
+	ProjectionStamp current_stamp() const {
+		ProjectionStamp stamp;
+		stamp.geometry=copy(molecule.get_all_coords());
+		stamp.vtol=vtol;
+		stamp.k=FunctionDefaults<3>::get_k();
+		return stamp;
+	}
+
+	/// true if the cache is valid for the current geometry and threshold
+
+	/// otherwise the cache is cleared and will be filled for the current ones
+	bool cache_is_current() const {
+		const ProjectionStamp stamp=current_stamp();
+		const bool current=(stamp==cache_stamp);
+		if (not current) {
+			clear_cache();
+			cache_stamp=stamp;
+		}
+		return current;
+	}
+
+	/// return a copy of the function projected from the functor, cached under key
+	template<typename opT>
+	real_function_3d cached_function(const std::string& key, const opT& functor) const {
+		cache_is_current();
+		auto it=cache.find(key);
+		if (it==cache.end()) {
+			real_function_3d f=real_factory_3d(world).thresh(vtol)
+					.functor(functor).truncate_on_project();
+			it=cache.insert(std::make_pair(key,f)).first;
+		}
+		return copy(it->second);
+	}
+
+	/// distance beyond which an atom does not contribute to U1 and U3, and
+	/// contributes only -Z/r to U2, both within tol
+
+	/// @return	the radius, or a negative number if the atom can't be screened
+	double screening_radius(const double Z, const double tol) const {
+		const double rmax=50.0, dr=0.05;
+		double rlast=0.0;
+		for (double r=dr; r<rmax; r+=dr) {
+			if (std::abs(Sr_div_S(r,Z))>tol or std::abs(Spp_div_S(r,Z)+Z/r)>tol) rlast=r;
+		}
+		if (rlast+dr>=rmax) return -1.0;
+		return rlast+dr;
+	}
+
+	/// the screening radii of all atoms for the projection of the U potentials
+	std::vector<double> screening_radii() const {
+		std::vector<double> rscreen(molecule.natom());
+		for (size_t i=0; i<molecule.natom(); ++i) {
+			rscreen[i]=screening_radius(molecule.get_atom(i).q,0.01*vtol);
+		}
+		return rscreen;
+	}
+
+	/// flags the atoms which are closer to the box of the points than their screening radius
+	std::vector<bool> atoms_near_points(const Vector<double*,3>& xvals, const int npts,
+			const std::vector<double>& rscreen) const {
+		coord_3d lo, hi;
+		for (int d=0; d<3; ++d) {
+			lo[d]=*std::min_element(xvals[d],xvals[d]+npts);
+			hi[d]=*std::max_element(xvals[d],xvals[d]+npts);
+		}
+		std::vector<bool> near(molecule.natom(),true);
+		for (size_t i=0; i<molecule.natom(); ++i) {
+			if (rscreen[i]<0.0) continue;
+			const coord_3d center=molecule.get_atom(i).get_coords();
+			double dist2=0.0;
+			for (int d=0; d<3; ++d) {
+				const double dd=std::max(0.0,std::max(lo[d]-center[d],center[d]-hi[d]));
+				dist2+=dd*dd;
+			}
+			near[i]=(dist2<rscreen[i]*rscreen[i]);
+		}
+		return near;
+	}
+
 	/// the correlation factor S wrt a given atom
 
 	/// @param[in]	r	the distance of the req'd coord to the nucleus
@@ -465,10 +566,11 @@ public:
 
 		const NuclearCorrelationFactor* ncf;
 		const int axis;
+		const std::vector<double> rscreen;
 
 	public:
 		U1_functor(const NuclearCorrelationFactor* ncf, const int axis)
-			: ncf(ncf), axis(axis) {}
+			: ncf(ncf), axis(axis), rscreen(ncf->screening_radii()) {}
 
 		double operator()(const coord_3d& xyz) const {
 			double result=0.0;
@@ -482,6 +584,24 @@ public:
 			}
 			return result;
 		}
+
+		bool supports_vectorized() const {return true;}
+
+		/// all points of a box, skipping the atoms far from the box
+		void operator()(const Vector<double*,3>& xvals, double* fvals, int npts) const {
+			const std::vector<bool> near=ncf->atoms_near_points(xvals,npts,rscreen);
+			for (int ipt=0; ipt<npts; ++ipt) {
+				const coord_3d xyz=vec(xvals[0][ipt],xvals[1][ipt],xvals[2][ipt]);
+				double result=0.0;
+				for (size_t i=0; i<ncf->molecule.natom(); ++i) {
+					if (not near[i]) continue;
+					const Atom& atom=ncf->molecule.get_atom(i);
+					const coord_3d vr1A=xyz-atom.get_coords();
+					result-=ncf->Sr_div_S(vr1A.normf(),atom.q)*ncf->smoothed_unitvec(vr1A)[axis];
+				}
+				fvals[ipt]=result;
+			}
+		}
 		std::vector<coord_3d> special_points() const {
 			return ncf->molecule.get_all_coords_vec();
 		}
@@ -567,8 +687,9 @@ public:
 
 	class U2_functor : public FunctionFunctorInterface<double,3> {
 		const NuclearCorrelationFactor* ncf;
+		const std::vector<double> rscreen;
 	public:
-		U2_functor(const NuclearCorrelationFactor* ncf) : ncf(ncf) {}
+		U2_functor(const NuclearCorrelationFactor* ncf) : ncf(ncf), rscreen(ncf->screening_radii()) {}
 		double operator()(const coord_3d& xyz) const {
 			double result=0.0;
 			for (size_t i=0; i<ncf->molecule.natom(); ++i) {
@@ -579,6 +700,23 @@ public:
 			}
 			return result;
 		}
+
+		bool supports_vectorized() const {return true;}
+
+		/// all points of a box, atoms far from the box contribute -Z/r
+		void operator()(const Vector<double*,3>& xvals, double* fvals, int npts) const {
+			const std::vector<bool> near=ncf->atoms_near_points(xvals,npts,rscreen);
+			for (int ipt=0; ipt<npts; ++ipt) {
+				const coord_3d xyz=vec(xvals[0][ipt],xvals[1][ipt],xvals[2][ipt]);
+				double result=0.0;
+				for (size_t i=0; i<ncf->molecule.natom(); ++i) {
+					const Atom& atom=ncf->molecule.get_atom(i);
+					const double r=(xyz-atom.get_coords()).normf();
+					result+= near[i] ? ncf->Spp_div_S(r,atom.q) : -atom.q/r;
+				}
+				fvals[ipt]=result;
+			}
+		}
 		std::vector<coord_3d> special_points() const {
 			return ncf->molecule.get_all_coords_vec();
 		}
@@ -586,8 +724,9 @@ public:
 
 	class U3_functor : public FunctionFunctorInterface<double,3> {
 		const NuclearCorrelationFactor* ncf;
+		const std::vector<double> rscreen;
 	public:
-		U3_functor(const NuclearCorrelationFactor* ncf) : ncf(ncf) {}
+		U3_functor(const NuclearCorrelationFactor* ncf) : ncf(ncf), rscreen(ncf->screening_radii()) {}
 		double operator()(const coord_3d& xyz) const {
 			std::vector<coord_3d> all_terms(ncf->molecule.natom());
 			for (size_t i=0; i<ncf->molecule.natom(); ++i) {
@@ -609,6 +748,29 @@ public:
 
 			return -1.0*result;
 		}
+
+		bool supports_vectorized() const {return true;}
+
+		/// all points of a box, only pairs of atoms near the box contribute
+		void operator()(const Vector<double*,3>& xvals, double* fvals, int npts) const {
+			const std::vector<bool> near=ncf->atoms_near_points(xvals,npts,rscreen);
+			std::vector<size_t> iatoms;
+			for (size_t i=0; i<near.size(); ++i) if (near[i]) iatoms.push_back(i);
+			std::vector<coord_3d> all_terms(iatoms.size());
+			for (int ipt=0; ipt<npts; ++ipt) {
+				const coord_3d xyz=vec(xvals[0][ipt],xvals[1][ipt],xvals[2][ipt]);
+				for (size_t i=0; i<iatoms.size(); ++i) {
+					const Atom& atom=ncf->molecule.get_atom(iatoms[i]);
+					const coord_3d vr1A=xyz-atom.get_coords();
+					all_terms[i]=ncf->Sr_div_S(vr1A.normf(),atom.q)*ncf->smoothed_unitvec(vr1A);
+				}
+				double result=0.0;
+				for (size_t i=0; i<iatoms.size(); ++i) {
+					for (size_t j=0; j<i; ++j) result+=inner(all_terms[i],all_terms[j]);
+				}
+				fvals[ipt]=-1.0*result;
+			}
+		}
 		std::vector<coord_3d> special_points() const {
 			return ncf->molecule.get_all_coords_vec();
 		}
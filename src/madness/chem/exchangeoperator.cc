@@ -92,7 +92,7 @@ Exchange<T, NDIM>::ExchangeImpl::K_macrotask_efficient(const vecfuncT& vf, const
 
     // the result is a vector of functions living in the universe
     const long nresult = vf.size();
-    MacroTaskExchangeSimple xtask(nresult, lo, mul_tol, is_symmetric());
+    MacroTaskExchangeSimple xtask(nresult, lo, mul_tol, is_symmetric(), attenuation, omega_);
     vecfuncT Kf;
 
     // deferred execution if a taskq is provided by the user
@@ -119,7 +119,7 @@ std::vector<Function<T, NDIM> > Exchange<T, NDIM>::ExchangeImpl::K_small_memory(
     const long nocc = mo_ket.size();
     const long nf = vket.size();
     vecfuncT Kf = zero_functions_compressed<T, NDIM>(world, nf);
-    auto poisson = set_poisson(world, lo);
+    auto poisson = set_poisson(world, lo, FunctionDefaults<3>::get_thresh(), attenuation, omega_);
 
     for (int i = 0; i < nocc; ++i) {
         vecfuncT psif = mul_sparse(world, mo_bra[i], vket, mul_tol); /// was vtol
@@ -137,7 +137,7 @@ template<typename T, std::size_t NDIM>
 std::vector<Function<T, NDIM> > Exchange<T, NDIM>::ExchangeImpl::K_large_memory(const vecfuncT& vket,
                                                                   const double mul_tol) const {    // Larger memory algorithm ... use i-j sym if psi==f
 
-    auto poisson = set_poisson(world, lo);
+    auto poisson = set_poisson(world, lo, FunctionDefaults<3>::get_thresh(), attenuation, omega_);
     vecfuncT result = compute_K_tile(world, mo_bra, mo_ket, vket, poisson, is_symmetric(), mul_tol);
     truncate(world, result);
     return result;
@@ -234,7 +234,7 @@ Exchange<T, NDIM>::ExchangeImpl::MacroTaskExchangeSimple::compute_offdiagonal_ba
     mul1_timer += long((cpu1 - cpu0) * 1000l);
 
     cpu0 = cpu_time();
-    auto poisson = set_poisson(subworld, lo);
+    auto poisson = set_poisson(subworld, lo, FunctionDefaults<3>::get_thresh(), attenuation, omega);
     vecfuncT Nij = apply(subworld, *poisson.get(), orbital_product_flat);
     truncate(subworld, Nij);
     cpu1 = cpu_time();
@@ -301,12 +301,4 @@ class Exchange<double_complex, 3>::ExchangeImpl;
 template
 class Exchange<double, 3>::ExchangeImpl;
 
-template<> volatile std::list<detail::PendingMsg> WorldObject<MacroTaskQ>::pending = std::list<detail::PendingMsg>();
-template<> Spinlock WorldObject<MacroTaskQ>::pending_mutex(0);
-
-template<> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<long, std::vector<unsigned char>, madness::Hash<long> > >::pending = std::list<detail::PendingMsg>();
-template<> Spinlock WorldObject<WorldContainerImpl<long, std::vector<unsigned char>, madness::Hash<long> > >::pending_mutex(
-        0);
-
-
 } /* namespace madness */
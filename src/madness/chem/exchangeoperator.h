@@ -47,6 +47,8 @@ public:
     typedef Exchange<T,NDIM>::Algorithm Algorithm;
     Algorithm algorithm_ = multiworld_efficient;
 
+    typedef Exchange<T,NDIM>::Attenuation Attenuation;
+
     /// default ctor
     ExchangeImpl(World& world) : world(world) {}
 
@@ -68,7 +70,12 @@ public:
 
     std::string info() const {return "K";}
 
-    static auto set_poisson(World& world, const double lo, const double econv = FunctionDefaults<3>::get_thresh()) {
+    static auto set_poisson(World& world, const double lo, const double econv = FunctionDefaults<3>::get_thresh(),
+                            const Attenuation attenuation = full_range, const double omega = 0.0) {
+        if (attenuation == short_range)
+            return std::shared_ptr<real_convolution_3d>(ErfcCoulombOperatorPtr(world, omega, lo, econv));
+        if (attenuation == long_range)
+            return std::shared_ptr<real_convolution_3d>(ErfCoulombOperatorPtr(world, omega, lo, econv));
         return std::shared_ptr<real_convolution_3d>(CoulombOperatorPtr(world, lo, econv));
     }
 
@@ -101,6 +108,13 @@ public:
         return *this;
     }
 
+    ExchangeImpl& set_attenuation(const Attenuation& att, const double omega) {
+        MADNESS_CHECK(att == full_range or omega > 0.0);
+        attenuation = att;
+        omega_ = omega;
+        return *this;
+    }
+
 private:
 
     /// exchange using macrotasks, i.e. apply K on a function in individual worlds
@@ -128,6 +142,8 @@ private:
     double lo = 1.e-4;
     long printlevel = 0;
     double mul_tol = 0.0;
+    Attenuation attenuation = full_range;   ///< kernel of the exchange operator
+    double omega_ = 0.0;                    ///< range-separation parameter
 
     class MacroTaskExchangeSimple : public MacroTaskOperationBase {
 
@@ -135,6 +151,8 @@ private:
         double lo = 1.e-4;
         double mul_tol = 1.e-7;
         bool symmetric = false;
+        Attenuation attenuation = full_range;
+        double omega = 0.0;
 
         /// custom partitioning for the exchange operator in exchangeoperator.h
 
@@ -184,8 +202,10 @@ private:
         };
 
     public:
-        MacroTaskExchangeSimple(const long nresult, const double lo, const double mul_tol, const bool symmetric)
-                : nresult(nresult), lo(lo), mul_tol(mul_tol), symmetric(symmetric) {
+        MacroTaskExchangeSimple(const long nresult, const double lo, const double mul_tol, const bool symmetric,
+                                const Attenuation attenuation = full_range, const double omega = 0.0)
+                : nresult(nresult), lo(lo), mul_tol(mul_tol), symmetric(symmetric),
+                  attenuation(attenuation), omega(omega) {
             partitioner.reset(new MacroTaskPartitionerExchange(symmetric));
         }
 
@@ -262,7 +282,8 @@ private:
         ) const {
             double mul_tol = 0.0;
             double symmetric = true;
-            auto poisson = Exchange<double, 3>::ExchangeImpl::set_poisson(subworld, lo);
+            auto poisson = Exchange<T, NDIM>::ExchangeImpl::set_poisson(subworld, lo,
+                    FunctionDefaults<3>::get_thresh(), attenuation, omega);
             return Exchange<T, NDIM>::ExchangeImpl::compute_K_tile(subworld, bra_batch, ket_batch, vf_batch, poisson, symmetric,
                                                      mul_tol);
         }
@@ -280,7 +301,8 @@ private:
                                                     const vecfuncT& vf_batch) const {
             double mul_tol = 0.0;
             double symmetric = false;
-            auto poisson = Exchange<double, 3>::ExchangeImpl::set_poisson(subworld, lo);
+            auto poisson = Exchange<T, NDIM>::ExchangeImpl::set_poisson(subworld, lo,
+                    FunctionDefaults<3>::get_thresh(), attenuation, omega);
             return Exchange<T, NDIM>::ExchangeImpl::compute_K_tile(subworld, bra_batch, ket_batch, vf_batch, poisson, symmetric,
                                                      mul_tol);
         }
@@ -44,5 +44,109 @@ namespace madness {
     const double ProjRLMFunctor::gamma_data[17] = {1.0, 0.0, 1.0/2.0, 0.0, 3.0/4.0, 0.0, 15.0/8.0, 0.0, 105.0/16.0, 0.0, 
         945.0/32.0, 0.0, 10395.0/64.0, 0.0, 135135.0/128.0, 0.0, 2027025.0/256.0};
 
+    ProjRLMSeparatedFunctor::ProjRLMSeparatedFunctor(double alpha, int l, int m, int i,
+            const coord_3d& center, int k)
+        : pointwise(alpha, l, m, i, center), alpha(alpha), center(center), k(k), maxpower(0) {
+
+        // the solid harmonic as (coefficient, powers of x,y,z)
+        const double PI = constants::pi;
+        typedef std::map<std::array<int,3>,double> polyT;
+        polyT poly;
+        if (l == 0) {
+            poly[{0,0,0}] = (1./2.)*std::sqrt(1./PI);
+        } else if (l == 1) {
+            MADNESS_CHECK(m >= 0 && m <= 2);
+            std::array<int,3> p = {0,0,0};
+            p[m] = 1;
+            poly[p] = std::sqrt(3./4./PI);
+        } else if (l == 2) {
+            MADNESS_CHECK(m >= 0 && m <= 4);
+            if (m == 0) {
+                poly[{2,0,0}] = -(1./4.)*std::sqrt(5./PI);
+                poly[{0,2,0}] = -(1./4.)*std::sqrt(5./PI);
+                poly[{0,0,2}] = (1./2.)*std::sqrt(5./PI);
+            }
+            else if (m == 1) poly[{0,1,1}] = (1./2.)*std::sqrt(15./PI);
+            else if (m == 2) poly[{1,0,1}] = (1./2.)*std::sqrt(15./PI);
+            else if (m == 3) poly[{1,1,0}] = (1./2.)*std::sqrt(15./PI);
+            else if (m == 4) {
+                poly[{2,0,0}] = (1./4.)*std::sqrt(15./PI);
+                poly[{0,2,0}] = -(1./4.)*std::sqrt(15./PI);
+            }
+        } else {
+            MADNESS_EXCEPTION("ProjRLMSeparatedFunctor: l out of range", l);
+        }
+
+        // times r^(2(i-1)) = (x^2+y^2+z^2)^(i-1)
+        for (int ipow=1; ipow<i; ++ipow) {
+            polyT product;
+            for (const auto& term : poly) {
+                for (int d=0; d<3; ++d) {
+                    std::array<int,3> p = term.first;
+                    p[d] += 2;
+                    product[p] += term.second;
+                }
+            }
+            poly.swap(product);
+        }
+
+        // normalization, cf. ProjRLMFunctor
+        const int itmp = 2*l + (4*i-1);
+        const double t1 = 1./std::pow(alpha, 0.5*(double)itmp)
+                /std::sqrt(ProjRLMFunctor::gamma_data[itmp-1]*std::sqrt(PI));
+        for (const auto& term : poly) {
+            powers.push_back(term.first);
+            factors.push_back(term.second*t1*std::sqrt(2.0));
+            for (int d=0; d<3; ++d) maxpower = std::max(maxpower, term.first[d]);
+        }
+
+        // quadrature of order 2k is ample for the 1D factors
+        const int npt = 2*k;
+        quad_x = Tensor<double>(npt);
+        quad_w = Tensor<double>(npt);
+        quad_phi = Tensor<double>(npt,k);
+        gauss_legendre(npt, 0.0, 1.0, quad_x.ptr(), quad_w.ptr());
+        for (int q=0; q<npt; ++q) legendre_scaling_functions(quad_x(q), k, &quad_phi(q,0));
+    }
+
+    ProjRLMSeparatedFunctor::coeffT ProjRLMSeparatedFunctor::coeff(const Key<3>& key) const {
+        const Level n = key.level();
+        const double h = std::pow(0.5,double(n));
+        const Tensor<double>& cell = FunctionDefaults<3>::get_cell();
+        const Tensor<double>& width = FunctionDefaults<3>::get_cell_width();
+        const long npt = quad_x.dim(0);
+
+        // 1D coefficients of t^a exp(-t^2/(2 alpha^2)) in each dimension, a=0..maxpower
+        Tensor<double> c1d[3];
+        Tensor<double> fq(maxpower+1,npt);
+        for (int d=0; d<3; ++d) {
+            const double scale = std::sqrt(width(d)*h);
+            for (long q=0; q<npt; ++q) {
+                const double t = cell(d,0) + width(d)*h*(key.translation()[d] + quad_x(q)) - center[d];
+                double f = quad_w(q)*std::exp(-0.5*t*t/(alpha*alpha))*scale;
+                for (int a=0; a<=maxpower; ++a, f*=t) fq(a,q) = f;
+            }
+            c1d[d] = inner(fq,quad_phi);    // (maxpower+1,k)
+        }
+
+        // sum of the outer products of the terms
+        Tensor<double> c(k,k,k);
+        Tensor<double> xy(k,k);
+        for (std::size_t t=0; t<powers.size(); ++t) {
+            const double* x = &c1d[0](powers[t][0],0);
+            const double* y = &c1d[1](powers[t][1],0);
+            const double* z = &c1d[2](powers[t][2],0);
+            for (int p=0; p<k; ++p)
+                for (int q=0; q<k; ++q) xy(p,q) = factors[t]*x[p]*y[q];
+            double* MADNESS_RESTRICT cp = c.ptr();
+            for (int p=0; p<k; ++p)
+                for (int q=0; q<k; ++q) {
+                    const double xyv = xy(p,q);
+                    for (int r=0; r<k; ++r) *cp++ += xyv*z[r];
+                }
+        }
+        return coeffT(c, -1.0, TT_FULL);
+    }
+
 
 }
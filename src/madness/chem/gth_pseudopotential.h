@@ -9,6 +9,7 @@
 
 #include <madness/mra/mra.h>
 #include <madness/external/tinyxml/tinyxml.h>
+#include <array>
 
 #include<madness/chem/molecule.h>
 #include<madness/chem/molecularbasis.h>
@@ -352,20 +353,64 @@ public:
     }
 };
 
+/// The projector of ProjRLMFunctor, providing its coefficients in separated form
+
+/// The projectors are a polynomial times a Gaussian, i.e. a short sum of
+/// products x^a y^b z^c exp(-r^2/(2 alpha^2)) that factor into 1D pieces.
+/// The coefficients of a box are assembled from the 1D projections of
+/// t^a exp(-t^2/(2 alpha^2)) in each dimension, which are computed by
+/// Gauss-Legendre quadrature of order 2k, instead of sampling the function
+/// on the 3D quadrature grid and transforming.
+class ProjRLMSeparatedFunctor : public FunctionFunctorInterface<double,3> {
+private:
+    ProjRLMFunctor pointwise;               ///< for the evaluation at points
+    double alpha;
+    coord_3d center;
+    int k;
+    std::vector<std::array<int,3> > powers; ///< powers of x, y and z of the terms
+    std::vector<double> factors;            ///< the coefficients of the terms
+    int maxpower;
+    Tensor<double> quad_x, quad_w;          ///< 1D quadrature on [0,1]
+    Tensor<double> quad_phi;                ///< scaling functions at the quadrature points
+
+public:
+    ProjRLMSeparatedFunctor(double alpha, int l, int m, int i, const coord_3d& center,
+            int k=FunctionDefaults<3>::get_k());
+
+    bool provides_coeff() const {return true;}
+
+    /// Sum of the outer products of the 1D coefficients of the terms
+    coeffT coeff(const Key<3>& key) const;
+
+    double operator()(const coord_3d& r) const {return pointwise(r);}
+
+    std::vector<coord_3d> special_points() const {return pointwise.special_points();}
+
+    Level special_level() {
+      return 6;
+    }
+};
+
 class ProjRLMStore {
 private:
     int maxL;
     real_tensor radii;
     coord_3d center;
+    bool separated;
 
 public:
-    ProjRLMStore(const real_tensor& radii, const coord_3d& center) 
-     : maxL(radii.dim(0)), radii(radii), center(center) {}
-  
+    /// @param[in] separated construct the projectors from their separated form (default),
+    ///     otherwise by quadrature of ProjRLMFunctor
+    ProjRLMStore(const real_tensor& radii, const coord_3d& center, bool separated=true)
+     : maxL(radii.dim(0)), radii(radii), center(center), separated(separated) {}
+
     real_function_3d nlmproj(World& world, int l, int m, int i) {
-        real_function_3d f1 = (m < 2*l+1) ?
-           real_factory_3d(world).functor(real_functor_3d(new ProjRLMFunctor(radii(l), l, m, i, center))).
-               truncate_on_project().nofence().truncate_mode(0) : real_factory_3d(world);
+        if (m >= 2*l+1) return real_factory_3d(world);
+        real_functor_3d functor = separated
+            ? real_functor_3d(new ProjRLMSeparatedFunctor(radii(l), l, m, i, center))
+            : real_functor_3d(new ProjRLMFunctor(radii(l), l, m, i, center));
+        real_function_3d f1 = real_factory_3d(world).functor(functor).
+               truncate_on_project().nofence().truncate_mode(0);
         return f1;
     }
 
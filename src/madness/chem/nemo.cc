@@ -192,6 +192,7 @@ double Nemo::value(const Tensor<double>& x) {
 
 		p.start_prec=calc->amo[0].thresh();
 		p.current_prec=calc->amo[0].thresh();
+		kain.reset();
 
 		for (p.initialize() ; not p.finished(); ++p) {
 
@@ -251,6 +252,11 @@ std::shared_ptr<Fock<double, 3>> Nemo::make_fock_operator() const {
         Exchange<double,3> K=Exchange<double,3>(world,this,ispin).set_symmetric(false);
         fock->add_operator("K",{-1.0,std::make_shared<Exchange<double,3>>(K)});
     }
+    if (calc->xc.hf_exchange_sr_coefficient()!=0.0) {
+        Exchange<double,3> Ksr=Exchange<double,3>(world,this,ispin).set_symmetric(false)
+                .set_attenuation(Exchange<double,3>::short_range,calc->xc.hf_exchange_omega());
+        fock->add_operator("Ksr",{-calc->xc.hf_exchange_sr_coefficient(),std::make_shared<Exchange<double,3>>(Ksr)});
+    }
     if (calc->xc.is_dft()) {
         XCOperator<double,3> xcoperator(world,this,ispin);
         real_function_3d xc_pot = xcoperator.make_xc_potential();
@@ -324,9 +330,12 @@ double Nemo::solve(const SCFProtocol& proto) {
 	real_function_3d density=real_factory_3d(world); 	// for testing convergence
 
 	typedef allocator<double, 3> allocT;
-	typedef XNonlinearSolver<std::vector<Function<double, 3> >, double, allocT> solverT;
-	allocT alloc(world, nemo.size());
-	solverT solver(allocT(world, nemo.size()));
+	// continue with the subspace of the previous protocol step, cf set_protocol
+	if (not kain or (kain->get_ulist().size()>0 and kain->get_ulist()[0].size()!=nemo.size())) {
+	    kain=std::make_shared<kainT>(allocT(world, nemo.size()));
+	}
+	kainT& solver=*kain;
+	solver.set_subspace_thresh(param.subspace_thresh());
 
 
 	// iterate the residual equations
@@ -485,7 +494,7 @@ std::vector<double> Nemo::compute_energy_regularized(const vecfuncT& nemo, const
 //        printf("\n  nuclear and kinetic each  %16.8f\n",  pe1+ke1);
         printf("              coulomb %16.8f\n", J);
         if (is_dft()) printf(" exchange-correlation %16.8f\n", exc);
-        if (calc->xc.hf_exchange_coefficient()!=0.0) printf("       exact exchange %16.8f\n", -K);
+        if (calc->xc.has_hf_exchange()) printf("       exact exchange %16.8f\n", -K);
         if (do_pcm()) printf("   polarization (PCM) %16.8f\n", pcm_energy);
         printf("    nuclear-repulsion %16.8f\n", nucrep);
         printf("   regularized energy %16.8f\n", energy);
@@ -524,10 +533,16 @@ void Nemo::compute_nemo_potentials(const vecfuncT& nemo,
             // compute the exchange potential
             int ispin = 0;
             Knemo = zero_functions_compressed<double, 3>(world, nemo.size());
+            vecfuncT Ksrnemo = zero_functions_compressed<double, 3>(world, nemo.size());
             if (calc->xc.hf_exchange_coefficient() > 0.0) {
                 Exchange<double, 3> K = Exchange<double, 3>(world, this, ispin).set_symmetric(true).set_taskq(taskq);
                 Knemo = K(nemo);
             }
+            if (calc->xc.hf_exchange_sr_coefficient() != 0.0) {
+                Exchange<double, 3> Ksr = Exchange<double, 3>(world, this, ispin).set_symmetric(true).set_taskq(taskq)
+                        .set_attenuation(Exchange<double, 3>::short_range, calc->xc.hf_exchange_omega());
+                Ksrnemo = Ksr(nemo);
+            }
             t.tag("initialize K operator");
             taskq->set_printlevel(param.print_level());
             if (param.print_level()>9) taskq->print_taskq();
@@ -535,6 +550,7 @@ void Nemo::compute_nemo_potentials(const vecfuncT& nemo,
 
             t.tag("compute Knemo");
             scale(world, Knemo, calc->xc.hf_exchange_coefficient());
+            gaxpy(world, 1.0, Knemo, calc->xc.hf_exchange_sr_coefficient(), Ksrnemo);
             truncate(world, Knemo);
         }
 
@@ -1284,6 +1300,247 @@ vecfuncT Nemo::solve_cphf(const size_t iatom, const int iaxis, const Tensor<doub
 }
 
 
+/// solve the CPHF equations for several nuclear displacements simultaneously
+
+/// @param[in]  ipert   the displacements, 3*iatom+iaxis
+/// @return     \frac{\partial}{\partial X_A} \varphi for each displacement
+std::vector<vecfuncT> Nemo::solve_cphf(const std::vector<int>& ipert, const Tensor<double> fock,
+        const std::vector<vecfuncT>& guess, const std::vector<vecfuncT>& rhsconst,
+        const Tensor<double> incomplete_hessian, const std::vector<vecfuncT>& parallel,
+        const SCFProtocol& proto, const std::string& xc_data) const {
+
+    const std::size_t npert=ipert.size();
+    MADNESS_CHECK(guess.size()==npert and rhsconst.size()==npert and parallel.size()==npert);
+    print("\nsolving nemo cphf equations for",npert,"displacements simultaneously");
+
+    std::vector<vecfuncT> xi=guess;
+    const vecfuncT nemo=calc->amo;
+    const int nmo=nemo.size();
+    const int natom=molecule().natom();
+    const Tensor<double> occ=get_calc()->get_aocc();
+    const real_function_3d rhonemo=2.0*make_density(occ,nemo); // closed shell
+    const real_function_3d arho=0.5*R_square*rhonemo;
+
+    // the derivatives of the NCF enter the xc kernel
+    std::vector<real_function_3d> RXR(npert);
+    if (is_dft()) {
+        for (std::size_t p=0; p<npert; ++p) {
+            NuclearCorrelationFactor::RX_functor rxr_func(ncf.get(),ipert[p]/3,ipert[p]%3,2);
+            RXR[p]=real_factory_3d(world).functor(rxr_func).truncate_on_project();
+        }
+    }
+
+    vecfuncT R2nemo=mul(world,R_square,nemo);
+    truncate(world,R2nemo);
+    QProjector<double,3> Q(world,R2nemo,nemo);
+
+    // construct quantities that are independent of xi
+
+    // construct the BSH operators, shared by all displacements
+    tensorT eps(nmo);
+    for (int i = 0; i < nmo; ++i) eps(i) = fock(i, i);
+    std::vector<poperatorT> bsh = calc->make_bsh_operators(world, eps);
+    for (poperatorT& b : bsh) b->destructive()=true;    // make it memory efficient
+
+    // pair potentials (R^2 F_k F_i)/|r-r'| of the perturbed exchange operator
+    // K1^X F_i = \sum_k xi_k (R^2 F_k F_i)/|r-r'|; symmetric in k and i
+    std::vector<vecfuncT> pairpot(nmo,vecfuncT(nmo));
+    if (not is_dft()) {
+        vecfuncT pairs;
+        for (int i=0; i<nmo; ++i) {
+            vecfuncT tmp=mul(world,nemo[i],vecfuncT(R2nemo.begin(),R2nemo.begin()+i+1));
+            pairs.insert(pairs.end(),tmp.begin(),tmp.end());
+        }
+        truncate(world,pairs);
+        pairs=apply(world,*poisson,pairs);
+        truncate(world,pairs);
+        for (int i=0, ik=0; i<nmo; ++i) {
+            for (int k=0; k<=i; ++k, ++ik) {
+                pairpot[i][k]=pairs[ik];
+                pairpot[k][i]=pairs[ik];
+            }
+        }
+    }
+
+    // construct the KAIN solvers, one subspace per displacement
+    typedef allocator<double, 3> allocT;
+    typedef XNonlinearSolver<std::vector<Function<double, 3> >, double, allocT> solverT;
+    std::vector<solverT> solver(npert,solverT(allocT(world, nemo.size())));
+    for (solverT& s : solver) s.set_maxsub(5);
+
+    // construct unperturbed operators
+    const Coulomb<double,3> J(world,this);
+    const Exchange<double,3> K=Exchange<double,3>(world,this,0);
+    const XCOperator<double,3> xc(world, xc_data, not param.spin_restricted(), arho, arho);
+    const Nuclear<double,3> V(world,this);
+
+    std::vector<bool> converged(npert,false);
+    std::vector<Tensor<double> > old_h(npert,Tensor<double>(3*natom));
+    for (int iter=0; iter<10; ++iter) {
+
+        // the displacements still iterating, as one block of functions
+        std::vector<std::size_t> active;
+        for (std::size_t p=0; p<npert; ++p) if (not converged[p]) active.push_back(p);
+        if (active.size()==0) break;
+        const std::size_t nactive=active.size();
+
+        vecfuncT allxi, allxi_complete;
+        for (std::size_t p : active) {
+            allxi.insert(allxi.end(),xi[p].begin(),xi[p].end());
+            const vecfuncT xi_complete=xi[p]-parallel[p];
+            allxi_complete.insert(allxi_complete.end(),xi_complete.begin(),xi_complete.end());
+        }
+        auto block=[&nmo](const vecfuncT& v, const std::size_t a) {
+            return vecfuncT(v.begin()+a*nmo,v.begin()+(a+1)*nmo);
+        };
+
+        // make the rhs
+        vecfuncT Vpsi1=V(allxi) + J(allxi);
+        if (is_dft()) {
+            Vpsi1+=(xc(allxi));
+        } else {
+            Vpsi1-=(K(allxi));
+        }
+        truncate(world,Vpsi1);
+
+        // perturbed Coulomb potentials of all displacements
+        // factor 4 from: closed shell (2) and cphf (2)
+        vecfuncT density_pert(nactive);
+        for (std::size_t a=0; a<nactive; ++a) {
+            density_pert[a]=4.0*make_density(occ,R2nemo,block(allxi_complete,a));
+        }
+        vecfuncT Jp=apply(world,*poisson,density_pert);
+        truncate(world,Jp);
+
+        vecfuncT Vpsi2;
+        for (std::size_t a=0; a<nactive; ++a) {
+            const std::size_t p=active[a];
+            const vecfuncT xi_complete=block(allxi_complete,a);
+            vecfuncT Kp;
+            if (is_dft()) {
+                // reconstruct the full perturbed density: do not truncate!
+                const real_function_3d full_dens_pt=(density_pert[a] + 2.0*RXR[p]*rhonemo);
+                real_function_3d gamma=-1.0*xc.apply_xc_kernel(full_dens_pt);
+                Kp=truncate(gamma*nemo);
+            } else {
+                vecfuncT Kp1(nmo);
+                for (int i=0; i<nmo; ++i) Kp1[i]=dot(world,xi_complete,pairpot[i]);
+                vecfuncT R2xi=mul(world,R_square,xi_complete);
+                truncate(world,R2xi);
+                Exchange<double,3> Kp2;
+                Kp2.set_parameters(R2xi,nemo,param.lo());
+                Kp=truncate(Kp1 + Kp2(nemo));
+            }
+            vecfuncT tmp=truncate(mul(world,Jp[a],nemo)-Kp+rhsconst[p]);
+            Vpsi2.insert(Vpsi2.end(),tmp.begin(),tmp.end());
+        }
+        Vpsi2=Q(Vpsi2);
+        truncate(world,Vpsi2);
+
+        vecfuncT Vpsi=truncate(Vpsi1+Vpsi2);
+        Vpsi1.clear();
+        Vpsi2.clear();
+
+        // add the coupling elements in case of localized orbitals
+        if (get_calc()->param.do_localize()) {
+            Tensor<double> fcopy=copy(fock);
+            for (int i = 0; i < nmo; ++i) fcopy(i, i) -= eps(i);
+            vecfuncT fnemo;
+            for (std::size_t a=0; a<nactive; ++a) {
+                vecfuncT tmp=transform(world, block(allxi,a), fcopy, trantol(), true);
+                fnemo.insert(fnemo.end(),tmp.begin(),tmp.end());
+            }
+            gaxpy(world, 1.0, Vpsi, -1.0, fnemo);
+            truncate(Vpsi);
+        }
+
+        // apply the BSH operators on the wave functions of all displacements
+        std::vector<poperatorT> allbsh;
+        for (std::size_t a=0; a<nactive; ++a) allbsh.insert(allbsh.end(),bsh.begin(),bsh.end());
+        scale(world,Vpsi,-2.0);
+        vecfuncT tmp = apply(world, allbsh, Vpsi);
+        Vpsi.clear();
+        truncate(world, tmp);
+
+        tmp=Q(tmp);
+        truncate(world,tmp);
+
+        vecfuncT residual = allxi-tmp;
+        std::vector<double> rnorm = norm2s(world, residual);
+        std::vector<double> xnorm = norm2s(world, allxi);
+
+        for (std::size_t a=0; a<nactive; ++a) {
+            const std::size_t p=active[a];
+            const int ii=ipert[p];
+
+            double rms, maxval;
+            calc->vector_stats(std::vector<double>(rnorm.begin()+a*nmo,rnorm.begin()+(a+1)*nmo), rms, maxval);
+            double norm=0.0;
+            for (int i=0; i<nmo; ++i) norm+=xnorm[a*nmo+i]*xnorm[a*nmo+i];
+            norm=sqrt(norm);
+
+            if (rms < 1.0) {
+                xi[p] = solver[p].update(xi[p], block(residual,a));
+            } else {
+                xi[p] = block(tmp,a);
+            }
+            truncate(xi[p]);
+
+            // measure for hessian matrix elements
+            real_function_3d dens_pt=dot(world,xi[p]-parallel[p],nemo);
+            dens_pt=4.0*R_square*dens_pt;
+            Tensor<double> h(3*natom);
+            for (int jatom=0, j=0; jatom<natom; ++jatom) {
+                for (int jaxis=0; jaxis<3; ++jaxis, ++j) {
+                    if (j==ii) continue;
+                    MolecularDerivativeFunctor mdf(molecule(), jatom, jaxis);
+                    h(j)=inner(dens_pt,mdf);
+                }
+            }
+            Tensor<double> h_diff=h-old_h[p];
+            old_h[p]=h;
+
+            if (world.rank() == 0)
+                print("xi_"+stringify(ii),"CPHF BSH residual: rms", rms,
+                        "   max", maxval, "H, Delta H", h.normf(), h_diff.absmax());
+
+            if (rms/norm<proto.dconv and (h_diff.absmax()<1.e-2)) converged[p]=true;
+        }
+    }
+    return xi;
+}
+
+
+/// solve the CPHF equations for all displacements in batches of param.cphf_batch()
+
+/// @param[in,out]  xi  on entry the guess, on exit the solution for each displacement
+void Nemo::solve_all_cphf(std::vector<vecfuncT>& xi, const Tensor<double> fock,
+        const std::vector<vecfuncT>& rhsconst, const Tensor<double> incomplete_hessian,
+        const std::vector<vecfuncT>& parallel, const SCFProtocol& proto,
+        const std::string& xc_data) const {
+
+    const int npert=xi.size();
+    const int batch=(param.cphf_batch()>0) ? param.cphf_batch() : npert;
+    for (int first=0; first<npert; first+=batch) {
+        const int last=std::min(npert,first+batch);
+        std::vector<int> ipert;
+        std::vector<vecfuncT> guess, rhs, par;
+        for (int i=first; i<last; ++i) {
+            for (real_function_3d& xij : xi[i]) xij.set_thresh(proto.current_prec);
+            ipert.push_back(i);
+            guess.push_back(xi[i]);
+            rhs.push_back(rhsconst[i]);
+            par.push_back(parallel[i]);
+        }
+        std::vector<vecfuncT> result=solve_cphf(ipert,fock,guess,rhs,incomplete_hessian,par,proto,xc_data);
+        for (int i=first; i<last; ++i) {
+            xi[i]=result[i-first];
+            save_function(xi[i],"xi_guess"+stringify(i));
+        }
+    }
+}
+
+
 std::vector<vecfuncT> Nemo::compute_all_cphf() {
 
     const int natom=molecule().natom();
@@ -1368,17 +1625,8 @@ std::vector<vecfuncT> Nemo::compute_all_cphf() {
             printf("\nstarting initial CPHF equations at time %8.1fs \n",wall_time());
         }
 
-        // double loop over all nuclear displacements
-        for (int i=0, iatom=0; iatom<natom; ++iatom) {
-            for (int iaxis=0; iaxis<3; ++iaxis, ++i) {
-                if (xi[i].size()>0) {
-                    for (real_function_3d& xij : xi[i]) xij.set_thresh(preiterations.current_prec);
-                }
-                xi[i]=solve_cphf(iatom,iaxis,fock,xi[i],rhsconst[i],
-                        incomplete_hessian,parallel[i],preiterations,"LDA");
-                save_function(xi[i],"xi_guess"+stringify(i));
-            }
-        }
+        // all nuclear displacements, batched
+        solve_all_cphf(xi,fock,rhsconst,incomplete_hessian,parallel,preiterations,"LDA");
         if (world.rank()==0) {
             printf("\nfinished CPHF equations at time %8.1fs \n",wall_time());
         }
@@ -1404,17 +1652,8 @@ std::vector<vecfuncT> Nemo::compute_all_cphf() {
             print("solving CPHF with the density functional",param.xc());
         }
 
-        // double loop over all nuclear displacements
-        for (int i=0, iatom=0; iatom<natom; ++iatom) {
-            for (int iaxis=0; iaxis<3; ++iaxis, ++i) {
-                if (xi[i].size()>0) {
-                    for (real_function_3d& xij : xi[i]) xij.set_thresh(p.current_prec);
-                }
-                xi[i]=solve_cphf(iatom,iaxis,fock,xi[i],rhsconst[i],
-                        incomplete_hessian,parallel[i],p,param.xc());
-                save_function(xi[i],"xi_guess"+stringify(i));
-            }
-        }
+        // all nuclear displacements, batched
+        solve_all_cphf(xi,fock,rhsconst,incomplete_hessian,parallel,p,param.xc());
         if (world.rank()==0) {
             printf("\nfinished CPHF equations at time %8.1fs \n",wall_time());
         }
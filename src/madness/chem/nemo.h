@@ -367,11 +367,13 @@ public:
 			initialize<bool> ("read_cphf",false,"read the converged orbital response for nuclear displacements from file");
 			initialize<bool> ("restart_cphf",false,"read the guess orbital response for nuclear displacements from file");
 			initialize<bool> ("purify_hessian",false,"symmetrize the hessian matrix based on atomic charges");
+			initialize<int> ("cphf_batch",0,"number of nuclear displacements whose CPHF equations are solved together, 0 for all");
             set_derived_value("k",7);
 		}
 
 		std::pair<std::string,double> ncf() const {return get<std::pair<std::string,double> >("ncf");}
 		bool hessian() const {return get<bool>("hessian");}
+		int cphf_batch() const {return get<int>("cphf_batch");}
 
 	};
 
@@ -458,6 +460,34 @@ public:
 	        const Tensor<double> incomplete_hessian, const vecfuncT& parallel,
 	        const SCFProtocol& p, const std::string& xc_data) const;
 
+	/// solve the CPHF equations for several nuclear displacements simultaneously
+
+	/// The perturbations are iterated as one block of response vectors:
+	/// the unperturbed potentials, the projector and the BSH operators act on
+	/// all of them in single vector calls, the perturbed Coulomb potentials
+	/// are one vector application of the Poisson operator, and the pair
+	/// potentials of the perturbed exchange operator that do not depend on
+	/// the response are computed once for all perturbations. Converged
+	/// perturbations drop out of the block.
+	/// @param[in]  ipert   the displacements, 3*iatom+iaxis
+	/// @param[in]  guess   guess for each displacement in ipert
+	/// @param[in]  rhsconst    constant term for each displacement in ipert
+	/// @param[in]  parallel    parallel term for each displacement in ipert
+	/// @return     \ket{F^\perp} for each displacement in ipert
+	std::vector<vecfuncT> solve_cphf(const std::vector<int>& ipert, const Tensor<double> fock,
+	        const std::vector<vecfuncT>& guess, const std::vector<vecfuncT>& rhsconst,
+	        const Tensor<double> incomplete_hessian, const std::vector<vecfuncT>& parallel,
+	        const SCFProtocol& p, const std::string& xc_data) const;
+
+	/// solve the CPHF equations for all displacements, param.cphf_batch() of them simultaneously
+
+	/// the solutions are saved as xi_guess
+	/// @param[in,out]  xi  on entry the guess, on exit the solution for each displacement
+	void solve_all_cphf(std::vector<vecfuncT>& xi, const Tensor<double> fock,
+	        const std::vector<vecfuncT>& rhsconst, const Tensor<double> incomplete_hessian,
+	        const std::vector<vecfuncT>& parallel, const SCFProtocol& p,
+	        const std::string& xc_data) const;
+
 	/// solve the CPHF equation for all displacements
 
 	/// this function computes the nemo response F^X
@@ -604,6 +634,11 @@ protected:
 	/// a poisson solver
 	std::shared_ptr<real_convolution_3d> poisson;
 
+	typedef XNonlinearSolver<std::vector<Function<double,3> >,double,allocator<double,3> > kainT;
+
+	/// the KAIN solver, carried over from one protocol step to the next
+	std::shared_ptr<kainT> kain;
+
 	/// asymptotic correction for DFT
 	AC<3> ac;
 
@@ -640,13 +675,16 @@ protected:
             timer1.end("reproject ncf");
         }
 
-        // (re) construct the Poisson solver
-        poisson = std::shared_ptr<real_convolution_3d>(
-                CoulombOperatorPtr(world, param.lo(), FunctionDefaults<3>::get_thresh()));
+        // (re) construct the Poisson solver, or reuse it from an earlier protocol step
+        poisson = calc->coulomb_operator(world, param.lo(), FunctionDefaults<3>::get_thresh());
 
-        // set thresholds for the MOs
-        set_thresh(world,calc->amo,thresh);
-        set_thresh(world,calc->bmo,thresh);
+        // bring the MOs and the KAIN subspace to the current k and thresh
+        calc->project_to_protocol(world,calc->amo);
+        calc->project_to_protocol(world,calc->bmo);
+        if (kain) {
+            for (vecfuncT& v : kain->get_ulist()) calc->project_to_protocol(world,v);
+            for (vecfuncT& v : kain->get_rlist()) calc->project_to_protocol(world,v);
+        }
 
     }
 
@@ -729,7 +767,7 @@ protected:
         plot_line(("line_"+name).c_str(),1000,start,end,f);
     }
 
-    /// save a function
+    /// save a vector of functions, every process writing its own file
     template<typename T, size_t NDIM>
     void save_function(const std::vector<Function<T,NDIM> >& f, const std::string name) const;
 
@@ -765,15 +803,16 @@ void Nemo::rotate_subspace(World& world, const tensorT& U, solverT& solver,
 /// save a function
 template<typename T, size_t NDIM>
 void Nemo::save_function(const std::vector<Function<T,NDIM> >& f, const std::string name) const {
-    if (world.rank()==0) print("saving vector of functions",name);
-    archive::ParallelOutputArchive<archive::BinaryFstreamOutputArchive> ar(world, name.c_str(), 1);
-    ar & f.size();
-    for (const Function<T,NDIM>& ff:f)  ar & ff;
+    save_function_parallel(world, f, name);
 }
 
-/// load a function
+/// load a function, also from files written by the serial save_function
 template<typename T, size_t NDIM>
 void Nemo::load_function(std::vector<Function<T,NDIM> >& f, const std::string name) const {
+    if (is_parallel_function_file(world, name)) {
+        load_function_parallel(world, f, name);
+        return;
+    }
     if (world.rank()==0) print("loading vector of functions",name);
     archive::ParallelInputArchive<archive::BinaryFstreamInputArchive> ar(world, name.c_str(), 1);
     std::size_t fsize=0;
@@ -781,7 +820,6 @@ void Nemo::load_function(std::vector<Function<T,NDIM> >& f, const std::string na
     f.resize(fsize);
     for (std::size_t i=0; i<fsize; ++i) ar & f[i];
 }
-
 }
 
 #endif /* NEMO_H_ */
@@ -33,6 +33,7 @@
 #include<madness/chem/pcm.h>
 #include<madness/chem/atomutil.h>
 #include<madness/chem/molecule.h>
+#include<madness/chem/point_charge_tree.h>
 
 
 #ifdef MADNESS_HAS_PCM
@@ -44,59 +45,6 @@ namespace madness {
 
 namespace detail {
 
-/// to convert the apparent surface charge potential to a real_function_3d
-struct asc_potential : public FunctionFunctorInterface<double,3> {
-
-    /// the coordinates of the apparent surface charges
-    std::vector<coord_3d> asc_coord;
-
-    /// the charges of the apparent surface charges
-    std::vector<double> asc_value;
-
-    /// regularization parameter for the (singular) surface charges
-    double rcut;
-
-    /// constructor
-
-    /// @param[in]  size    the grid size (number of apparent surface charges, ASC)
-    /// @param[in]  coord   the coordinates of the ASC
-    /// @param[in]  val     the charges of the ASC
-    asc_potential(const int size, const Tensor<double> coord, const Tensor<double> val)
-        : rcut(3.0) {
-
-        asc_coord.resize(size);
-        asc_value.resize(size);
-        for (int i=0; i<size; ++i) {
-            coord_3d c;
-            c[0]=coord(3*i);
-            c[1]=coord(3*i+1);
-            c[2]=coord(3*i+2);
-            asc_coord[i]=c;
-            asc_value[i]=val(i);
-        }
-
-        // the smoothing parameter is based on the assumption that
-        // electron density is high near the singularity, but the ASC
-        // are at the van-der-Waals distance. We can savely use a smaller rcut.
-//        double Z=*std::max_element(asc_value.begin(),asc_value.end());
-//        double eprec=1.e-4;
-//        rcut=smoothing_parameter(Z,eprec);
-
-    }
-
-    /// return the value of the ASC potential
-    double operator()(const coord_3d& r) const {
-
-        double sum = 0.0;
-        for (unsigned int i=0; i<asc_value.size(); ++i) {
-            double rr=(r-asc_coord[i]).normf();
-            sum += asc_value[i] * smoothed_potential(rr*rcut)*rcut;
-        }
-        return sum;
-
-    }
-};
-
 void host_writer(const char * message) {
     std::string msg(message);
     print(msg);
@@ -224,11 +172,13 @@ real_function_3d PCM::compute_pcm_potential(const real_function_3d& coulomb_pote
     // nuclear potential is density independent
     if(dynamic) mep = 0.0;
 
-    // add the electronic contribution to the mep
+    // add the electronic contribution to the mep, evaluating all cavity
+    // points in one batched pass over the leaf boxes of the potential
+    std::vector<coord_3d> evalpoints(grid_size);
     for (int i=0; i<grid_size; ++i) {
-        coord_3d evalpoint={grid(3*i),grid(3*i+1),grid(3*i+2)};
-        mep[i]-=coulomb_potential(evalpoint);
+        evalpoints[i]={grid(3*i),grid(3*i+1),grid(3*i+2)};
     }
+    mep-=coulomb_potential.eval_points(evalpoints);
 
     // This is the Ag irreducible representation (totally symmetric)
     int irrep = 0;
@@ -251,7 +201,19 @@ real_function_3d PCM::compute_pcm_potential(const real_function_3d& coulomb_pote
         pcmsolver_get_surface_function(pcm_context.get(), grid_size, asc.ptr(), asc_lbl.c_str());
     }
 
-    detail::asc_potential ascpot(grid_size,grid,asc);
+    // the potential of the apparent surface charges (ASC), evaluated with a
+    // multipole tree code.  The smoothing parameter is based on the assumption
+    // that electron density is high near the singularity, but the ASC are at
+    // the van-der-Waals distance. We can savely use a smaller rcut.
+    const double rcut=3.0;
+    std::vector<coord_3d> asc_coord(grid_size);
+    std::vector<double> asc_value(grid_size);
+    for (int i=0; i<grid_size; ++i) {
+        asc_coord[i]={grid(3*i),grid(3*i+1),grid(3*i+2)};
+        asc_value[i]=asc(i);
+    }
+    std::shared_ptr<PointChargeTree> asc_tree(new PointChargeTree(asc_coord,asc_value,10,0.35,16,rcut));
+    std::shared_ptr<FunctionFunctorInterface<double,3> > ascpot(new PointChargePotential(asc_tree));
     World& world = coulomb_potential.world();
     real_function_3d v=real_factory_3d(world).functor(ascpot);
 
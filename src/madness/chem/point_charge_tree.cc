@@ -0,0 +1,399 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+/// \file point_charge_tree.cc
+/// \brief Hierarchical multipole evaluation of the Coulomb potential of many point charges
+
+#include <madness/chem/point_charge_tree.h>
+#include <madness/chem/atomutil.h>
+#include <algorithm>
+#include <cmath>
+
+namespace madness {
+
+/// deepest level of the tree, guards against coinciding charges
+static const Level max_tree_level = 30;
+
+PointChargeTree::PointChargeTree(const std::vector<coord_3d>& coords, const std::vector<double>& charges,
+                                 const int order, const double theta, const long leaf_size,
+                                 const double rcut)
+    : x(coords), q(charges), order(order), theta(theta), leaf_size(leaf_size), rcut(rcut)
+    , rsmooth(rcut>0.0 ? 7.0/rcut : 0.0) {
+    MADNESS_CHECK(x.size()==q.size());
+    MADNESS_CHECK(order>=0);
+    MADNESS_CHECK(theta>0.0 and theta<1.0);
+    MADNESS_CHECK(leaf_size>0);
+
+    const int p1=order+1;
+    index.assign(p1*p1*p1,-1);
+    for (int n=0; n<=order; ++n) {
+        for (int t=n; t>=0; --t) {
+            for (int u=n-t; u>=0; --u) {
+                const int v=n-t-u;
+                index[(t*p1+u)*p1+v]=terms.size();
+                terms.push_back({{t,u,v}});
+            }
+        }
+    }
+
+    if (x.size()==0) return;
+    std::vector<long> all(x.size());
+    for (std::size_t i=0; i<x.size(); ++i) all[i]=i;
+    build(Key<3>(0),all);
+}
+
+
+coord_3d PointChargeTree::box_center(const Key<3>& key) const {
+    const Tensor<double>& cell=FunctionDefaults<3>::get_cell();
+    const Tensor<double>& width=FunctionDefaults<3>::get_cell_width();
+    const double h=std::pow(0.5,double(key.level()));
+    coord_3d c;
+    for (int d=0; d<3; ++d) c[d]=cell(d,0)+width[d]*h*(double(key.translation()[d])+0.5);
+    return c;
+}
+
+
+void PointChargeTree::build(const Key<3>& key, const std::vector<long>& charges) {
+    Node& node=tree[key];
+    node.center=box_center(key);
+    node.radius=0.0;
+    for (long i : charges) node.radius=std::max(node.radius,(x[i]-node.center).normf());
+    node.moments.assign(terms.size(),0.0);
+
+    if (long(charges.size())<=leaf_size or key.level()>=max_tree_level) {
+        node.charges=charges;
+        std::vector<double> px(order+1), py(order+1), pz(order+1);
+        for (long i : charges) {
+            const coord_3d d=x[i]-node.center;
+            px[0]=py[0]=pz[0]=1.0;
+            for (int t=1; t<=order; ++t) {
+                px[t]=px[t-1]*d[0]/t;
+                py[t]=py[t-1]*d[1]/t;
+                pz[t]=pz[t-1]*d[2]/t;
+            }
+            for (std::size_t a=0; a<terms.size(); ++a) {
+                const std::array<int,3>& tuv=terms[a];
+                node.moments[a]+=q[i]*px[tuv[0]]*py[tuv[1]]*pz[tuv[2]];
+            }
+        }
+        return;
+    }
+
+    // sort the charges into the children
+    const Tensor<double>& cell=FunctionDefaults<3>::get_cell();
+    const Tensor<double>& width=FunctionDefaults<3>::get_cell_width();
+    const Level n=key.level()+1;
+    const Translation twon=Translation(1)<<n;
+    std::map<Key<3>,std::vector<long> > children;
+    for (long i : charges) {
+        Vector<Translation,3> l;
+        for (int d=0; d<3; ++d) {
+            Translation ld=Translation(std::floor((x[i][d]-cell(d,0))/width[d]*twon));
+            // charges outside of the cell stay with the nearest box at the boundary
+            ld=std::max(ld,2*key.translation()[d]);
+            ld=std::min(ld,2*key.translation()[d]+1);
+            l[d]=ld;
+        }
+        children[Key<3>(n,l)].push_back(i);
+    }
+
+    std::vector<Key<3> > childkeys;
+    for (auto& child : children) {
+        build(child.first,child.second);
+        childkeys.push_back(child.first);
+    }
+
+    // shift the moments of the children to the center of this box;
+    // tree is a std::map, so node is still valid
+    std::vector<double> px(order+1), py(order+1), pz(order+1);
+    for (const Key<3>& ckey : childkeys) {
+        const Node& child=tree.find(ckey)->second;
+        const coord_3d delta=child.center-node.center;
+        px[0]=py[0]=pz[0]=1.0;
+        for (int t=1; t<=order; ++t) {
+            px[t]=px[t-1]*delta[0]/t;
+            py[t]=py[t-1]*delta[1]/t;
+            pz[t]=pz[t-1]*delta[2]/t;
+        }
+        for (std::size_t a=0; a<terms.size(); ++a) {
+            const std::array<int,3>& tuv=terms[a];
+            double sum=0.0;
+            for (int t=0; t<=tuv[0]; ++t) {
+                for (int u=0; u<=tuv[1]; ++u) {
+                    const double pxy=px[tuv[0]-t]*py[tuv[1]-u];
+                    for (int v=0; v<=tuv[2]; ++v) {
+                        sum+=child.moments[term_index(t,u,v)]*pxy*pz[tuv[2]-v];
+                    }
+                }
+            }
+            node.moments[a]+=sum;
+        }
+    }
+    node.children=childkeys;
+}
+
+
+/// The McMurchie-Davidson recursion for the Hermite integrals of 1/R
+///
+///   R^(n)_000   = (-1)^n (2n-1)!! / R^(2n+1)
+///   R^(n)_t+1uv = t R^(n+1)_t-1uv + X R^(n+1)_tuv    (and likewise for u and v)
+///
+/// with D_tuv = R^(0)_tuv.  D holds two layers of (order+1)^3 entries,
+/// on output the first layer contains D_tuv.
+void PointChargeTree::derivatives(const coord_3d& R, std::vector<double>& D) const {
+    const int p1=order+1;
+    const std::size_t layer=p1*p1*p1;
+    if (D.size()<2*layer) D.resize(2*layer);
+    const double r2=R[0]*R[0]+R[1]*R[1]+R[2]*R[2];
+    const double rinv2=1.0/r2;
+    double base=std::sqrt(rinv2);
+    std::vector<double> b(order+1);
+    for (int n=0; n<=order; ++n) {
+        b[n]=base;
+        base*=-(2*n+1)*rinv2;
+    }
+
+    for (int n=order; n>=0; --n) {
+        double* cur=&D[(n%2)*layer];
+        const double* prev=&D[((n+1)%2)*layer];
+        for (int t=0; t<=order-n; ++t) {
+            for (int u=0; u<=order-n-t; ++u) {
+                for (int v=0; v<=order-n-t-u; ++v) {
+                    double val;
+                    if (t>0) {
+                        val=R[0]*prev[((t-1)*p1+u)*p1+v];
+                        if (t>1) val+=(t-1)*prev[((t-2)*p1+u)*p1+v];
+                    } else if (u>0) {
+                        val=R[1]*prev[(t*p1+u-1)*p1+v];
+                        if (u>1) val+=(u-1)*prev[(t*p1+u-2)*p1+v];
+                    } else if (v>0) {
+                        val=R[2]*prev[(t*p1+u)*p1+v-1];
+                        if (v>1) val+=(v-1)*prev[(t*p1+u)*p1+v-2];
+                    } else {
+                        val=b[n];
+                    }
+                    cur[(t*p1+u)*p1+v]=val;
+                }
+            }
+        }
+    }
+}
+
+
+double PointChargeTree::expansion(const Node& node, const coord_3d& r, std::vector<double>& D) const {
+    derivatives(r-node.center,D);
+    const int p1=order+1;
+    double sum=0.0;
+    for (std::size_t a=0; a<terms.size(); ++a) {
+        const std::array<int,3>& tuv=terms[a];
+        const double term=node.moments[a]*D[(tuv[0]*p1+tuv[1])*p1+tuv[2]];
+        sum+=((tuv[0]+tuv[1]+tuv[2])%2) ? -term : term;
+    }
+    return sum;
+}
+
+
+/// The far field of the box about the target center c, r=c+s,
+///
+///   phi(r) = sum_abc L_abc s^abc
+///   L_abc  = 1/(a!b!c!) sum_tuv (-1)^(t+u+v) M_tuv D_t+a,u+b,v+c
+///
+/// truncated at t+u+v+a+b+c<=order, which is of the same order in theta
+/// as the multipole expansion itself.
+void PointChargeTree::local_expansion(const Node& node, const coord_3d& center,
+                                      std::vector<double>& L, std::vector<double>& D) const {
+    const int p1=order+1;
+    derivatives(center-node.center,D);
+    std::vector<double> sM(terms.size());
+    for (std::size_t a=0; a<terms.size(); ++a) {
+        const std::array<int,3>& tuv=terms[a];
+        sM[a]=((tuv[0]+tuv[1]+tuv[2])%2) ? -node.moments[a] : node.moments[a];
+    }
+    std::vector<double> inv_fact(order+1);
+    inv_fact[0]=1.0;
+    for (int n=1; n<=order; ++n) inv_fact[n]=inv_fact[n-1]/n;
+
+    for (std::size_t b=0; b<terms.size(); ++b) {
+        const std::array<int,3>& abc=terms[b];
+        // terms are ordered by t+u+v, the first nterm have t+u+v<=m
+        const long m=order-abc[0]-abc[1]-abc[2];
+        const std::size_t nterm=(m+1)*(m+2)*(m+3)/6;
+        double sum=0.0;
+        for (std::size_t a=0; a<nterm; ++a) {
+            const std::array<int,3>& tuv=terms[a];
+            sum+=sM[a]*D[((tuv[0]+abc[0])*p1+tuv[1]+abc[1])*p1+tuv[2]+abc[2]];
+        }
+        L[b]+=sum*inv_fact[abc[0]]*inv_fact[abc[1]]*inv_fact[abc[2]];
+    }
+}
+
+
+double PointChargeTree::direct(const Node& node, const coord_3d& r, const long skip) const {
+    double sum=0.0;
+    for (long i : node.charges) {
+        if (i==skip) continue;
+        const double rr=(r-x[i]).normf();
+        if (rcut>0.0) sum+=q[i]*smoothed_potential(rr*rcut)*rcut;
+        else sum+=q[i]/rr;
+    }
+    return sum;
+}
+
+
+double PointChargeTree::smoothing_correction(const Key<3>& key, const coord_3d& r) const {
+    const Node& node=tree.find(key)->second;
+    if ((r-node.center).normf()-node.radius>=rsmooth) return 0.0;
+    double sum=0.0;
+    if (node.children.empty()) {
+        for (long i : node.charges) {
+            const double rr=(r-x[i]).normf();
+            sum+=q[i]*(smoothed_potential(rr*rcut)*rcut-1.0/rr);
+        }
+    } else {
+        for (const Key<3>& child : node.children) sum+=smoothing_correction(child,r);
+    }
+    return sum;
+}
+
+
+double PointChargeTree::potential(const Key<3>& key, const coord_3d& r,
+                                  std::vector<double>& D, const long skip) const {
+    const Node& node=tree.find(key)->second;
+    const double dist=(r-node.center).normf();
+    if (dist*theta>node.radius) {
+        double sum=expansion(node,r,D);
+        if (dist-node.radius<rsmooth) sum+=smoothing_correction(key,r);
+        return sum;
+    }
+    if (node.children.empty()) return direct(node,r,skip);
+    double sum=0.0;
+    for (const Key<3>& child : node.children) sum+=potential(child,r,D,skip);
+    return sum;
+}
+
+
+double PointChargeTree::potential(const coord_3d& r) const {
+    if (tree.empty()) return 0.0;
+    std::vector<double> D;
+    return potential(Key<3>(0),r,D,-1);
+}
+
+
+std::vector<double> PointChargeTree::potential(const std::vector<coord_3d>& r) const {
+    std::vector<double> result(r.size(),0.0);
+    if (tree.empty()) return result;
+    std::vector<double> D;
+    for (std::size_t i=0; i<r.size(); ++i) result[i]=potential(Key<3>(0),r[i],D,-1);
+    return result;
+}
+
+
+std::vector<double> PointChargeTree::potential_at_charges() const {
+    std::vector<double> result(x.size(),0.0);
+    if (tree.empty()) return result;
+    std::vector<double> D;
+    for (std::size_t i=0; i<x.size(); ++i) result[i]=potential(Key<3>(0),x[i],D,i);
+    return result;
+}
+
+
+void PointChargeTree::potential_in_box(const Key<3>& key, const coord_3d& center, const double radius,
+                                       const Vector<double*,3>& xvals, double* fvals, const int npts,
+                                       std::vector<double>& L, std::vector<double>& D) const {
+    const Node& node=tree.find(key)->second;
+    const double dist=(center-node.center).normf();
+    if (dist*theta>node.radius+radius) {
+        local_expansion(node,center,L,D);
+        if (dist-node.radius-radius<rsmooth) {
+            for (int i=0; i<npts; ++i) {
+                const coord_3d r{xvals[0][i],xvals[1][i],xvals[2][i]};
+                fvals[i]+=smoothing_correction(key,r);
+            }
+        }
+    } else if (node.children.empty()) {
+        // the few charges of a leaf are cheaper to sum than to expand
+        for (int i=0; i<npts; ++i) {
+            const coord_3d r{xvals[0][i],xvals[1][i],xvals[2][i]};
+            fvals[i]+=direct(node,r);
+        }
+    } else if (radius>node.radius) {
+        // the target box is larger than the sources: continue point by point
+        for (int i=0; i<npts; ++i) {
+            const coord_3d r{xvals[0][i],xvals[1][i],xvals[2][i]};
+            fvals[i]+=potential(key,r,D,-1);
+        }
+    } else {
+        for (const Key<3>& child : node.children) {
+            potential_in_box(child,center,radius,xvals,fvals,npts,L,D);
+        }
+    }
+}
+
+
+void PointChargeTree::potential_in_box(const coord_3d& lo, const coord_3d& hi,
+                                       const Vector<double*,3>& xvals, double* fvals, const int npts) const {
+    for (int i=0; i<npts; ++i) fvals[i]=0.0;
+    if (tree.empty()) return;
+    const coord_3d center=0.5*(lo+hi);
+    const double radius=0.5*(hi-lo).normf();
+    std::vector<double> L(terms.size(),0.0), D;
+    potential_in_box(Key<3>(0),center,radius,xvals,fvals,npts,L,D);
+
+    // the far field of all accepted boxes in one expansion about the center
+    std::vector<double> px(order+1), py(order+1), pz(order+1);
+    for (int i=0; i<npts; ++i) {
+        px[0]=py[0]=pz[0]=1.0;
+        for (int t=1; t<=order; ++t) {
+            px[t]=px[t-1]*(xvals[0][i]-center[0]);
+            py[t]=py[t-1]*(xvals[1][i]-center[1]);
+            pz[t]=pz[t-1]*(xvals[2][i]-center[2]);
+        }
+        double sum=0.0;
+        for (std::size_t a=0; a<terms.size(); ++a) {
+            const std::array<int,3>& abc=terms[a];
+            sum+=L[a]*px[abc[0]]*py[abc[1]]*pz[abc[2]];
+        }
+        fvals[i]+=sum;
+    }
+}
+
+
+void PointChargePotential::operator()(const Vector<double*,3>& xvals, double* fvals, int npts) const {
+    if (npts==0) return;
+    coord_3d lo, hi;
+    for (int d=0; d<3; ++d) {
+        lo[d]=*std::min_element(xvals[d],xvals[d]+npts);
+        hi[d]=*std::max_element(xvals[d],xvals[d]+npts);
+    }
+    tree->potential_in_box(lo,hi,xvals,fvals,npts);
+}
+
+} // namespace madness
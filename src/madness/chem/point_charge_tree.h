@@ -0,0 +1,171 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+#ifndef MADNESS_CHEM_POINT_CHARGE_TREE_H__INCLUDED
+#define MADNESS_CHEM_POINT_CHARGE_TREE_H__INCLUDED
+
+/// \file point_charge_tree.h
+/// \brief Hierarchical multipole evaluation of the Coulomb potential of many point charges
+
+#include <madness/mra/mra.h>
+#include <madness/mra/key.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace madness {
+
+/// Hierarchical multipole (tree code) evaluation of the potential of point charges
+
+/// The charges are sorted into the octree of the simulation cell, using the
+/// same Key hierarchy as the functions, until a box holds at most
+/// \c leaf_size charges.  Every box carries the Cartesian multipole moments
+/// of its charges up to \c order, built from the children by shifting
+/// their moments (upward pass).  A box is accepted for a target (a point or
+/// a whole box of points) if it is seen under an angle smaller than
+/// \c theta, otherwise its children are visited, and leaves that are too
+/// close are summed directly.  The relative error of an accepted box is of
+/// the order of theta^(order+1).
+///
+/// With \c rcut>0 the charges have the smoothed potential
+/// smoothed_potential(r*rcut)*rcut, as for the nuclei and the PCM surface
+/// charges.  The acceptance criterion is the same; the expansions are those
+/// of 1/r, and the difference to the smoothed potential is added directly
+/// for the charges of an accepted box within the smoothing range.
+class PointChargeTree {
+public:
+    /// @param[in] coords   positions of the charges in user coordinates
+    /// @param[in] charges  the charges
+    /// @param[in] order    highest order of the multipole expansions
+    /// @param[in] theta    opening angle of the acceptance criterion
+    /// @param[in] leaf_size maximum number of charges in a leaf box
+    /// @param[in] rcut     smoothing parameter, 0 for the bare 1/r potential
+    PointChargeTree(const std::vector<coord_3d>& coords, const std::vector<double>& charges,
+                    const int order=10, const double theta=0.35, const long leaf_size=16,
+                    const double rcut=0.0);
+
+    /// The potential at a point
+    double potential(const coord_3d& r) const;
+
+    /// The potential at many points
+    std::vector<double> potential(const std::vector<coord_3d>& r) const;
+
+    /// The potential of all other charges at the position of each charge
+    std::vector<double> potential_at_charges() const;
+
+    /// The potential at points inside the box [lo,hi] with a single traversal of the tree
+
+    /// The box is the target for the acceptance criterion, so the
+    /// interaction list is built once for all points (e.g. the quadrature
+    /// points of a box of a Function), and the far field of all accepted
+    /// boxes is summed into a single Taylor expansion about the box center.
+    void potential_in_box(const coord_3d& lo, const coord_3d& hi,
+                          const Vector<double*,3>& xvals, double* fvals, const int npts) const;
+
+    /// Number of charges
+    std::size_t size() const {return q.size();}
+
+private:
+    struct Node {
+        coord_3d center;                ///< expansion center (box center)
+        double radius;                  ///< largest distance of a charge from the center
+        std::vector<double> moments;    ///< M_tuv = sum q (s-c)^tuv / (t!u!v!)
+        std::vector<long> charges;      ///< indices of the charges in a leaf
+        std::vector<Key<3> > children;  ///< children holding charges
+    };
+
+    std::vector<coord_3d> x;            ///< positions of the charges
+    std::vector<double> q;              ///< the charges
+    int order;
+    double theta;
+    long leaf_size;
+    double rcut;
+    double rsmooth;                     ///< beyond this distance the smoothed potential is 1/r
+    std::vector<std::array<int,3> > terms;  ///< the exponents tuv ordered by t+u+v
+    std::vector<int> index;             ///< index of tuv in terms, (order+1)^3 entries
+    std::map<Key<3>,Node> tree;
+
+    int term_index(int t, int u, int v) const {
+        return index[(t*(order+1)+u)*(order+1)+v];
+    }
+
+    /// Builds the subtree below key with the given charges, returns after the upward pass
+    void build(const Key<3>& key, const std::vector<long>& charges);
+
+    /// The center of a box in user coordinates
+    coord_3d box_center(const Key<3>& key) const;
+
+    /// Derivatives of 1/R, D_tuv = d^(t+u+v)/dx^t dy^u dz^v 1/|R|
+    void derivatives(const coord_3d& R, std::vector<double>& D) const;
+
+    /// Far-field potential of a box at r
+    double expansion(const Node& node, const coord_3d& r, std::vector<double>& D) const;
+
+    /// Adds the far field of a box as a Taylor expansion about center to L
+    void local_expansion(const Node& node, const coord_3d& center,
+                         std::vector<double>& L, std::vector<double>& D) const;
+
+    /// Near-field potential of the charges of a leaf at r, skipping charge \c skip
+    double direct(const Node& node, const coord_3d& r, const long skip=-1) const;
+
+    /// Smoothed minus bare potential at r of the charges below key within the smoothing range
+    double smoothing_correction(const Key<3>& key, const coord_3d& r) const;
+
+    /// Potential at r from the subtree below key, skipping charge \c skip
+    double potential(const Key<3>& key, const coord_3d& r, std::vector<double>& D, const long skip) const;
+
+    /// Accumulates the potential at all points from the subtree below key,
+    /// the far field goes into the Taylor expansion L about center
+    void potential_in_box(const Key<3>& key, const coord_3d& center, const double radius,
+                          const Vector<double*,3>& xvals, double* fvals, const int npts,
+                          std::vector<double>& L, std::vector<double>& D) const;
+};
+
+
+/// The potential of point charges as a functor, evaluated with a PointChargeTree
+
+/// Supports vectorized evaluation, so that all quadrature points of a box
+/// share one traversal of the tree.
+class PointChargePotential : public FunctionFunctorInterface<double,3> {
+    std::shared_ptr<PointChargeTree> tree;
+public:
+    PointChargePotential(const std::shared_ptr<PointChargeTree>& tree) : tree(tree) {}
+
+    double operator()(const coord_3d& r) const {return tree->potential(r);}
+
+    bool supports_vectorized() const {return true;}
+
+    void operator()(const Vector<double*,3>& xvals, double* fvals, int npts) const;
+};
+
+} // namespace madness
+
+#endif // MADNESS_CHEM_POINT_CHARGE_TREE_H__INCLUDED
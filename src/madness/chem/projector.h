@@ -109,22 +109,14 @@ namespace madness {
         /// @param[in] the particle that is projected (1 or 2)
         /// @return the projected function
         real_function_6d operator()(const real_function_6d& f, const size_t particle) const {
-            real_function_6d result = real_factory_6d(f.world());
             MADNESS_ASSERT(particle == 1 or particle == 2);
-            for (size_t i = 0; i < mo_ket_.size(); i++) {
-                real_function_3d tmp1 = mo_ket_[i];
-                real_function_3d tmp2 = f.project_out(mo_bra_[i], particle - 1);
-                real_function_6d tmp12;
-                if (particle == 1) {
-                    tmp12 = CompositeFactory<double, 6, 3>(f.world()).particle1(copy(tmp1)).particle2(copy(tmp2));
-                    tmp12.fill_tree();
-                } else {
-                    tmp12 = CompositeFactory<double, 6, 3>(f.world()).particle1(copy(tmp2)).particle2(copy(tmp1));
-                    tmp12.fill_tree();
-                }
-                result += tmp12;
-            }
-            return result;
+            if (mo_ket_.size()==0) return real_factory_6d(f.world());
+
+            // all <p(particle)|f(1,2)> in one traversal of f, and the sum of
+            // the products |p> <p|f> in one traversal of the result
+            std::vector<real_function_3d> pf = f.project_out(mo_bra_, particle - 1);
+            if (particle == 1) return hartree_product(mo_ket_, pf);
+            return hartree_product(pf, mo_ket_);
         }
 
         template<typename argT>
@@ -278,60 +270,34 @@ namespace madness {
         	const double thresh=FunctionDefaults<2*NDIM>::get_thresh();
         	const double tight_thresh=FunctionDefaults<2*NDIM>::get_thresh()*0.1;
 
-        	// Eq. (A9): g_kl = < k(1) l(2) | f(1,2) >
+        	// Eq. (A10): h2_k = < k(1) | f(1,2) >, all k in one traversal of f
+        	std::vector<Function<T,NDIM> > h2=f.project_out(bra1_,0);
+
+        	// Eq. (A9): g_kl = < k(1) l(2) | f(1,2) > = < h2_k | l >
         	// note no (kl) symmetry here!
-        	Tensor<double> g_kl(bra1_.size(),bra2_.size());
-        	for (size_t k=0; k<bra1_.size(); ++k) {
-        		for (size_t l=0; l<bra2_.size(); ++l) {
-        			Function<T,2*NDIM> kl=CompositeFactory<T,2*NDIM,NDIM>(world)
-    	            		.particle1(copy(bra1_[k])).particle2(copy(bra2_[l]));
-        			g_kl(k,l)=inner(f,kl);
-        		}
-        	}
-//        	if (world.rank()==0) {print(g_kl);};
+        	Tensor<T> g_kl(bra1_.size(),bra2_.size());
+        	if (g_kl.size()>0) g_kl=matrix_inner(world,h2,bra2_);
 
-        	// Eq. (A12)
-        	// project out the mainly first particle: O1 (1 - 1/2 O2)
-        	Function<T,2*NDIM> r1=FunctionFactory<T,2*NDIM>(world).thresh(tight_thresh);
-        	for (size_t k=0; k<bra1_.size(); ++k) {
-
-        		// Eq. (A10)
-        		Function<T,NDIM> h2=f.project_out(bra1_[k],0);
-
-        		// Eq. (A12)
-            	for (size_t l=0; l<ket2_.size(); ++l) {
-            		h2-=0.5*g_kl(k,l)*ket2_[l];
-            	}
-
-            	// Eq. (A7), second term rhs
-            	// the hartree product tends to be inaccurate; tighten threshold
-            	FunctionDefaults<2*NDIM>::set_thresh(tight_thresh);
-            	r1=(r1+hartree_product(ket1_[k],h2));
-            	FunctionDefaults<2*NDIM>::set_thresh(thresh);
-            	r1.set_thresh(thresh);
-            	r1.print_size("r1"+stringify(k));
+        	// Eq. (A11): h1_l = < l(2) | f(1,2) >
+        	std::vector<Function<T,NDIM> > h1=f.project_out(bra2_,1);
+
+        	// Eq. (A12), (A13)
+        	if (g_kl.size()>0) {
+        		h2=h2-0.5*transform(world,ket2_,transpose(g_kl));
+        		h1=h1-0.5*transform(world,ket1_,g_kl);			// ordering g(k,l) is correct
         	}
 
-        	// project out the mainly second particle: O2 (1 - 1/2 O1)
+        	// Eq. (A7), second and third term rhs, each as a single sum of
+        	// hartree products: O1 (1 - 1/2 O2) and O2 (1 - 1/2 O1)
+        	// the hartree product tends to be inaccurate; tighten threshold
+        	Function<T,2*NDIM> r1=FunctionFactory<T,2*NDIM>(world).thresh(tight_thresh);
         	Function<T,2*NDIM> r2=FunctionFactory<T,2*NDIM>(world).thresh(tight_thresh);
-        	for (size_t l=0; l<ket2_.size(); ++l) {
-
-        		// Eq. (A11)
-        		Function<T,NDIM> h1=f.project_out(bra2_[l],1);
-
-        		// Eq. (A13)
-            	for (size_t k=0; k<ket1_.size(); ++k) {
-            		h1-=0.5*g_kl(k,l)*ket1_[k];			// ordering g(k,l) is correct
-            	}
-
-            	// Eq. (A7), third term rhs
-            	// the hartree product tends to be inaccurate; tighten threshold
-            	FunctionDefaults<2*NDIM>::set_thresh(tight_thresh);
-            	r2=(r2+hartree_product(h1,ket2_[l]));
-            	r2.set_thresh(thresh);
-            	FunctionDefaults<2*NDIM>::set_thresh(thresh);
-            	r2.print_size("r2"+stringify(l));
-        	}
+        	FunctionDefaults<2*NDIM>::set_thresh(tight_thresh);
+        	if (ket1_.size()>0) r1=hartree_product(ket1_,h2);
+        	if (ket2_.size()>0) r2=hartree_product(h1,ket2_);
+        	FunctionDefaults<2*NDIM>::set_thresh(thresh);
+        	r1.set_thresh(thresh);
+        	r2.set_thresh(thresh);
         	FunctionDefaults<2*NDIM>::set_thresh(tight_thresh);
         	Function<T,2*NDIM> result=(f-r1-r2).truncate().reduce_rank();
         	FunctionDefaults<2*NDIM>::set_thresh(thresh);
@@ -605,6 +605,24 @@ int test_projector(World& world, std::shared_ptr<NuclearCorrelationFactor> ncf,
     }
     timer.reset();
 
+    // the fused 6D projector against projecting out one orbital at a time
+    {
+        for (int particle : {1,2}) {
+            real_function_6d ref = real_factory_6d(world);
+            for (const auto& oi : o) {
+                real_function_3d h = f.project_out(oi, particle - 1);
+                real_function_6d tmp = (particle == 1)
+                        ? real_function_6d(CompositeFactory<double, 6, 3>(world).particle1(copy(oi)).particle2(copy(h)))
+                        : real_function_6d(CompositeFactory<double, 6, 3>(world).particle1(copy(h)).particle2(copy(oi)));
+                tmp.fill_tree();
+                ref += tmp;
+            }
+            double err = (O(f, particle) - ref).norm2();
+            print("fused projector error for particle", particle, err);
+            t1.checkpoint(err < FunctionDefaults<3>::get_thresh(), "fused projector with particle " + std::to_string(particle), timer.reset());
+        }
+    }
+
 
     // test {O,Q} with particles 1,2 on all three CCPairFunction types
     {
@@ -658,6 +676,65 @@ int test_projector(World& world, std::shared_ptr<NuclearCorrelationFactor> ncf,
     return  (t1.get_final_success()) ? 0 : 1;
 }
 
+/// apply the SO projector to a plain 6D function
+
+/// works with full-rank 6D functions, so it runs without ENABLE_GENTENSOR
+int test_projector_6d(World& world) {
+    test_output t1("StrongOrthogonalityProjector on a 6D function");
+    t1.set_cout_to_logger();
+
+    const double thresh3=FunctionDefaults<3>::get_thresh();
+    const double thresh6=FunctionDefaults<6>::get_thresh();
+    const int k6=FunctionDefaults<6>::get_k();
+    FunctionDefaults<6>::set_thresh(1.e-3);
+    FunctionDefaults<6>::set_k(5);
+    const double thresh=FunctionDefaults<6>::get_thresh();
+
+    auto g1 = [](const coord_3d& r) { return exp(-1.0 * inner(r, r)); };
+    auto g2 = [](const coord_3d& r) { return exp(-2.0 * inner(r, r)); };
+    auto g = [](const coord_6d& r) {
+        double r1=r[0]*r[0] + r[1]*r[1] + r[2]*r[2];
+        double r2=r[3]*r[3] + r[4]*r[4] + r[5]*r[5];
+        return exp(-1.0*r1 - 2.0*r2);
+    };
+    real_function_3d f1=real_factory_3d(world).f(g1);
+    real_function_3d f2=real_factory_3d(world).f(g2);
+    real_function_6d f=real_factory_6d(world).f(g);
+    std::vector<real_function_3d> o=orthonormalize_cd<double,3>({f1,f2});
+
+    // the same orbital several times must give the same result as one at a time
+    {
+        std::vector<real_function_3d> oo={o[0],o[1],o[0]};
+        for (int particle : {0,1}) {
+            std::vector<real_function_3d> pf=f.project_out(oo,particle);
+            double err=0.0;
+            for (std::size_t i=0; i<oo.size(); ++i) err+=(pf[i]-f.project_out(oo[i],particle)).norm2();
+            print("project_out with duplicates, particle",particle,err);
+            t1.checkpoint(err<thresh3,"project_out with duplicate orbitals on particle "+std::to_string(particle));
+        }
+    }
+
+    // Q12 f must be orthogonal to the occupied space of both particles
+    {
+        StrongOrthogonalityProjector<double,3> Q12(world);
+        Q12.set_spaces(o);
+        real_function_6d qf=Q12(f);
+        for (int particle : {0,1}) {
+            double ovlp=norm2(world,qf.project_out(o,particle));
+            print("<o | Q12 f> for particle",particle,ovlp);
+            t1.checkpoint(ovlp<10.0*thresh,"Q12 f orthogonal to particle "+std::to_string(particle));
+        }
+        // Q12 is idempotent
+        double err=(Q12(qf)-qf).norm2();
+        print("idempotency error of Q12",err);
+        t1.checkpoint(err<10.0*thresh,"Q12 idempotency");
+    }
+
+    FunctionDefaults<6>::set_thresh(thresh6);
+    FunctionDefaults<6>::set_k(k6);
+    return t1.end();
+}
+
 int test_dirac_convolution(World& world, std::shared_ptr<NuclearCorrelationFactor> ncf, const Molecule& molecule,
                            const CCParameters& parameter) {
     int success=0;
@@ -721,6 +798,7 @@ int main(int argc, char **argv) {
 #else
     print("could not run test_ccpairfunction: U need to compile with ENABLE_GENTENSOR=1");
 #endif
+    isuccess+=test_projector_6d(world);
     finalize();
 
     return isuccess;
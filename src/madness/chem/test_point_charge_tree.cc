@@ -0,0 +1,158 @@
+/*
+ * test_point_charge_tree.cc
+ *
+ * compare the hierarchical multipole potential of point charges with direct sums
+ */
+
+#include <madness/mra/mra.h>
+#include <madness/chem/point_charge_tree.h>
+#include <madness/chem/atomutil.h>
+#include <madness/world/test_utilities.h>
+
+using namespace madness;
+
+/// random charges of alternating sign in a cube of edge length 2L around the origin
+void make_charges(const long n, const double L, std::vector<coord_3d>& x, std::vector<double>& q) {
+    x.resize(n);
+    q.resize(n);
+    for (long i=0; i<n; ++i) {
+        for (int d=0; d<3; ++d) x[i][d]=L*(2.0*RandomValue<double>()-1.0);
+        q[i]=(i%2) ? -RandomValue<double>() : RandomValue<double>();
+    }
+}
+
+double direct_sum(const std::vector<coord_3d>& x, const std::vector<double>& q,
+                  const coord_3d& r, const double rcut, const long skip=-1, const bool absolute=false) {
+    double sum=0.0;
+    for (std::size_t i=0; i<x.size(); ++i) {
+        if (long(i)==skip) continue;
+        const double rr=(r-x[i]).normf();
+        const double qi=absolute ? std::abs(q[i]) : q[i];
+        sum+= (rcut>0.0) ? qi*smoothed_potential(rr*rcut)*rcut : qi/rr;
+    }
+    return sum;
+}
+
+int test_points(World& world, const double rcut) {
+    test_output test("point charge tree at points, rcut= "+std::to_string(rcut));
+
+    std::vector<coord_3d> x;
+    std::vector<double> q;
+    make_charges(4000,8.0,x,q);
+    PointChargeTree tree(x,q,10,0.35,16,rcut);
+
+    // arbitrary points
+    std::vector<coord_3d> r(200);
+    for (auto& ri : r) for (int d=0; d<3; ++d) ri[d]=10.0*(2.0*RandomValue<double>()-1.0);
+    std::vector<double> v=tree.potential(r);
+    double err=0.0, vmax=0.0;
+    for (std::size_t i=0; i<r.size(); ++i) {
+        const double ref=direct_sum(x,q,r[i],rcut);
+        err=std::max(err,std::abs(v[i]-ref));
+        vmax=std::max(vmax,direct_sum(x,q,r[i],rcut,-1,true));
+    }
+    test.logger << "max error at points " << err << " max potential of |q| " << vmax << std::endl;
+    bool success=err<1.e-6*vmax;
+
+    // at the charges themselves, excluding the self interaction
+    std::vector<double> vq=tree.potential_at_charges();
+    err=0.0;
+    for (std::size_t i=0; i<x.size(); i+=20) {
+        const double ref=direct_sum(x,q,x[i],rcut,i);
+        err=std::max(err,std::abs(vq[i]-ref));
+    }
+    test.logger << "max error at charges " << err << std::endl;
+    success=success and err<1.e-6*vmax;
+
+    return test.end(success);
+}
+
+/// charges on a sphere of radius R around the origin, like the surface charges of a cavity
+void make_surface_charges(const long n, const double R, std::vector<coord_3d>& x, std::vector<double>& q) {
+    x.resize(n);
+    q.resize(n);
+    const double golden=constants::pi*(3.0-std::sqrt(5.0));
+    for (long i=0; i<n; ++i) {
+        const double z=1.0-(2.0*i+1.0)/n;
+        const double rho=std::sqrt(1.0-z*z);
+        x[i]={R*rho*std::cos(golden*i),R*rho*std::sin(golden*i),R*z};
+        q[i]=(z+0.2*(2.0*RandomValue<double>()-1.0))*10.0/n;
+    }
+}
+
+/// the tree against the direct sum for the quadrature points of boxes, as in
+/// the projection of the potential of the surface charges in PCM
+int test_surface_charges(World& world) {
+    test_output test("point charge tree for surface charges in boxes");
+
+    std::vector<coord_3d> x;
+    std::vector<double> q;
+    make_surface_charges(2000,6.0,x,q);
+    const double rcut=3.0;
+    PointChargePotential pot(std::make_shared<PointChargeTree>(x,q,10,0.35,16,rcut));
+
+    const int nbox=10, npts=512;
+    std::vector<double> xv(3*npts), ftree(npts), fdirect(npts);
+    Vector<double*,3> xvals{&xv[0],&xv[npts],&xv[2*npts]};
+    double ttree=0.0, tdirect=0.0, err=0.0, vmax=0.0;
+    for (int ibox=0; ibox<nbox; ++ibox) {
+        coord_3d lo;
+        for (int d=0; d<3; ++d) lo[d]=6.0*(2.0*RandomValue<double>()-1.0);
+        for (int i=0; i<npts; ++i) {
+            for (int d=0; d<3; ++d) xvals[d][i]=lo[d]+0.3*RandomValue<double>();
+        }
+        double time0=wall_time();
+        pot(xvals,&ftree[0],npts);
+        ttree+=wall_time()-time0;
+        time0=wall_time();
+        for (int i=0; i<npts; ++i) fdirect[i]=direct_sum(x,q,coord_3d{xvals[0][i],xvals[1][i],xvals[2][i]},rcut);
+        tdirect+=wall_time()-time0;
+        for (int i=0; i<npts; ++i) err=std::max(err,std::abs(ftree[i]-fdirect[i]));
+        vmax=std::max(vmax,direct_sum(x,q,lo,rcut,-1,true));
+    }
+    test.logger << "max error in boxes " << err << " max potential of |q| " << vmax << std::endl;
+    test.logger << "time tree " << ttree << "s, direct " << tdirect << "s" << std::endl;
+    bool success=err<1.e-6*vmax and ttree<tdirect;
+    return test.end(success);
+}
+
+int test_function(World& world) {
+    test_output test("point charge tree projected onto a function");
+
+    std::vector<coord_3d> x;
+    std::vector<double> q;
+    make_charges(50,5.0,x,q);
+    const double rcut=2.0;
+    const double thresh=1.e-4;
+    std::shared_ptr<PointChargeTree> tree(new PointChargeTree(x,q,10,0.35,16,rcut));
+    std::shared_ptr<FunctionFunctorInterface<double,3> > pot(new PointChargePotential(tree));
+    real_function_3d v=real_factory_3d(world).functor(pot).thresh(thresh);
+
+    double err=0.0;
+    for (int i=0; i<20; ++i) {
+        coord_3d r;
+        for (int d=0; d<3; ++d) r[d]=6.0*(2.0*RandomValue<double>()-1.0);
+        err=std::max(err,std::abs(v(r)-direct_sum(x,q,r,rcut)));
+    }
+    test.logger << "max error of the function " << err << std::endl;
+    bool success=err<1.e2*thresh;
+    return test.end(success);
+}
+
+int main(int argc, char** argv) {
+    World& world=initialize(argc, argv);
+    startup(world,argc,argv);
+    FunctionDefaults<3>::set_cubic_cell(-20.0,20.0);
+    FunctionDefaults<3>::set_k(8);
+    FunctionDefaults<3>::set_thresh(1.e-5);
+
+    int result=0;
+    result+=test_points(world,0.0);
+    result+=test_points(world,2.0);
+    result+=test_function(world);
+    result+=test_surface_charges(world);
+
+    print("result",result);
+    finalize();
+    return result;
+}
@@ -97,6 +97,8 @@ protected:
 
     bool spin_polarized;        ///< True if the functional is spin polarized
     double hf_coeff;            ///< Factor multiplying HF exchange (+1.0 gives HF)
+    double hf_sr_coeff;         ///< Factor multiplying short-range (erfc-attenuated) HF exchange
+    double hf_omega;            ///< Range-separation parameter of the short-range HF exchange
     double rhomin, rhotol;      ///< See initialize and munge*
     double ggatol;              ///< See initialize and munge*
 
@@ -257,6 +259,30 @@ public:
         return hf_coeff;
     }
 
+    /// Returns the coefficient of the short-range hf exact exchange
+
+    /// Range-separated hybrids use the exact exchange kernel
+    /// \f$ \alpha/r + \beta\,\mathrm{erfc}(\omega r)/r \f$ (libxc convention), with
+    /// \f$ \alpha \f$ given by hf_exchange_coefficient, \f$ \beta \f$ by this
+    /// function and \f$ \omega \f$ by hf_exchange_omega. E.g. HSE06 has
+    /// \f$ \alpha=0 \f$, so its exact exchange is short-ranged only.
+    double hf_exchange_sr_coefficient() const
+    {
+        return hf_sr_coeff;
+    }
+
+    /// Returns the range-separation parameter of the short-range hf exact exchange
+    double hf_exchange_omega() const
+    {
+        return hf_omega;
+    }
+
+    /// Returns true if there is any hf exact exchange, full-range or short-range
+    bool has_hf_exchange() const
+    {
+        return (hf_coeff != 0.0) or (hf_sr_coeff != 0.0);
+    }
+
     /// Computes the energy functional at given points
 
     /// This uses the convention that the total energy is
@@ -362,6 +388,9 @@ struct xc_functional {
 
     xc_functional(const XCfunctional& xc) : xc(&xc) {}
 
+    /// the values of many boxes may be passed at once, cf FunctionImpl::multiop_values
+    bool pointwise() const {return true;}
+
     madness::Tensor<double> operator()(const madness::Key<3> & key,
             const std::vector< madness::Tensor<double> >& t) const {
         MADNESS_ASSERT(xc);
@@ -378,6 +407,9 @@ struct xc_potential {
     xc_potential(const XCfunctional& xc, int ispin) : xc(&xc), ispin(ispin)
     {}
 
+    /// the values of many boxes may be passed at once, cf FunctionImpl::multi_to_multi_op_values
+    bool pointwise() const {return true;}
+
     std::size_t get_result_size() const {
         // local terms, same spin
         if (xc->is_lda()) return 1;
@@ -410,6 +442,9 @@ struct xc_kernel_apply {
         MADNESS_ASSERT(ispin==0);   // closed shell only!
     }
 
+    /// the values of many boxes may be passed at once, cf FunctionImpl::multi_to_multi_op_values
+    bool pointwise() const {return true;}
+
     std::size_t get_result_size() const {
         // all spin-restricted
         if (xc->is_gga()) return 4; // local terms,  3x semilocal terms (x,y,z)
@@ -16,7 +16,7 @@ int c_rks_vwn5__(const double *r__, double *f, double * dfdra);
 int x_uks_s__(double *ra, double *rb, double *f, double *dfdra, double *dfdrb);
 int c_uks_vwn5__(double *ra, double *rb, double *f, double *dfdra, double *dfdrb);
 
-XCfunctional::XCfunctional() : hf_coeff(0.0) {
+XCfunctional::XCfunctional() : hf_coeff(0.0), hf_sr_coeff(0.0), hf_omega(0.0) {
     rhotol=1e-7; rhomin=1e-12; // default values
 }
 
@@ -25,6 +25,8 @@ void XCfunctional::initialize(const std::string& input_line, bool polarized,
     rhotol=1e-7; rhomin=1e-12; // default values
 
     spin_polarized = polarized;
+    hf_sr_coeff = 0.0;
+    hf_omega = 0.0;
 
     std::stringstream s(input_line);
     std::string token;
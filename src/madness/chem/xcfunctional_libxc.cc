@@ -54,7 +54,7 @@ static xc_func_type* lookup_func(const std::string& name, bool polarized) {
 
 //XCfunctional::XCfunctional() {}
 //XCfunctional::XCfunctional() : hf_coeff(0.0) {std::printf("Construct XC Functional from LIBXC Library");}
-XCfunctional::XCfunctional() : hf_coeff(0.0) {
+XCfunctional::XCfunctional() : hf_coeff(0.0), hf_sr_coeff(0.0), hf_omega(0.0) {
     rhotol=1e-7; rhomin=0.0;
     ggatol=1.e-4;
     nderiv=0;
@@ -76,8 +76,20 @@ void XCfunctional::initialize(const std::string& input_line, bool polarized,
 
     nderiv = 0;
     hf_coeff = 0.0;
+    hf_sr_coeff = 0.0;
+    hf_omega = 0.0;
     funcs.clear();
 
+    // exact exchange of a range-separated hybrid, in the libxc convention
+    // alpha/r + beta erfc(omega r)/r
+    auto add_cam_exchange = [this](const xc_func_type* func) {
+        double omega = 0.0, alpha = 0.0, beta = 0.0;
+        xc_hyb_cam_coef(func, &omega, &alpha, &beta);
+        hf_coeff = alpha;
+        hf_sr_coeff = beta;
+        hf_omega = omega;
+    };
+
     if (printit) print("\nConstruct XC Functional from LIBXC Library");
     while (line >> name) {
         std::transform(name.begin(), name.end(), name.begin(), ::toupper);
@@ -100,6 +112,18 @@ void XCfunctional::initialize(const std::string& input_line, bool polarized,
             // VWN-3 correlation
             funcs.push_back(std::make_pair(lookup_func("HYB_GGA_XC_B3LYP",polarized),1.0));
             hf_coeff=0.2;
+        } else if (name == "HSE06") {
+            // short-range exact exchange only
+            funcs.push_back(std::make_pair(lookup_func("HYB_GGA_XC_HSE06",polarized),1.0));
+            add_cam_exchange(funcs.back().first);
+        } else if (name == "CAM-B3LYP" or name == "CAMB3LYP") {
+            funcs.push_back(std::make_pair(lookup_func("HYB_GGA_XC_CAM_B3LYP",polarized),1.0));
+            add_cam_exchange(funcs.back().first);
+        } else if (name == "HF_SR") {
+            if (! (line >> factor)) factor = 1.0;
+            hf_sr_coeff = factor;
+        } else if (name == "HF_OMEGA") {
+            line >> hf_omega;
         } else if (name == "RHOMIN") {
             line >> rhomin;
         } else if (name == "RHOTOL") {
@@ -115,6 +139,9 @@ void XCfunctional::initialize(const std::string& input_line, bool polarized,
         }
     }
 
+    if (hf_sr_coeff!=0.0 and hf_omega<=0.0)
+        throw "XCfunctional::initialize() -- short-range HF exchange requires HF_OMEGA > 0";
+
     for (unsigned int i=0; i<funcs.size(); i++) {
         if (funcs[i].first->info->family == XC_FAMILY_GGA) nderiv = std::max(nderiv,1);
         if (funcs[i].first->info->family == XC_FAMILY_HYB_GGA) nderiv = std::max(nderiv,1);
@@ -129,6 +156,7 @@ void XCfunctional::initialize(const std::string& input_line, bool polarized,
             printf(" %4.3f %s \n",funcs[i].second,lookup_id(id).c_str());
         }
         if (hf_coeff>0.0) printf(" %4.3f %s \n",hf_coeff,"HF exchange");
+        if (hf_sr_coeff!=0.0) printf(" %4.3f %s %4.3f\n",hf_sr_coeff,"short-range HF exchange, omega",hf_omega);
         print("\nscreening parameters");
         print(" rhotol, rhomin",rhotol,rhomin);
         print("         ggatol",ggatol);
@@ -379,10 +407,11 @@ madness::Tensor<double> XCfunctional::exc(const std::vector< madness::Tensor<dou
     double * MADNESS_RESTRICT res = result.ptr();
     for (long j=0; j<np; j++) res[j] = 0.0;
 
-    for (unsigned int i=0; i<funcs.size(); i++) {
-        madness::Tensor<double> zk(3L, t[0].dims(), false);
-        double * MADNESS_RESTRICT work = zk.ptr();
+    // scratch for all functional terms
+    madness::Tensor<double> zk(3L, t[0].dims(), false);
+    double * MADNESS_RESTRICT work = zk.ptr();
 
+    for (unsigned int i=0; i<funcs.size(); i++) {
         switch(funcs[i].first->info->family) {
         case XC_FAMILY_LDA:
             xc_lda_exc(funcs[i].first, np, dens, work);
@@ -443,10 +472,11 @@ std::vector<madness::Tensor<double> > XCfunctional::vxc(
     if (is_gga() and (is_spin_polarized())) result_size= 7;
     MADNESS_ASSERT(result_size>0);
 
-    Tensor<double> r(3L, t[0].dims());
-    r=0.0;
     std::vector<Tensor<double> > result(result_size);
-    for (Tensor<double>& rr : result) rr=copy(r);
+    for (Tensor<double>& rr : result) rr=Tensor<double>(3L, t[0].dims());
+
+    // scratch for all functional terms
+    madness::Tensor<double> vrho(nvrho*np), vsig(nvsig*np);
 
     const double * MADNESS_RESTRICT dens = rho.ptr();   // nspin * np
     const double * MADNESS_RESTRICT ddensx = drho[0].ptr();  // nspin * np
@@ -457,7 +487,6 @@ std::vector<madness::Tensor<double> > XCfunctional::vxc(
         switch(funcs[i].first->info->family) {
         case XC_FAMILY_LDA:
         {
-            madness::Tensor<double> vrho(nvrho*np);
             double * MADNESS_RESTRICT vr = vrho.ptr();
             xc_lda_vxc(funcs[i].first, np, dens, vr);
             double * MADNESS_RESTRICT r0 = result[0].ptr();
@@ -470,7 +499,6 @@ std::vector<madness::Tensor<double> > XCfunctional::vxc(
         case XC_FAMILY_HYB_GGA:
         case XC_FAMILY_GGA:
         {
-            madness::Tensor<double> vrho(nvrho*np), vsig(nvsig*np);
             double * MADNESS_RESTRICT vr = vrho.ptr();
             double * MADNESS_RESTRICT vs = vsig.ptr();
             const double * MADNESS_RESTRICT sig = sigma.ptr();
@@ -576,10 +604,9 @@ std::vector<madness::Tensor<double> > XCfunctional::fxc_apply(
     Tensor<double> vsigma(nspin2*np);       // gga
 
     // result tensor
-    Tensor<double> r(3L, t[0].dims());
     int result_size= this->is_gga() ? 4 : 1;
     std::vector<Tensor<double> > result(result_size);
-    for (Tensor<double>& rr : result) rr=copy(r);
+    for (Tensor<double>& rr : result) rr=Tensor<double>(3L, t[0].dims());
 
     for (unsigned int i=0; i<funcs.size(); i++) {
         switch(funcs[i].first->info->family) {
@@ -32,9 +32,14 @@
 #ifndef MADNESS_DERIVATIVE_H__INCLUDED
 #define MADNESS_DERIVATIVE_H__INCLUDED
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <vector>
 #include <madness/world/MADworld.h>
 #include <madness/world/worlddc.h>
 #include <madness/world/print.h>
@@ -59,6 +64,9 @@ namespace madness {
     template<typename T, std::size_t NDIM>
     class Function;
 
+    template<typename T, std::size_t NDIM>
+    class DerivativeHalo;
+
 }
 
 
@@ -90,7 +98,50 @@ namespace madness {
         typedef Function<T,NDIM>        functionT;
         typedef WorldContainer<Key<NDIM> , FunctionNode<T, NDIM> > dcT;
         typedef FunctionNode<T,NDIM> nodeT;
+        typedef DerivativeHalo<T,NDIM> haloT;
+
+    private:
+        typedef std::map<uniqueidT, std::weak_ptr<const haloT> > halomapT;
+
+        /// Halos of the derivatives in progress, by id of the result function
+
+        /// Every derivative writes a new result function, so a halo is never
+        /// used for a later derivative of f, e.g. after f was updated in
+        /// place.  Held weakly: a halo that went out of scope simply falls
+        /// back to the node-by-node lookup in find_neighbor.  The map is
+        /// replaced instead of modified, so that find_neighbor reads it
+        /// without locking.
+        mutable std::shared_ptr<const halomapT> halos;
+        mutable Mutex halo_mutex;       ///< serializes bind_halo and unbind_halo
+
+        void bind_halo(const implT* df, const std::shared_ptr<const haloT>& halo) const {
+            ScopedMutex<Mutex> obolus(halo_mutex);
+            std::shared_ptr<halomapT> newhalos(new halomapT);
+            if (std::shared_ptr<const halomapT> old=std::atomic_load(&halos)) {
+                for (const auto& h : *old) if (not h.second.expired()) newhalos->insert(h);
+            }
+            (*newhalos)[df->id()]=halo;
+            std::atomic_store(&halos, std::shared_ptr<const halomapT>(newhalos));
+        }
 
+        void unbind_halo(const implT* df) const {
+            ScopedMutex<Mutex> obolus(halo_mutex);
+            std::shared_ptr<const halomapT> old=std::atomic_load(&halos);
+            if (not old or old->count(df->id())==0) return;
+            std::shared_ptr<halomapT> newhalos(new halomapT(*old));
+            newhalos->erase(df->id());
+            std::atomic_store(&halos, std::shared_ptr<const halomapT>(newhalos));
+        }
+
+        std::shared_ptr<const haloT> get_halo(const implT* df) const {
+            std::shared_ptr<const halomapT> current=std::atomic_load(&halos);
+            if (not current) return std::shared_ptr<const haloT>();
+            auto it=current->find(df->id());
+            if (it==current->end()) return std::shared_ptr<const haloT>();
+            return it->second.lock();
+        }
+
+    public:
 
         DerivativeBase(World& world, std::size_t axis, int k, BoundaryConditions<NDIM> bc)
             : WorldObject< DerivativeBase<T, NDIM> >(world)
@@ -117,12 +168,12 @@ namespace madness {
             if (owner == world.rank()) {
                 if (!left.second.has_data()) {
                     woT::task(owner, &madness::DerivativeBase<T,NDIM>::do_diff1,
-                            f, df, key, find_neighbor(f, key,-1), center, right,
+                            f, df, key, find_neighbor(f, df, key,-1), center, right,
                             TaskAttributes::hipri());
                 }
                 else if (!right.second.has_data()) {
                     woT::task(owner, &madness::DerivativeBase<T,NDIM>::do_diff1,
-                            f, df, key, left, center, find_neighbor(f, key,1),
+                            f, df, key, left, center, find_neighbor(f, df, key,1),
                             TaskAttributes::hipri());
                 }
                 // Boundary node
@@ -182,7 +233,8 @@ namespace madness {
 
         /// Differentiate w.r.t. given coordinate (x=0, y=1, ...) with optional fence
 
-        /// Returns a new function with the same distribution
+        /// Returns a new function with the same distribution.  With fence the
+        /// neighbor coefficients are gathered up front in a DerivativeHalo.
         Function<T,NDIM>
         operator()(const functionT& f, bool fence=true) const {
             if (VERIFY_TREE) f.verify_tree();
@@ -196,6 +248,8 @@ namespace madness {
                 }
             }
 
+            if (fence) return (*this)(f, make_halo(f, std::vector<std::size_t>(1,axis)), fence);
+
             functionT df;
             df.set_impl(f,false);
 
@@ -203,6 +257,38 @@ namespace madness {
             return df;
         }
 
+        /// Gather the neighbor coefficients of f for the derivatives along the given axes
+
+        /// Uses the boundary conditions of this operator; without axes all NDIM
+        /// axes are gathered.  Collective, f must be reconstructed.
+        std::shared_ptr<const haloT>
+        make_halo(const functionT& f, std::vector<std::size_t> axes=std::vector<std::size_t>()) const {
+            MADNESS_CHECK(not f.is_compressed());
+            if (axes.empty()) for (std::size_t d=0; d<NDIM; ++d) axes.push_back(d);
+            return std::make_shared<const haloT>(f.get_impl().get(), axes, bc);
+        }
+
+        /// Differentiate using neighbor coefficients gathered in advance
+
+        /// The halo must have been built for f and this axis; it may be shared
+        /// between the derivatives along all of its axes.  The caller keeps the
+        /// halo alive until the next fence, otherwise the remaining neighbors
+        /// are fetched node by node.
+        Function<T,NDIM>
+        operator()(const functionT& f, const std::shared_ptr<const haloT>& halo, bool fence=true) const {
+            if (VERIFY_TREE) f.verify_tree();
+            MADNESS_CHECK(not f.is_compressed());
+            MADNESS_CHECK(halo and halo->id()==f.get_impl()->id() and halo->has_axis(axis));
+
+            functionT df;
+            df.set_impl(f,false);
+
+            bind_halo(df.get_impl().get(), halo);
+            df.get_impl()->diff(this, f.get_impl().get(), fence);
+            if (fence) unbind_halo(df.get_impl().get());
+            return df;
+        }
+
 
         static bool enforce_bc(int bc_left, int bc_right, Level n, Translation& l) {
             Translation two2n = 1ul << n;
@@ -233,7 +319,8 @@ namespace madness {
             return true;
         }
 
-        Key<NDIM> neighbor(const keyT& key, int step) const {
+        static Key<NDIM> neighbor(const keyT& key, std::size_t axis, int step,
+                                  const BoundaryConditions<NDIM>& bc) {
             Vector<Translation,NDIM> l = key.translation();
             l[axis] += step;
             if (!enforce_bc(bc(axis,0), bc(axis,1), key.level(), l[axis])) {
@@ -244,13 +331,21 @@ namespace madness {
             }
         }
 
+        Key<NDIM> neighbor(const keyT& key, int step) const {
+            return neighbor(key, axis, step, bc);
+        }
+
+        /// The neighbor of key in f, for the derivative written to df
         Future<argT>
-        find_neighbor(const implT* f, const Key<NDIM>& key, int step) const {
+        find_neighbor(const implT* f, const implT* df, const Key<NDIM>& key, int step) const {
             keyT neigh = neighbor(key, step);
             if (neigh.is_invalid()) {
                 return Future<argT>(argT(neigh,coeffT(vk,f->get_tensor_args()))); // Zero bc
             }
             else {
+                if (std::shared_ptr<const haloT> halo=get_halo(df)) {
+                    if (const argT* found=halo->find(neigh)) return Future<argT>(*found);
+                }
                 Future<argT> result;
 		if (f->get_coeffs().is_local(neigh))
 		  f->send(f->get_coeffs().owner(neigh), &implT::sock_it_to_me, neigh, result.remote_ref(world));
@@ -268,6 +363,167 @@ namespace madness {
     };  // End of the DerivativeBase class
 
 
+    /// Neighbor coefficients of the local leaves, gathered in bulk for DerivativeBase
+
+    /// The tree walk of find_neighbor sends one message per neighbor and
+    /// level.  The halo instead collects, on each process, all neighbor keys
+    /// the local leaves need along the requested axes, and resolves them in
+    /// rounds with one aggregated request per owner: keys that do not exist
+    /// are retried at their parent, interior neighbors add the neighbors of
+    /// the children do_diff1 will descend into.  Construction is local to
+    /// each process and needs no fence.
+    ///
+    /// One halo serves the derivatives along all of its axes, and the
+    /// rebinding constructor refetches the coefficients for another function
+    /// with the same tree in a single round.
+    /// \ingroup mra
+    template <typename T, std::size_t NDIM>
+    class DerivativeHalo {
+    public:
+        typedef GenTensor<T>            coeffT   ;
+        typedef Key<NDIM>               keyT     ;
+        typedef std::pair<keyT,coeffT>  argT     ;
+        typedef FunctionImpl<T,NDIM>    implT    ;
+        typedef DerivativeBase<T,NDIM>  derivT   ;
+
+    private:
+        uniqueidT fid;                      ///< id of the function the halo belongs to
+        std::vector<std::size_t> axes;      ///< axes the halo was gathered for
+        std::map<keyT,argT> nodes;          ///< neighbor key -> (key of the node found,coeff)
+        std::size_t nround=0;               ///< number of exchange rounds
+        std::size_t nrequest=0;             ///< number of aggregated requests
+
+        /// a neighbor key, and the leaf and direction that asked for it
+        struct requestT {
+            keyT neigh, origin;
+            std::size_t axis;
+            int step;
+        };
+        typedef std::map<keyT, std::vector<requestT> > pendingT;
+
+        /// issue one find_nodes per owner; the replies are in the order of the keys
+        std::vector< std::pair< std::vector<keyT>, Future< std::vector<argT> > > >
+        exchange(const implT* f, const std::vector<keyT>& keys) {
+            std::map<ProcessID, std::vector<keyT> > byowner;
+            for (const keyT& key : keys) byowner[f->get_coeffs().owner(key)].push_back(key);
+
+            std::vector< std::pair< std::vector<keyT>, Future< std::vector<argT> > > > replies;
+            const ProcessID me=f->world.rank();
+            for (auto& [owner, k] : byowner) {
+                if (owner==me) replies.emplace_back(k, Future< std::vector<argT> >(f->find_nodes(k)));
+                else replies.emplace_back(k, f->task(owner, &implT::find_nodes, k, TaskAttributes::hipri()));
+            }
+            ++nround;
+            nrequest+=replies.size();
+            return replies;
+        }
+
+    public:
+        /// Gather the neighbors of the local leaves of f along the given axes
+        DerivativeHalo(const implT* f, const std::vector<std::size_t>& axes,
+                       const BoundaryConditions<NDIM>& bc)
+            : fid(f->id()), axes(axes) {
+
+            pendingT pending;
+            auto add = [&] (pendingT& p, const keyT& origin, const std::size_t axis, const int step) {
+                keyT neigh=derivT::neighbor(origin, axis, step, bc);
+                if (neigh.is_valid() and (nodes.find(neigh)==nodes.end()))
+                    p[neigh].push_back(requestT{neigh, origin, axis, step});
+            };
+
+            for (auto it=f->get_coeffs().begin(); it!=f->get_coeffs().end(); ++it) {
+                if (not it->second.has_coeff()) continue;
+                for (std::size_t axis : axes) {
+                    MADNESS_CHECK(axis<NDIM);
+                    add(pending, it->first, axis, -1);
+                    add(pending, it->first, axis, 1);
+                }
+            }
+
+            while (not pending.empty()) {
+                std::vector<keyT> keys;
+                keys.reserve(pending.size());
+                for (const auto& p : pending) keys.push_back(p.first);
+
+                pendingT next;
+                for (auto& [k, reply] : exchange(f, keys)) {
+                    const std::vector<argT>& found=reply.get();
+                    MADNESS_ASSERT(found.size()==k.size());
+                    for (std::size_t i=0; i<k.size(); ++i) {
+                        const std::vector<requestT>& requests=pending[k[i]];
+                        if (found[i].first.is_invalid()) {
+                            // not in the tree: the parent is the leaf covering it
+                            MADNESS_ASSERT(k[i].level()>0);
+                            std::vector<requestT>& parent=next[k[i].parent()];
+                            parent.insert(parent.end(), requests.begin(), requests.end());
+                            continue;
+                        }
+                        for (const requestT& r : requests) {
+                            nodes[r.neigh]=found[i];
+                            if (found[i].second.has_data()) continue;
+                            // interior neighbor: do_diff1 descends into the children of
+                            // the origin facing it and looks up their neighbors
+                            for (KeyChildIterator<NDIM> kit(r.origin); kit; ++kit) {
+                                const bool even=((kit.key().translation()[r.axis]&1)==0);
+                                if (even==(r.step<0)) add(next, kit.key(), r.axis, r.step);
+                            }
+                        }
+                    }
+                }
+                pending.swap(next);
+            }
+        }
+
+        /// Rebind the halo of another function to g, which must have the same tree
+
+        /// The neighbor structure is reused, only the coefficients are fetched.
+        DerivativeHalo(const implT* g, const DerivativeHalo& other)
+            : fid(g->id()), axes(other.axes) {
+
+            std::map<keyT,argT> found;
+            for (const auto& n : other.nodes) found.insert(std::make_pair(n.second.first, argT()));
+            std::vector<keyT> keys;
+            keys.reserve(found.size());
+            for (const auto& n : found) keys.push_back(n.first);
+
+            for (auto& [k, reply] : exchange(g, keys)) {
+                const std::vector<argT>& result=reply.get();
+                for (std::size_t i=0; i<k.size(); ++i) {
+                    MADNESS_CHECK_THROW(result[i].first==k[i], "DerivativeHalo: functions have different trees");
+                    found[k[i]]=result[i];
+                }
+            }
+            for (const auto& n : other.nodes) {
+                const argT& arg=found[n.second.first];
+                MADNESS_CHECK_THROW(arg.second.has_data()==n.second.second.has_data(),
+                        "DerivativeHalo: functions have different trees");
+                nodes[n.first]=arg;
+            }
+        }
+
+        /// the id of the function the halo was gathered for
+        const uniqueidT& id() const {return fid;}
+
+        /// true if the halo covers the derivative along axis
+        bool has_axis(const std::size_t axis) const {
+            return std::find(axes.begin(), axes.end(), axis)!=axes.end();
+        }
+
+        /// the node covering the neighbor key, or a null pointer if it was not gathered
+        const argT* find(const keyT& neigh) const {
+            auto it=nodes.find(neigh);
+            return (it==nodes.end()) ? nullptr : &(it->second);
+        }
+
+        /// number of neighbor keys held
+        std::size_t size() const {return nodes.size();}
+
+        /// number of exchange rounds and aggregated requests used to build the halo
+        std::pair<std::size_t,std::size_t> nmessage() const {return std::make_pair(nround,nrequest);}
+    };
+
+
+
     /// Implements derivatives operators with variety of boundary conditions on simulation domain
     template <typename T, std::size_t NDIM>
     class Derivative : public DerivativeBase<T, NDIM> {
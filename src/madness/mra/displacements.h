@@ -33,6 +33,8 @@
 #ifndef MADNESS_MRA_DISPLACEMENTS_H__INCLUDED
 #define MADNESS_MRA_DISPLACEMENTS_H__INCLUDED
 
+#include <mutex>
+
 namespace madness {
     /// Holds displacements for applying operators to avoid replicating for all operators
     template <std::size_t NDIM>
@@ -40,6 +42,7 @@ namespace madness {
 
         static std::vector< Key<NDIM> > disp;
         static std::vector< Key<NDIM> > disp_periodicsum[64];
+        static std::once_flag disp_once; ///< The displacements are made on first use
 
     public:
         static int bmax_default() {
@@ -172,18 +175,19 @@ namespace madness {
 
 
     public:
+        /// Makes the displacements the first time an instance is constructed in any thread
         Displacements() {
           MADNESS_PRAGMA_CLANG(diagnostic push)
           MADNESS_PRAGMA_CLANG(diagnostic ignored "-Wundefined-var-template")
 
-          if (disp.size() == 0) {
+          std::call_once(disp_once, []() {
                 make_disp(bmax_default());
 
                 if (NDIM <= 3) {
                     Level nmax = 8*sizeof(Translation) - 2;
                     for (Level n=0; n<nmax; ++n) make_disp_periodicsum(bmax_default(), n);
                 }
-            }
+            });
 
           MADNESS_PRAGMA_CLANG(diagnostic pop)
         }
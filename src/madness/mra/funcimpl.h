@@ -77,6 +77,23 @@ namespace madness {
 
 namespace madness {
 
+    namespace detail {
+
+        /// true if op.pointwise() exists and returns true
+
+        /// The values of a pointwise op at a point depend only on the input
+        /// values at that point, so multiop_values may apply it to the values
+        /// of many boxes at once
+        template <typename opT, typename = void>
+        struct op_is_pointwise {
+            static bool value(const opT& op) {return false;}
+        };
+
+        template <typename opT>
+        struct op_is_pointwise<opT, std::void_t<decltype(std::declval<const opT&>().pointwise())> > {
+            static bool value(const opT& op) {return op.pointwise();}
+        };
+    }
 
     /// A simple process map
     template<typename keyT>
@@ -466,6 +483,79 @@ namespace madness {
     }
 
 
+    /// Sizes and norm of a function tree, accumulated in a single traversal
+
+    /// Several statistics that used to take a traversal and a global
+    /// reduction each (tree_size, size, nCoeff, real_size, max_depth, norm)
+    /// are collected at once.  Plain data, so that the statistics of many
+    /// functions are reduced with a single global operation.
+    struct FunctionTreeStats {
+        std::size_t nnodes;     ///< number of nodes, cf tree_size()
+        std::size_t nleaves;    ///< number of leaf nodes
+        std::size_t size;       ///< number of coefficients, cf size()
+        std::size_t ncoeff;     ///< storage in units of the coefficients, cf nCoeff()
+        std::size_t real_size;  ///< storage in bytes, cf real_size()
+        std::size_t max_depth;  ///< deepest level, cf max_depth()
+        double norm2sq;         ///< sum of the squared norms of all coefficients
+
+        FunctionTreeStats() : nnodes(0), nleaves(0), size(0), ncoeff(0), real_size(0),
+                max_depth(0), norm2sq(0.0) {}
+
+        FunctionTreeStats& operator+=(const FunctionTreeStats& other) {
+            nnodes+=other.nnodes;
+            nleaves+=other.nleaves;
+            size+=other.size;
+            ncoeff+=other.ncoeff;
+            real_size+=other.real_size;
+            max_depth=std::max(max_depth,other.max_depth);
+            norm2sq+=other.norm2sq;
+            return *this;
+        }
+
+        /// Reduction operation for WorldGopInterface::reduce and WorldTaskQueue::reduce
+        struct combine {
+            FunctionTreeStats operator()(FunctionTreeStats a, const FunctionTreeStats& b) const {
+                return a+=b;
+            }
+        };
+
+        /// The contribution of a single node
+        template <typename T, std::size_t NDIM>
+        static FunctionTreeStats node_stats(const Key<NDIM>& key, const FunctionNode<T,NDIM>& node) {
+            FunctionTreeStats s;
+            s.nnodes=1;
+            s.nleaves=node.has_children() ? 0 : 1;
+            s.max_depth=key.level();
+            s.ncoeff=sizeof(Key<NDIM>)+sizeof(FunctionNode<T,NDIM>);
+            s.real_size=s.ncoeff;
+            if (node.has_coeff()) {
+                const double norm=node.coeff().normf();
+                s.size=node.size();
+                s.ncoeff+=node.coeff().nCoeff();
+                s.real_size+=node.coeff().real_size();
+                s.norm2sq=norm*norm;
+            }
+            return s;
+        }
+
+        /// Prints a line in the format of FunctionImpl::print_size
+
+        /// @param[in] name name of the function
+        /// @param[in] sizeofT size of the coefficient type
+        void print_size(const std::string& name, const std::size_t sizeofT) const {
+            const double fac=1024*1024*1024;
+            printf("%40s at time %.1fs: norm/tree/#coeff/size: %7.5f %zu, %6.3f m, %6.3f GByte\n",
+                   (name.c_str()), wall_time(), sqrt(norm2sq), nnodes, double(ncoeff)*1.e-6,
+                   double(ncoeff)/fac*double(sizeofT));
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar) {
+            ar & nnodes & nleaves & size & ncoeff & real_size & max_depth & norm2sq;
+        }
+    };
+
+
     /// returns true if the result of a hartree_product is a leaf node (compute norm & error)
     template<typename T, size_t NDIM>
     struct hartree_leaf_op {
@@ -1181,6 +1271,53 @@ namespace madness {
             world.gop.fence();
         }
 
+        /// stores the parameters of the function impl, but not its coefficients
+
+        /// k is stored first, cf. load_parameters
+        template <typename Archive>
+        void store_parameters(Archive& ar) const {
+            ar & k & thresh & initial_level & max_refine_level & truncate_mode
+                & autorefine & truncate_on_project & tree_state;
+        }
+
+        /// loads the parameters stored by store_parameters; k must match
+        template <typename Archive>
+        void load_parameters(Archive& ar) {
+            int kk = 0;
+            ar & kk;
+            MADNESS_CHECK(kk==k);
+            ar & thresh & initial_level & max_refine_level & truncate_mode
+                & autorefine & truncate_on_project & tree_state;
+        }
+
+        /// stores the locally owned nodes to a local archive
+
+        /// No communication and no fence, every process writes its own part
+        /// of the tree, cf. save_function_parallel
+        template <typename Archive>
+        void store_local_nodes(Archive& ar) const {
+            ar & std::size_t(coeffs.size());
+            for (typename dcT::const_iterator it=coeffs.begin(); it!=coeffs.end(); ++it) {
+                ar & it->first & it->second;
+            }
+        }
+
+        /// loads nodes written by store_local_nodes on any process
+
+        /// The nodes are sent to their owners, hence the number of processes
+        /// may differ from that of the writer.  The caller must fence.
+        template <typename Archive>
+        void load_nodes(Archive& ar) {
+            std::size_t nnode = 0;
+            ar & nnode;
+            for (std::size_t i=0; i<nnode; ++i) {
+                keyT key;
+                nodeT node;
+                ar & key & node;
+                coeffs.replace(key,node);
+            }
+        }
+
         /// Returns true if the function is compressed.
         bool is_compressed() const;
 
@@ -2635,17 +2772,74 @@ namespace madness {
                     MADNESS_ASSERT(v[i]->coeffs.size()==v[i-1]->coeffs.size());
                 }
             }
+            const bool batch=detail::op_is_pointwise<opT>::value(op);
+            std::vector<keyT> keys;
             typename dcT::iterator end = v[0]->coeffs.end();
             for (typename dcT::iterator it=v[0]->coeffs.begin(); it!=end; ++it) {
                 const keyT& key = it->first;
-                if (it->second.has_coeff())
-                    world.taskq.add(*this, &implT:: template multiop_values_doit<opT>, key, op, v);
-                else
+                if (not it->second.has_coeff())
                     coeffs.replace(key, nodeT(coeffT(),true));
+                else if (batch)
+                    keys.push_back(key);
+                else
+                    world.taskq.add(*this, &implT:: template multiop_values_doit<opT>, key, op, v);
+            }
+            const std::size_t nbatch=values_batch_size(keys.size());
+            for (std::size_t i=0; i<keys.size(); i+=nbatch) {
+                std::vector<keyT> batch_keys(keys.begin()+i, keys.begin()+std::min(i+nbatch,keys.size()));
+                world.taskq.add(*this, &implT:: template multiop_values_batch_doit<opT>, batch_keys, op, v);
             }
             world.gop.fence();
         }
 
+        /// number of boxes whose values are passed at once to a pointwise op
+
+        /// about 32k points per call, but enough batches to keep all threads busy
+        std::size_t values_batch_size(const std::size_t nbox) const {
+            std::size_t npt=1;
+            for (long d : cdata.vk) npt*=d;
+            const std::size_t nthread=ThreadPool::size()+1;
+            return std::max(std::size_t(1),std::min(32768/npt, nbox/(4*nthread)));
+        }
+
+        /// the values of the boxes of a function, stacked along the first dimension
+        tensorT stacked_values(const std::vector<keyT>& keys) const {
+            long npt=1;
+            for (long d : cdata.vk) npt*=d;
+            std::vector<long> dims(cdata.vk);
+            dims[0]*=keys.size();
+            tensorT result(dims,false);
+            for (std::size_t i=0; i<keys.size(); ++i) {
+                const tensorT values=coeffs2values(keys[i], coeffs.find(keys[i]).get()->second.coeff()).full_tensor();
+                MADNESS_ASSERT(values.iscontiguous() and values.size()==npt);
+                std::copy(values.ptr(), values.ptr()+npt, result.ptr()+i*npt);
+            }
+            return result;
+        }
+
+        /// replace the coefficients of the boxes by those of the stacked values
+        void replace_stacked_values(const std::vector<keyT>& keys, const tensorT& values) {
+            long npt=1;
+            for (long d : cdata.vk) npt*=d;
+            MADNESS_ASSERT(values.iscontiguous() and values.size()==long(npt*keys.size()));
+            for (std::size_t i=0; i<keys.size(); ++i) {
+                tensorT v(cdata.vk,false);
+                std::copy(values.ptr()+i*npt, values.ptr()+(i+1)*npt, v.ptr());
+                coeffs.replace(keys[i], nodeT(coeffT(values2coeffs(keys[i], v),targs),false));
+            }
+        }
+
+        /// Inplace operate with a pointwise operator on the stacked values of many boxes
+        template <typename opT>
+        void multiop_values_batch_doit(const std::vector<keyT>& keys, const opT& op,
+                const std::vector<implT*>& v) {
+            std::vector<tensorT> c(v.size());
+            for (unsigned int i=0; i<v.size(); i++) {
+                if (v[i]) c[i]=v[i]->stacked_values(keys);
+            }
+            replace_stacked_values(keys, op(keys[0], c));
+        }
+
         /// Inplace operate on many functions (impl's) with an operator within a certain box
 
         /// @param[in] key the key of the current function node (box)
@@ -2684,22 +2878,45 @@ namespace madness {
                     MADNESS_ASSERT(vin[i]->coeffs.size()==vin[i-1]->coeffs.size());
                 }
             }
+            const bool batch=detail::op_is_pointwise<opT>::value(op);
+            std::vector<keyT> keys;
             typename dcT::iterator end = vin[0]->coeffs.end();
             for (typename dcT::iterator it=vin[0]->coeffs.begin(); it!=end; ++it) {
                 const keyT& key = it->first;
-                if (it->second.has_coeff())
-                    world.taskq.add(*this, &implT:: template multi_to_multi_op_values_doit<opT>,
-                            key, op, vin, vout);
-                else {
+                if (not it->second.has_coeff()) {
                     // fill result functions with empty box in this key
                     for (implT* it2 : vout) {
                         it2->coeffs.replace(key, nodeT(coeffT(),true));
                     }
+                } else if (batch) {
+                    keys.push_back(key);
+                } else {
+                    world.taskq.add(*this, &implT:: template multi_to_multi_op_values_doit<opT>,
+                            key, op, vin, vout);
                 }
             }
+            const std::size_t nbatch=values_batch_size(keys.size());
+            for (std::size_t i=0; i<keys.size(); i+=nbatch) {
+                std::vector<keyT> batch_keys(keys.begin()+i, keys.begin()+std::min(i+nbatch,keys.size()));
+                world.taskq.add(*this, &implT:: template multi_to_multi_op_values_batch_doit<opT>,
+                        batch_keys, op, vin, vout);
+            }
             if (fence) world.gop.fence();
         }
 
+        /// Operate with a pointwise operator on the stacked values of many boxes
+        template <typename opT>
+        void multi_to_multi_op_values_batch_doit(const std::vector<keyT>& keys, const opT& op,
+                const std::vector<implT*>& vin, std::vector<implT*>& vout) {
+            std::vector<tensorT> c(vin.size());
+            for (unsigned int i=0; i<vin.size(); i++) {
+                if (vin[i]) c[i]=vin[i]->stacked_values(keys);
+            }
+            std::vector<tensorT> r = op(keys[0], c);
+            MADNESS_ASSERT(r.size()==vout.size());
+            for (std::size_t i=0; i<vout.size(); ++i) vout[i]->replace_stacked_values(keys, r[i]);
+        }
+
         /// Transforms a vector of functions left[i] = sum[j] right[j]*c[j,i] using sparsity
         /// @param[in] vright vector of functions (impl's) on which to be transformed
         /// @param[in] c the tensor (matrix) transformer
@@ -3162,6 +3379,13 @@ namespace madness {
         void sock_it_to_me_too(const keyT& key,
                                const RemoteReference< FutureImpl< std::pair<keyT,coeffT> > >& ref) const;
 
+        /// Batched lookup of locally owned nodes, used by the derivative halo exchange
+
+        /// For each key returns (key,coeff) if the node is a leaf, (key,empty)
+        /// if it is an interior node, and (invalid,empty) if it does not exist,
+        /// in which case the caller continues the search at the parent.
+        std::vector< std::pair<keyT,coeffT> > find_nodes(const std::vector<keyT>& keys) const;
+
         /// @todo help!
         void plot_cube_kernel(archive::archive_ptr< Tensor<T> > ptr,
                               const keyT& key,
@@ -3179,6 +3403,21 @@ namespace madness {
                                  const std::vector<long>& npt,
                                  const bool eval_refine = false) const;
 
+        /// Evaluates the points of one leaf box with a single contraction of its coefficients
+
+        /// The points are in simulation coordinates, the values are written to r(index[i])
+        void eval_points_kernel(archive::archive_ptr< Tensor<T> > ptr,
+                                const keyT& key,
+                                const std::vector<coordT>& xsim,
+                                const std::vector<long>& index) const;
+
+        /// Evaluate a list of points given in simulation coordinates ... collective, no fence
+
+        /// The points are sorted into the local leaf boxes and every box
+        /// evaluates all of its points at once; all processes receive all values.
+        /// @param[in] xsim the points, inside the simulation cell
+        Tensor<T> eval_points(const std::vector<coordT>& xsim) const;
+
 
         /// Evaluate function only if point is local returning (true,value); otherwise return (false,0.0)
 
@@ -3604,6 +3843,127 @@ namespace madness {
         }
 
 
+        /// make the coefficients of a sum of Hartree products sum_i |p1_i(1)> |p2_i(2)>
+
+        /// A box is a leaf if it is a leaf for every product; its coefficients
+        /// are the sum of the outer products in low-rank form
+        template<std::size_t LDIM, typename leaf_opT>
+        struct hartree_sum_op {
+            bool randomize() const {return false;}
+
+            typedef hartree_sum_op<LDIM,leaf_opT> this_type;
+            typedef CoeffTracker<T,LDIM> ctL;
+
+            implT* result; 	        ///< where to construct the pair function
+            std::vector<ctL> p1, p2;  ///< tracking coeffs of the lo-dim functions
+            leaf_opT leaf_op;       ///< determine if a given node will be a leaf node
+
+            // ctor
+            hartree_sum_op() : result() {}
+            hartree_sum_op(implT* result, const std::vector<ctL>& p11, const std::vector<ctL>& p22,
+                    const leaf_opT& leaf_op)
+                : result(result), p1(p11), p2(p22), leaf_op(leaf_op) {
+                MADNESS_ASSERT(LDIM+LDIM==NDIM);
+                MADNESS_ASSERT(p1.size()==p2.size());
+            }
+
+            std::pair<bool,coeffT> operator()(const Key<NDIM>& key) const {
+
+                Key<LDIM> key1,key2;
+                key.break_apart(key1,key2);
+
+                // all products are evaluated before any coefficients are made
+                std::vector<coeffT> fcoeff(p1.size()), gcoeff(p2.size());
+                bool is_leaf=true;
+                for (std::size_t i=0; i<p1.size(); ++i) {
+                    fcoeff[i]=p1[i].coeff(key1);
+                    gcoeff[i]=p2[i].coeff(key2);
+                    is_leaf=leaf_op(key,fcoeff[i].full_tensor(),gcoeff[i].full_tensor()) and is_leaf;
+                }
+                if (not is_leaf) return std::pair<bool,coeffT> (is_leaf,coeffT());
+
+                coeffT coeff;
+                for (std::size_t i=0; i<p1.size(); ++i) {
+                    const coeffT s1=fcoeff[i](p1[i].get_impl()->cdata.s0);
+                    const coeffT s2=gcoeff[i](p2[i].get_impl()->cdata.s0);
+                    if (coeff.has_data()) coeff+=outer(s1,s2,result->get_tensor_args());
+                    else coeff=outer(s1,s2,result->get_tensor_args());
+                }
+                coeff.reduce_rank(result->get_tensor_args().thresh);
+                return std::pair<bool,coeffT>(is_leaf,coeff);
+            }
+
+            this_type make_child(const keyT& child) const {
+                Key<LDIM> key1, key2;
+                child.break_apart(key1,key2);
+
+                std::vector<ctL> child1, child2;
+                for (const ctL& p : p1) child1.push_back(p.make_child(key1));
+                for (const ctL& p : p2) child2.push_back(p.make_child(key2));
+                return this_type(result,child1,child2,leaf_op);
+            }
+
+            Future<this_type> activate() const {
+                std::vector<Future<ctL> > p11, p22;
+                for (const ctL& p : p1) p11.push_back(p.activate());
+                for (const ctL& p : p2) p22.push_back(p.activate());
+                return result->world.taskq.add(detail::wrap_mem_fn(*const_cast<this_type *> (this),
+                                               &this_type::forward_ctor),result,p11,p22,leaf_op);
+            }
+
+            this_type forward_ctor(implT* result1, const std::vector<Future<ctL> >& p11,
+                    const std::vector<Future<ctL> >& p22, const leaf_opT& leaf_op) {
+                std::vector<ctL> q1, q2;
+                for (const Future<ctL>& p : p11) q1.push_back(p.get());
+                for (const Future<ctL>& p : p22) q2.push_back(p.get());
+                return this_type(result1,q1,q2,leaf_op);
+            }
+
+            template <typename Archive> void serialize(const Archive& ar) {
+                ar & result & p1 & p2 & leaf_op;
+            }
+        };
+
+
+        /// given pairs of functions of LDIM, perform the sum of their Hartree products
+
+        /// |Phi(1,2)> = \sum_i |p1_i(1)> x |p2_i(2)>, in a single traversal of the result tree
+        /// @param[in]	p1	FunctionImpls of particle 1
+        /// @param[in]	p2	FunctionImpls of particle 2
+        /// @param[in]	leaf_op	operator determining of a given box will be a leaf
+        template<std::size_t LDIM, typename leaf_opT>
+        void hartree_product(const std::vector<const FunctionImpl<T,LDIM>*>& p1,
+                             const std::vector<const FunctionImpl<T,LDIM>*>& p2,
+                             const leaf_opT& leaf_op, bool fence) {
+            MADNESS_ASSERT(p1.size()==p2.size());
+            for (std::size_t i=0; i<p1.size(); ++i) {
+                MADNESS_ASSERT(p1[i]->is_nonstandard() or p1[i]->is_nonstandard_with_leaves());
+                MADNESS_ASSERT(p2[i]->is_nonstandard() or p2[i]->is_nonstandard_with_leaves());
+            }
+
+            if (world.rank() == this->get_coeffs().owner(cdata.key0)) {
+
+                std::vector<CoeffTracker<T,LDIM> > iap1, iap2;
+                for (std::size_t i=0; i<p1.size(); ++i) {
+                    iap1.push_back(CoeffTracker<T,LDIM>(p1[i]));
+                    iap2.push_back(CoeffTracker<T,LDIM>(p2[i]));
+                }
+
+                typedef hartree_sum_op<LDIM,leaf_opT> coeff_opT;
+                coeff_opT coeff_op(this,iap1,iap2,leaf_op);
+
+                typedef insert_op<T,NDIM> apply_opT;
+                apply_opT apply_op(this);
+
+                woT::task(world.rank(), &implT:: template forward_traverse<coeff_opT,apply_opT>,
+                          coeff_op, apply_op, cdata.key0);
+            }
+
+            set_tree_state(reconstructed);
+            if (fence) world.gop.fence();
+        }
+
+
         template <typename opT, typename R>
         void
         apply_1d_realspace_push_op(const archive::archive_ptr<const opT>& pop, int axis, const keyT& key, const Tensor<R>& c) {
@@ -4436,9 +4796,174 @@ namespace madness {
         /// compute for each FunctionNode the norm of the function inside that node
         void norm_tree(bool fence);
 
-        double norm_tree_op(const keyT& key, const std::vector< Future<double> >& v);
+        /// Upsweep operator computing norm_tree
+        struct do_norm_tree {
+            typedef double resultT;
+
+            double leaf(const keyT& key, nodeT& node) const {
+                const double norm=node.coeff().normf();
+                node.set_norm_tree(norm);
+                return norm;
+            }
+
+            double parent(const keyT& key, nodeT& node, const std::vector<double>& children) const {
+                double sum=0.0;
+                for (double c : children) sum+=c*c;
+                sum=sqrt(sum);
+                node.set_norm_tree(sum);
+                return sum;
+            }
+
+            template <typename Archive> void serialize(const Archive& ar) {}
+        };
+
+        /// Generic upward pass (reduction from the leaves to the root) over the tree
+
+        /// The operator provides
+        /// \code
+        ///   typedef ... resultT;  // the value passed up the tree, must be serializable
+        ///   resultT leaf(const keyT& key, nodeT& node) const;
+        ///   resultT parent(const keyT& key, nodeT& node, const std::vector<resultT>& children) const;
+        /// \endcode
+        /// and is copied to the owners of remote subtrees.  Several reductions
+        /// are fused by letting resultT hold all of them.  Leaves that are
+        /// local to their parent are handled inline, only remote children and
+        /// local subtrees are spawned as tasks.
+        /// Invoke where key is local; the result is available on that process.
+        template <typename opT>
+        Future<typename opT::resultT> upsweep_spawn(const keyT& key, const opT& op) {
+            typedef typename opT::resultT resultT;
+            nodeT& node = coeffs.find(key).get()->second;
+            if (!node.has_children()) return Future<resultT>(op.leaf(key,node));
+
+            std::vector< Future<resultT> > v = future_vector_factory<resultT>(1<<NDIM);
+            int i=0;
+            for (KeyChildIterator<NDIM> kit(key); kit; ++kit,++i) {
+                const keyT& child=kit.key();
+                const ProcessID owner=coeffs.owner(child);
+                if (owner==world.rank()) {
+                    nodeT& childnode = coeffs.find(child).get()->second;
+                    if (!childnode.has_children()) {
+                        v[i] = Future<resultT>(op.leaf(child,childnode));
+                        continue;
+                    }
+                }
+                v[i] = woT::task(owner, &implT::template upsweep_spawn<opT>, child, op);
+            }
+            return woT::task(world.rank(), &implT::template upsweep_op<opT>, key, op, v);
+        }
+
+        template <typename opT>
+        typename opT::resultT upsweep_op(const keyT& key, const opT& op,
+                                         const std::vector< Future<typename opT::resultT> >& v) {
+            std::vector<typename opT::resultT> children(v.size());
+            for (std::size_t i=0; i<v.size(); ++i) children[i]=v[i].get();
+            nodeT& node = coeffs.find(key).get()->second;
+            return op.parent(key,node,children);
+        }
+
+        /// Upward pass from the root, collective; result is broadcast to all processes
+        template <typename opT>
+        typename opT::resultT upsweep(const opT& op) {
+            typedef typename opT::resultT resultT;
+            const ProcessID root=coeffs.owner(cdata.key0);
+            Future<resultT> fresult;
+            if (world.rank() == root) fresult=upsweep_spawn(cdata.key0,op);
+            world.gop.fence();
+            resultT result;
+            if (world.rank() == root) result=fresult.get();
+            world.gop.broadcast_serializable(result, root);
+            return result;
+        }
+
+        /// Generic downward pass (from the root to the leaves) over the tree
+
+        /// The operator provides
+        /// \code
+        ///   typedef ... argT;     // the value passed down the tree, must be serializable
+        ///   argT operator()(const keyT& key, nodeT& node, const argT& arg) const;
+        /// \endcode
+        /// which is called for every node with the value returned for its
+        /// parent; the return value is handed to all children.  Children are
+        /// visited as tasks at their owners.  Invoke where key is local.
+        template <typename opT>
+        void downsweep_spawn(const keyT& key, const opT& op, const typename opT::argT& arg) {
+            nodeT& node = coeffs.find(key).get()->second;
+            const typename opT::argT childarg=op(key,node,arg);
+            if (node.has_children()) {
+                for (KeyChildIterator<NDIM> kit(key); kit; ++kit) {
+                    const keyT& child=kit.key();
+                    woT::task(coeffs.owner(child), &implT::template downsweep_spawn<opT>, child, op, childarg);
+                }
+            }
+        }
+
+        /// Downward pass from the root with the given initial value
+        template <typename opT>
+        void downsweep(const opT& op, const typename opT::argT& arg, bool fence) {
+            if (world.rank() == coeffs.owner(cdata.key0)) downsweep_spawn(cdata.key0,op,arg);
+            if (fence) world.gop.fence();
+        }
+
+        /// Upsweep operator computing norm_tree and the tree statistics in the same pass
+        struct do_norm_tree_stats {
+            typedef FunctionTreeStats resultT;
+
+            resultT leaf(const keyT& key, nodeT& node) const {
+                resultT s=FunctionTreeStats::node_stats(key,node);
+                node.set_norm_tree(sqrt(s.norm2sq));
+                return s;
+            }
+
+            resultT parent(const keyT& key, nodeT& node, const std::vector<resultT>& children) const {
+                resultT s=FunctionTreeStats::node_stats(key,node);
+                double sum=0.0;
+                for (const resultT& c : children) {
+                    s+=c;
+                    sum+=c.norm2sq;
+                }
+                node.set_norm_tree(sqrt(sum));
+                return s;
+            }
+
+            template <typename Archive> void serialize(const Archive& ar) {}
+        };
+
+        /// Computes norm_tree and returns the tree statistics with a single traversal
+
+        /// Collective, tree must be reconstructed.
+        FunctionTreeStats norm_tree_stats() {
+            return upsweep(do_norm_tree_stats());
+        }
+
+        /// Local part of the tree statistics
+        struct do_tree_stats_local {
+            FunctionTreeStats operator()(typename dcT::const_iterator& it) const {
+                return FunctionTreeStats::node_stats(it->first,it->second);
+            }
 
-        Future<double> norm_tree_spawn(const keyT& key);
+            FunctionTreeStats operator()(const FunctionTreeStats& a, const FunctionTreeStats& b) const {
+                return FunctionTreeStats::combine()(a,b);
+            }
+
+            template <typename Archive> void serialize(const Archive& ar) {
+                throw "NOT IMPLEMENTED";
+            }
+        };
+
+        /// Returns the statistics of the local part of the tree ... no comms
+        FunctionTreeStats tree_stats_local() const {
+            typedef Range<typename dcT::const_iterator> rangeT;
+            return world.taskq.reduce<FunctionTreeStats,rangeT,do_tree_stats_local>(
+                    rangeT(coeffs.begin(),coeffs.end()), do_tree_stats_local());
+        }
+
+        /// Returns the statistics of the tree ... one traversal, one global reduction
+        FunctionTreeStats tree_stats() const {
+            FunctionTreeStats s=tree_stats_local();
+            world.gop.reduce(&s, 1, FunctionTreeStats::combine());
+            return s;
+        }
 
         /// truncate using a tree in reconstructed form
 
@@ -4470,6 +4995,16 @@ namespace madness {
         /// Changes non-standard compressed form to standard compressed form
         void standard(bool fence);
 
+        /// Changes standard compressed form to non-standard form in a single downward pass
+
+        /// Equivalent to reconstruct() followed by compress() into the
+        /// nonstandard form, but traverses the tree only once
+        /// @param[in] keepleaves   keep the sum coefficients of the leaves
+        void nonstandard_from_compressed(bool keepleaves, bool fence);
+
+        /// Invoked on node where key is local, s are its sum coefficients
+        void nonstandard_from_compressed_op(const keyT& key, const coeffT& s, bool keepleaves);
+
         /// Changes non-standard compressed form to standard compressed form
         struct do_standard {
             typedef Range<typename dcT::iterator> rangeT;
@@ -6388,6 +6923,156 @@ namespace madness {
         };
 
 
+        /// project several low-dim functions on the hi-dim function f: result_i(x) = <this(x,y) | g_i(y)>
+
+        /// invoked by the hi-dim function, cf project_out; the tree of this
+        /// is traversed only once for all functions g_i
+        /// @param[in]  result  lo-dim functions of NDIM-LDIM
+        /// @param[in]  gimpl  	lo-dim functions of LDIM
+        /// @param[in]  dim over which dimensions to be integrated: 0..LDIM or LDIM..LDIM+NDIM-1
+        template<size_t LDIM>
+        void project_out(const std::vector<FunctionImpl<T,NDIM-LDIM>*>& result,
+                         const std::vector<const FunctionImpl<T,LDIM>*>& gimpl,
+                         const int dim, const bool fence) {
+            MADNESS_ASSERT(result.size()==gimpl.size());
+
+            const keyT& key0=cdata.key0;
+
+            if (world.rank() == coeffs.owner(key0) and gimpl.size()>0) {
+
+                std::vector<CoeffTracker<T,LDIM> > iag;
+                for (const FunctionImpl<T,LDIM>* g : gimpl) iag.push_back(CoeffTracker<T,LDIM>(g));
+
+                // coeff_op will accumulate the results
+                typedef project_out_vector_op<LDIM> coeff_opT;
+                coeff_opT coeff_op(this,result,iag,dim);
+
+                typedef noop<T,NDIM> apply_opT;
+                apply_opT apply_op;
+
+                woT::task(world.rank(), &implT:: template forward_traverse<coeff_opT,apply_opT>,
+                          coeff_op, apply_op, cdata.key0);
+
+            }
+            if (fence) world.gop.fence();
+        }
+
+
+        /// project several low-dim functions g_i on the hi-dim function f: result_i(x) = <f(x,y) | g_i(y)>
+
+        /// The overlaps of all g_i with the SVD vectors of a box of f are a
+        /// single matrix product, as is their contraction with the other vectors.
+        template<size_t LDIM>
+        struct project_out_vector_op {
+            bool randomize() const {return false;}
+
+            typedef project_out_vector_op<LDIM> this_type;
+            typedef CoeffTracker<T,LDIM> ctL;
+            typedef FunctionImpl<T,NDIM-LDIM> implL1;
+            typedef std::pair<bool,coeffT> argT;
+
+            const implT* fimpl;		        ///< the hi dim function f
+            std::vector<implL1*> result;	///< the low dim result functions
+            std::vector<ctL> iag;			///< the low dim functions g_i
+            int dim;				        ///< 0: project 0..LDIM-1, 1: project LDIM..NDIM-1
+
+            // ctor
+            project_out_vector_op() {}
+            project_out_vector_op(const implT* fimpl, const std::vector<implL1*>& result,
+                    const std::vector<ctL>& iag, const int dim)
+                : fimpl(fimpl), result(result), iag(iag), dim(dim) {}
+
+            /// do the actual contraction
+            Future<argT> operator()(const Key<NDIM>& key) const {
+
+                Key<LDIM> key1,key2;
+                key.break_apart(key1,key2);
+                const Key<LDIM>& gkey=(dim==0) ? key1 : key2;
+                const Key<LDIM>& dest=(dim==0) ? key2 : key1;
+
+                MADNESS_ASSERT(fimpl->get_coeffs().probe(key));		// must be local!
+                const nodeT& fnode=fimpl->get_coeffs().find(key).get()->second;
+                const coeffT& fcoeff=fnode.coeff();
+
+                // fast return if possible
+                if (fcoeff.has_no_data() or fcoeff.rank()==0)
+                    return Future<argT> (argT(fnode.is_leaf(),coeffT()));
+
+                // specialized on SVD tensors for f and full tensors of half dim for g, cf project_out_op
+                MADNESS_ASSERT(fcoeff.is_svd_tensor());
+                const SVDTensor<T>& svd=fcoeff.get_svdtensor();
+                const long rank=svd.rank();
+                const int otherdim=(dim+1)%2;
+                const long kdim=svd.kVec(dim);
+                const long kother=svd.kVec(otherdim);
+
+                // the coefficients of all g_i in this box, one row each
+                tensorT gmat(long(iag.size()),kdim);
+                std::vector<bool> has_g(iag.size(),false);
+                for (std::size_t i=0; i<iag.size(); ++i) {
+                    const coeffT gcoeff=iag[i].get_impl()->parent_to_child(iag[i].coeff(),iag[i].key(),gkey);
+                    if (gcoeff.has_no_data()) continue;
+                    MADNESS_ASSERT(gcoeff.is_full_tensor());
+                    gmat(long(i),_)=gcoeff.full_tensor().reshape(kdim);
+                    has_g[i]=true;
+                }
+
+                std::vector<Slice> s(svd.dim_per_vector(dim)+1,_);
+                std::vector<Slice> other_s(svd.dim_per_vector(otherdim)+1,_);
+                s[0]=Slice(0,rank-1);
+                other_s[0]=Slice(0,rank-1);
+                const tensorT contracted=svd.ref_vector(dim)(s).reshape(rank,kdim);
+                const tensorT other=svd.ref_vector(otherdim)(other_s).reshape(rank,kother);
+
+                // ovlp(i,r) = <g_i | f_r> sigma_r;  final(i) = sum_r ovlp(i,r) other_r
+                tensorT ovlp=inner(madness::conj(gmat),contracted,1,1);
+                for (long i=0; i<ovlp.dim(0); ++i)
+                    for (long r=0; r<rank; ++r) ovlp(i,r)*=svd.weights(r);
+                const tensorT final=inner(ovlp,other);
+
+                // accumulate the results
+                for (std::size_t i=0; i<iag.size(); ++i) {
+                    if (not has_g[i]) continue;
+                    tensorT fi=copy(final(long(i),_)).reshape(result[i]->cdata.vk);
+                    result[i]->coeffs.task(dest, &FunctionNode<T,LDIM>::accumulate2, fi, result[i]->coeffs, dest, TaskAttributes::hipri());
+                }
+
+                return Future<argT> (argT(fnode.is_leaf(),coeffT()));
+            }
+
+            this_type make_child(const keyT& child) const {
+            	Key<LDIM> key1,key2;
+            	child.break_apart(key1,key2);
+            	const Key<LDIM> gkey = (dim==0) ? key1 : key2;
+
+                std::vector<ctL> child_iag;
+                for (const ctL& g : iag) child_iag.push_back(g.make_child(gkey));
+                return this_type(fimpl,result,child_iag,dim);
+            }
+
+            /// retrieve the coefficients (parent coeffs might be remote)
+            Future<this_type> activate() const {
+                std::vector<Future<ctL> > g1;
+                for (const ctL& g : iag) g1.push_back(g.activate());
+                return fimpl->world.taskq.add(detail::wrap_mem_fn(*const_cast<this_type *> (this),
+                                              &this_type::forward_ctor),fimpl,result,g1,dim);
+            }
+
+            /// taskq-compatible ctor
+            this_type forward_ctor(const implT* fimpl1, const std::vector<implL1*>& result1,
+                    const std::vector<Future<ctL> >& g1, const int dim1) {
+                std::vector<ctL> iag1;
+                for (const Future<ctL>& g : g1) iag1.push_back(g.get());
+                return this_type(fimpl1,result1,iag1,dim1);
+            }
+
+            template <typename Archive> void serialize(const Archive& ar) {
+                ar & result & iag & fimpl & dim;
+            }
+
+        };
+
+
         /// project the low-dim function g on the hi-dim function f: this(x) = <f(x,y) | g(y)>
 
         /// invoked by result, a function of NDIM
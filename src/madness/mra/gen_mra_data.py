@@ -0,0 +1,32 @@
+# Generates mra_data.cc which compiles the MRA data files (twoscale
+# coefficients, autocorrelation coefficients and Gauss-Legendre
+# quadrature) into the library so that startup need not read them.
+#
+# usage: python gen_mra_data.py <output> <coeffs> <autocorr> <gaussleg>
+#
+# The numbers are copied verbatim as decimal literals, so the compiler
+# produces exactly the same doubles as fscanf does when reading the files.
+
+import sys
+
+def emit(f, name, filename):
+    tokens = open(filename).read().split()
+    f.write("        extern const double %s[] = {\n" % name)
+    for i in range(0, len(tokens), 6):
+        f.write("            " + ", ".join(tokens[i:i+6]) + ",\n")
+    f.write("        };\n")
+    f.write("        extern const std::size_t %s_size = %d;\n\n" % (name, len(tokens)))
+
+output, coeffs, autocorr, gaussleg = sys.argv[1:5]
+
+f = open(output, "w")
+f.write("// Generated by gen_mra_data.py ... do not edit\n\n")
+f.write("#include <cstddef>\n\n")
+f.write("namespace madness {\n")
+f.write("    namespace detail {\n")
+emit(f, "mra_twoscale_data", coeffs)
+emit(f, "mra_autocorr_data", autocorr)
+emit(f, "mra_gaussleg_data", gaussleg)
+f.write("    }\n")
+f.write("}\n")
+f.close()
@@ -40,7 +40,9 @@
 
 //#include <iostream>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 #include "../constants.h"
 #include "../tensor/basetensor.h"
 #include "../tensor/slice.h"
@@ -48,6 +50,7 @@
 #include "../tensor/tensor_lapack.h"
 #include "../world/madness_exception.h"
 #include "../world/print.h"
+#include "legendre.h"
 
 namespace madness {
 
@@ -79,7 +82,14 @@ public:
 	/// @parma[in]	prnt	print level
 	static GFit BSHFit(double mu, double lo, double hi, double eps, bool prnt=false) {
 		GFit fit;
-		if (NDIM==3) bsh_fit(mu,lo,hi,eps,fit.coeffs_,fit.exponents_,prnt);
+		if (NDIM==3) {
+			bsh_fit(mu,lo,hi,eps,fit.coeffs_,fit.exponents_,prnt);
+			if (minimal_terms_) {
+				auto bsh=[mu](double r) {return exp(-mu*r)/(4.0*constants::pi*r);};
+				reduce_expansion(bsh,lo,hi,eps,bsh_range(mu,hi,eps),
+						fit.coeffs_,fit.exponents_,prnt);
+			}
+		}
 		else bsh_fit_ndim(NDIM,mu,lo,hi,eps,fit.coeffs_,fit.exponents_,prnt);
 		return fit;
 	}
@@ -96,9 +106,61 @@ public:
 	static GFit SlaterFit(double gamma, double lo, double hi, double eps, bool prnt=false) {
 		GFit fit;
 		slater_fit(gamma,lo,hi,eps,fit.coeffs_,fit.exponents_,prnt);
+		if (minimal_terms_) {
+			auto slater=[gamma](double r) {return exp(-gamma*r);};
+			reduce_expansion(slater,lo,hi,eps,lo,fit.coeffs_,fit.exponents_,prnt);
+		}
 		return fit;
 	}
 
+	/// return a fit for the short-range (erfc-attenuated) Coulomb function
+
+	/// the short-range Coulomb function is defined by
+	///  f(r) = erfc(\omega r)/r
+	/// It is negligible beyond erfc_range, which replaces hi if smaller, so
+	/// the fit contains no diffuse Gaussians with exponents below omega^2.
+	/// @param[in]	omega	the range-separation parameter
+	/// @param[in]	lo	the smallest length scale that needs to be precisely represented
+	/// @param[in]	hi	the largest length scale that needs to be precisely represented
+	/// @param[in]	eps	the precision threshold
+	/// @parma[in]	prnt	print level
+	static GFit ErfcCoulombFit(double omega, double lo, double hi, double eps, bool prnt=false) {
+		MADNESS_CHECK(NDIM==3 and omega>0.0);
+		GFit fit;
+		erfc_fit(omega,lo,hi,eps,fit.coeffs_,fit.exponents_,prnt);
+		return fit;
+	}
+
+	/// return a fit for the long-range (erf-attenuated) Coulomb function
+
+	/// the long-range Coulomb function is defined by
+	///  f(r) = erf(\omega r)/r
+	/// @param[in]	omega	the range-separation parameter
+	/// @param[in]	lo	the smallest length scale that needs to be precisely represented
+	/// @param[in]	hi	the largest length scale that needs to be precisely represented
+	/// @param[in]	eps	the precision threshold
+	/// @parma[in]	prnt	print level
+	static GFit ErfCoulombFit(double omega, double lo, double hi, double eps, bool prnt=false) {
+		MADNESS_CHECK(NDIM==3 and omega>0.0);
+		GFit fit;
+		erf_fit(omega,lo,hi,eps,fit.coeffs_,fit.exponents_,prnt);
+		return fit;
+	}
+
+	/// return the distance beyond which erfc(\omega r)/r is negligible
+
+	/// that is the distance at which erfc(\omega r) drops below eps
+	static double erfc_range(double omega, double eps) {
+		double a=0.0, b=1.0;
+		while (erfc(b)>eps) b*=2.0;
+		for (int i=0; i<60; ++i) {
+			const double c=0.5*(a+b);
+			if (erfc(c)>eps) a=c;
+			else b=c;
+		}
+		return b/omega;
+	}
+
 	/// return a fit for a general isotropic function
 
 	/// note that the error is controlled over a uniform grid, the boundaries
@@ -108,6 +170,18 @@ public:
 		return GFit();
 	}
 
+	/// use expansions with a minimal number of terms
+
+	/// If set, CoulombFit, BSHFit (NDIM==3 only) and SlaterFit refit the
+	/// trapezoidal expansion with as few terms as possible, cf
+	/// reduce_expansion.  The separation rank of all operators built from
+	/// these fits drops accordingly, at the price of a more expensive
+	/// construction of the fit.
+	static void set_minimal_terms(bool value) {minimal_terms_=value;}
+
+	/// return if expansions with a minimal number of terms are used
+	static bool get_minimal_terms() {return minimal_terms_;}
+
 	/// return the coefficients of the fit
 	Tensor<T> coeffs() const {return coeffs_;}
 
@@ -163,6 +237,20 @@ private:
 	/// the exponents of the expansion f(x) = \sum_m coeffs[m] exp(-exponents[m] * x^2)
 	Tensor<T> exponents_;
 
+	/// flag for expansions with a minimal number of terms
+	static inline bool minimal_terms_=false;
+
+	/// the largest length scale of the BSH fit, cf bsh_fit
+	static double bsh_range(double mu, double hi, double eps) {
+		if (mu > 0) {
+			// Restrict hi according to the exponential decay
+			double r = -log(4*constants::pi*0.01*eps);
+			r = -log(r * 4*constants::pi*0.01*eps);
+			if (hi > r) hi = r;
+		}
+		return hi;
+	}
+
 	/// fit the function exp(-mu r)/r
 
 	/// formulas taken from
@@ -177,12 +265,7 @@ private:
 
                 if (mu < 0.0) throw "cannot handle negative mu in bsh_fit";
 
-		if (mu > 0) {
-			// Restrict hi according to the exponential decay
-			double r = -log(4*constants::pi*0.01*eps);
-			r = -log(r * 4*constants::pi*0.01*eps);
-			if (hi > r) hi = r;
-		}
+		hi = bsh_range(mu,hi,eps);
 
 		double TT;
 		double slo, shi;
@@ -353,6 +436,149 @@ private:
 		pexpnt = expnt;
 	}
 
+	/// replace the diffuse part of a Gaussian expansion by as few terms as possible
+
+	/// The trapezoidal expansions resolve the integral representation of
+	/// the kernel uniformly in log(exponent), also where the Gaussians are
+	/// so diffuse that over [0,hi] their sum is a smooth, slowly varying
+	/// function of r^2, up to the common factor exp(-min a_j r^2).  Such a
+	/// block of terms ((exponent - min exponent)*hi^2 < cut) is a
+	/// quadrature sum_j c_j exp(-a_j r^2) with positive weights, and is
+	/// replaced by the m-point Gauss rule for the same discrete measure,
+	/// which reproduces the moments sum_j c_j a_j^n for n<2m and again has
+	/// positive weights and exponents within [min a_j, max a_j].  The rule is
+	/// obtained from m Lanczos steps on diag(a) (Golub-Welsch).
+	///
+	/// The smallest m is accepted for which the reduced expansion deviates
+	/// from the input expansion by less than tol(r)=eps*max(|f(r)|,|f(rfloor)|)/10
+	/// on a dense logarithmic grid over [lo,hi], so the error of the
+	/// reduced expansion is bounded by that of the input expansion plus tol(r).
+	/// @param[in]	f	the isotropic function f(r)
+	/// @param[in]	lo	the smallest length scale that needs to be precisely represented
+	/// @param[in]	hi	the largest length scale that needs to be precisely represented
+	/// @param[in]	eps	the precision threshold
+	/// @param[in]	rfloor	below |f(rfloor)| the error is controlled in absolute terms
+	/// @param[in,out]	pcoeff	the coefficients, on exit those of the reduced expansion
+	/// @param[in,out]	pexpnt	the exponents, on exit those of the reduced expansion
+	/// @param[in]	prnt	print level
+	template<typename funcT>
+	static void reduce_expansion(const funcT& f, double lo, double hi, double eps,
+			double rfloor, Tensor<double>& pcoeff, Tensor<double>& pexpnt,
+			bool prnt) {
+
+		const long npt=pcoeff.dim(0);
+
+		// dense logarithmic grid with nper points per unit of log(r)
+		const long nper=64;
+		const long ngrid=long(nper*log(hi/lo))+1;
+		const double step=log(hi/lo)/(ngrid-1);
+		const double ffloor=std::abs(f(rfloor));
+		Tensor<double> r(ngrid), tol(ngrid);
+		for (long i=0; i<ngrid; ++i) {
+			r[i]=lo*exp(i*step);
+			tol[i]=0.1*eps*std::max(std::abs(f(r[i])),ffloor);
+		}
+
+		// m-point Gauss rule for the measure sum_j c0_j delta(a-e0_j)
+		auto gauss=[](const long m, const Tensor<double>& c0, const Tensor<double>& e0,
+				Tensor<double>& c, Tensor<double>& e) {
+			const long nd=c0.dim(0);
+			const double scale=e0.max();
+			Tensor<double> Q(m+1,nd), J(m,m);
+			for (long j=0; j<nd; ++j) Q(0,j)=sqrt(c0[j]);
+			Q(0,_).scale(1.0/Q(0,_).normf());
+			for (long k=0; k<m; ++k) {
+				Tensor<double> v=copy(Q(k,_));
+				v.emul(e0).scale(1.0/scale);
+				J(k,k)=v.trace(Q(k,_));
+				// full reorthogonalization, m is small
+				for (long l=0; l<=k; ++l) v-=Q(l,_)*v.trace(Q(l,_));
+				const double beta=v.normf();
+				if (k+1<m) {
+					if (beta<1.e-14) return false;
+					J(k,k+1)=J(k+1,k)=beta;
+					Q(k+1,_)=v*(1.0/beta);
+				}
+			}
+			Tensor<double> evec, eval;
+			syev(J,evec,eval);
+			c=Tensor<double>(m);
+			e=Tensor<double>(m);
+			for (long k=0; k<m; ++k) {
+				c[k]=c0.sum()*evec(0,m-1-k)*evec(0,m-1-k);
+				e[k]=eval[m-1-k]*scale;
+			}
+			return (c.min()>0.0 && e.min()>0.0);
+		};
+
+		// try several sizes of the diffuse block and keep the largest saving
+		const double emin=pexpnt.min();
+		long bestsaving=0;
+		Tensor<double> bestc=pcoeff, beste=pexpnt;
+		for (double cut : {0.25, 1.0, 4.0, 16.0, 64.0}) {
+			std::vector<long> diffuse, rest;
+			for (long j=0; j<npt; ++j) {
+				if ((pexpnt[j]-emin)*hi*hi<cut) diffuse.push_back(j);
+				else rest.push_back(j);
+			}
+			const long nd=diffuse.size(), nr=rest.size();
+			if (nd<2) continue;
+
+			Tensor<double> c0(nd), e0(nd);
+			for (long j=0; j<nd; ++j) {
+				c0[j]=pcoeff[diffuse[j]];
+				e0[j]=pexpnt[diffuse[j]];
+			}
+			if (c0.min()<=0.0) continue;
+
+			for (long m=1; m<nd-bestsaving; ++m) {
+				Tensor<double> c, e;
+				if (!gauss(m,c0,e0,c,e)) break;
+
+				double err=0.0;
+				for (long i=0; i<ngrid; ++i) {
+					err=std::max(err,std::abs(eval(c,e,r[i])-eval(c0,e0,r[i]))/tol[i]);
+				}
+				if (err>1.0) continue;
+
+				bestc=Tensor<double>(nr+m);
+				beste=Tensor<double>(nr+m);
+				for (long j=0; j<nr; ++j) {
+					bestc[j]=pcoeff[rest[j]];
+					beste[j]=pexpnt[rest[j]];
+				}
+				bestc(Slice(nr,-1))=c;
+				beste(Slice(nr,-1))=e;
+				bestsaving=nd-m;
+				break;
+			}
+		}
+
+		if (prnt) print("reduced expansion from",npt,"to",bestc.dim(0),"terms");
+
+		// sort the exponents in the order of the input expansion
+		const long m=bestc.dim(0);
+		const bool decreasing=(pexpnt[0]>=pexpnt[npt-1]);
+		std::vector<long> order(m);
+		for (long j=0; j<m; ++j) order[j]=j;
+		std::sort(order.begin(),order.end(),[&](long i, long j) {
+			return decreasing ? (beste[i]>beste[j]) : (beste[i]<beste[j]);});
+		pcoeff=Tensor<double>(m);
+		pexpnt=Tensor<double>(m);
+		for (long j=0; j<m; ++j) {
+			pcoeff[j]=bestc[order[j]];
+			pexpnt[j]=beste[order[j]];
+		}
+	}
+
+	/// evaluate the expansion at r
+	static double eval(const Tensor<double>& coeff, const Tensor<double>& expnt,
+			const double r) {
+		double sum=0.0;
+		for (long j=0; j<coeff.dim(0); ++j) sum+=coeff[j]*exp(-expnt[j]*r*r);
+		return sum;
+	}
+
 	/// fit a Slater function using a sum of Gaussians
 
 	/// formula inspired by the BSH fit, with the roles of r and mu exchanged
@@ -453,6 +679,114 @@ private:
 		pexpnt = expnt;
 	}
 
+	/// fit the function erfc(omega r)/r
+
+	/// uses the integral representation
+	///  erfc(omega r)/r = 2/sqrt(pi) \int_omega^\infty exp(-r^2 t^2) dt
+	/// with the substitution t^2 = omega^2 + exp(2s), discretized by the
+	/// trapezoidal rule as in bsh_fit.  All terms with exp(2s) << omega^2
+	/// have exponents close to omega^2; this block is replaced by a few
+	/// terms, cf reduce_expansion.
+	static void erfc_fit(double omega, double lo, double hi, double eps,
+			Tensor<double>& pcoeff, Tensor<double>& pexpnt, bool prnt) {
+
+		hi=std::min(hi,erfc_range(omega,eps));
+		MADNESS_CHECK(lo<hi);
+
+		double TT;
+		if (eps >= 1e-2) TT = 5;
+		else if (eps >= 1e-4) TT = 10;
+		else if (eps >= 1e-6) TT = 14;
+		else if (eps >= 1e-8) TT = 18;
+		else if (eps >= 1e-10) TT = 22;
+		else if (eps >= 1e-12) TT = 26;
+		else TT = 30;
+
+		// the terms below slo contribute less than eps*f(r) for r<hi
+		double slo = 0.5*log(eps) - log(hi) - 1.0;
+		double shi = 0.5*log(TT/(lo*lo));
+
+		// same resolution and rounding as in bsh_fit
+		double h = 1.0/(0.2-.50*log10(eps));
+		h = floor(64.0*h)/64.0;
+		shi = ceil(shi/h)*h;
+		slo = floor(slo/h)*h;
+
+		long npt = long((shi-slo)/h+0.5);
+		Tensor<double> coeff(npt), expnt(npt);
+		for (int i=0; i<npt; ++i) {
+			const double s = slo + h*(npt-i);
+			const double e2s = exp(2.0*s);
+			coeff[i] = h*2.0/sqrt(constants::pi)*e2s/sqrt(omega*omega+e2s);
+			expnt[i] = omega*omega+e2s;
+		}
+
+		auto erfc_coulomb=[omega](double r) {return erfc(omega*r)/r;};
+		reduce_expansion(erfc_coulomb,lo,hi,eps,hi,coeff,expnt,prnt);
+
+		if (prnt) {
+			print("erfc fit with omega, lo, hi, eps",omega,lo,hi,eps);
+			for (long i=0; i<coeff.dim(0); ++i) print(i,coeff[i],expnt[i]);
+		}
+		pcoeff = coeff;
+		pexpnt = expnt;
+	}
+
+	/// fit the function erf(omega r)/r
+
+	/// uses the integral representation
+	///  erf(omega r)/r = 2/sqrt(pi) \int_0^omega exp(-r^2 t^2) dt
+	/// discretized by Gauss-Legendre quadrature on the intervals
+	/// [0,t0], [t0,2 t0], ..., [omega/2,omega] with t0*hi <= 1, so that each
+	/// interval resolves a fixed range of length scales r ~ 1/t.  The number
+	/// of points per interval is increased until the relative error on
+	/// [lo,hi] is below eps.
+	static void erf_fit(double omega, double lo, double hi, double eps,
+			Tensor<double>& pcoeff, Tensor<double>& pexpnt, bool prnt) {
+
+		MADNESS_CHECK(lo<hi);
+		std::vector<double> bounds(1,omega);
+		while (bounds.back()*hi>1.0) bounds.push_back(0.5*bounds.back());
+		bounds.push_back(0.0);
+		const long nint=bounds.size()-1;
+
+		// logarithmic grid for the error control
+		const long ngrid=long(16*log(hi/lo))+2;
+		const double step=log(hi/lo)/(ngrid-1);
+
+		auto erf_coulomb=[omega](double r) {return erf(omega*r)/r;};
+		Tensor<double> coeff, expnt;
+		for (int n=2; n<=64; ++n) {
+			coeff=Tensor<double>(n*nint);
+			expnt=Tensor<double>(n*nint);
+			std::vector<double> x(n), w(n);
+			for (long i=0; i<nint; ++i) {
+				MADNESS_CHECK(gauss_legendre(n,bounds[i+1],bounds[i],x.data(),w.data()));
+				for (int j=0; j<n; ++j) {		// decreasing exponents
+					coeff[i*n+n-1-j]=2.0/sqrt(constants::pi)*w[j];
+					expnt[i*n+n-1-j]=x[j]*x[j];
+				}
+			}
+			double err=0.0;
+			for (long i=0; i<ngrid; ++i) {
+				const double r=lo*exp(i*step);
+				const double exact=erf_coulomb(r);
+				err=std::max(err,std::abs(eval(coeff,expnt,r)-exact)/exact);
+			}
+			if (err<eps) break;
+			MADNESS_CHECK(n<64);
+		}
+
+		if (minimal_terms_) reduce_expansion(erf_coulomb,lo,hi,eps,lo,coeff,expnt,prnt);
+
+		if (prnt) {
+			print("erf fit with omega, lo, hi, eps",omega,lo,hi,eps);
+			for (long i=0; i<coeff.dim(0); ++i) print(i,coeff[i],expnt[i]);
+		}
+		pcoeff = coeff;
+		pexpnt = expnt;
+	}
+
 	void static bsh_fit_ndim(int ndim, double mu, double lo, double hi, double eps,
 			Tensor<double>& pcoeff, Tensor<double>& pexpnt, bool prnt) {
 
@@ -35,6 +35,7 @@ using std::endl;
 
 #include <cmath>
 #include <madness/mra/legendre.h>
+#include <madness/mra/mra_data.h>
 #include <madness/tensor/tensor.h>
 
 /// \file legendre.cc
@@ -91,6 +92,7 @@ namespace madness {
     }
 
     static bool data_is_read = false;
+    static bool use_embedded = false;  // If true read from the table compiled into the library
     static const int max_npt = 64;
 
     static const char *filename = "gaussleg";   // Is overridden by
@@ -101,8 +103,14 @@ namespace madness {
     /// read_data loads the precomputed Gauss-Legendre data
     static bool read_data() {
         if (data_is_read) return true;
-        FILE *f = fopen(filename,"r");
-        if (!f) {
+#ifdef MADNESS_HAS_EMBEDDED_MRA_DATA
+        detail::MRADataReader f = use_embedded ?
+            detail::MRADataReader(detail::mra_gaussleg_data, detail::mra_gaussleg_data_size) :
+            detail::MRADataReader(filename);
+#else
+        detail::MRADataReader f(filename);
+#endif
+        if (!f.good()) {
             cout << "legendre: read_data: could not find file " << filename << endl;
             return false;
         }
@@ -110,36 +118,39 @@ namespace madness {
             points[npt] = Tensor<double>(npt);
             weights[npt] = Tensor<double>(npt);
 
-            int nnpt;
-            if (fscanf(f,"%d",&nnpt) != 1) {
+            long nnpt;
+            if (!f.next(nnpt)) {
                 cout << "legendre: read_data: failed reading " << npt << endl;
-                fclose(f);
                 return false;
             }
             if (nnpt != npt) {
                 cout << "legendre: read_data: npt did not match " << npt << endl;
-                fclose(f);
                 return false;
             }
             for (int i=0; i<npt; ++i) {
-                int ii;
-                if (fscanf(f,"%d %lf %lf",&ii,&points[npt][i],&weights[npt][i]) != 3) {
+                long ii;
+                if (!(f.next(ii) && f.next(points[npt][i]) && f.next(weights[npt][i]))) {
                     cout << "legendre: read_data: failed reading data " << npt << " " << i << endl;
-                    fclose(f);
                     return false;
                 }
             }
         }
-        fclose(f);
         data_is_read = true;
         return true;
     }
 
     /// Collective routine to pre-load and cache the quadrature points and weights
 
-    /// Only process rank 0 will access the file.
+    /// Only process rank 0 will access the file.  If \c dir is null the
+    /// table compiled into the library is used by every process instead.
     void load_quadrature(World& world, const char* dir) {
         if (data_is_read) return;
+        if (!dir) {
+            MADNESS_CHECK(detail::have_embedded_mra_data());
+            use_embedded = true;
+            if (!read_data()) throw "load_quadrature: failed reading embedded quadrature coefficients";
+            return;
+        }
         if (world.rank() == 0) {
             char buf[32768];
             buf[0] = 0;
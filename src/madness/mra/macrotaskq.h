@@ -101,14 +101,153 @@ public:
 
 
 
-class MacroTaskQ : public WorldObject< MacroTaskQ> {
+/// a persistent set of subworlds that can be shared by many MacroTaskQs
+
+/// Splitting the universe communicator and setting up the process maps of
+/// the subworlds is expensive compared to short batches of macrotasks.
+/// A pool keeps the subworlds and their process maps alive between queues.
+///
+/// A pool is made active for a universe by holding on to the pointer returned
+/// by SubworldPool::create(); all MacroTaskQs constructed in that universe
+/// while the pool lives will use its subworlds, resizing the pool if they
+/// request a different number of subworlds.  Without an active pool every
+/// MacroTaskQ creates and destroys its own subworlds as before.
+///
+/// The pool must be destroyed before madness::finalize(), e.g.
+/// \code
+///   {
+///       auto pool=SubworldPool::create(universe,universe.size());
+///       exchange(...);     // any number of MacroTaskQs
+///       cc2(...);
+///   }
+///   finalize();
+/// \endcode
+class SubworldPool {
 
     World& universe;
+    std::size_t nsubworld=0;
     std::shared_ptr<World> subworld_ptr;
+    long nuse=0;
+
+    /// process maps for the subworld, made on first use and reused thereafter
+    std::shared_ptr< WorldDCPmapInterface< Key<1> > > pmap1;
+    std::shared_ptr< WorldDCPmapInterface< Key<2> > > pmap2;
+    std::shared_ptr< WorldDCPmapInterface< Key<3> > > pmap3;
+    std::shared_ptr< WorldDCPmapInterface< Key<4> > > pmap4;
+    std::shared_ptr< WorldDCPmapInterface< Key<5> > > pmap5;
+    std::shared_ptr< WorldDCPmapInterface< Key<6> > > pmap6;
+
+    /// the active pools, keyed by the id of their universe
+    static std::map<unsigned long, std::weak_ptr<SubworldPool> >& registry() {
+        static std::map<unsigned long, std::weak_ptr<SubworldPool> > pools;
+        return pools;
+    }
+
+    SubworldPool(World& universe, const std::size_t nworld) : universe(universe) {
+        resize(nworld);
+    }
+
+public:
+
+    SubworldPool(const SubworldPool&) = delete;
+    SubworldPool& operator=(const SubworldPool&) = delete;
+
+    ~SubworldPool() {
+        auto it=registry().find(universe.id());
+        if (it!=registry().end() and it->second.expired()) registry().erase(it);
+    }
+
+    /// create a pool and make it the active pool of the universe (collective)
+    static std::shared_ptr<SubworldPool> create(World& universe, const std::size_t nworld) {
+        std::shared_ptr<SubworldPool> pool(new SubworldPool(universe, nworld));
+        registry()[universe.id()]=pool;
+        return pool;
+    }
+
+    /// return the active pool of the universe, or a transient pool if there is none (collective)
+
+    /// an active pool is resized if it holds a different number of subworlds
+    static std::shared_ptr<SubworldPool> get(World& universe, const std::size_t nworld) {
+        auto it=registry().find(universe.id());
+        std::shared_ptr<SubworldPool> pool= (it==registry().end()) ? nullptr : it->second.lock();
+        if (not pool) return std::shared_ptr<SubworldPool>(new SubworldPool(universe, nworld));
+        if (pool->get_nsubworld()!=nworld) pool->resize(nworld);
+        pool->nuse++;
+        return pool;
+    }
+
+    /// change the number of subworlds (collective)
+
+    /// the old subworlds and their process maps are discarded, so this
+    /// must not be called while a taskq is running on the pool
+    void resize(const std::size_t nworld) {
+        MADNESS_CHECK(nworld>0);
+        if (nworld==nsubworld) return;
+        pmap1.reset(); pmap2.reset(); pmap3.reset();
+        pmap4.reset(); pmap5.reset(); pmap6.reset();
+        if (subworld_ptr) subworld_ptr->gop.fence();
+        subworld_ptr.reset();
+        subworld_ptr=split_universe(universe,nworld);
+        nsubworld=nworld;
+    }
+
+    World& get_universe() const {return universe;}
+    World& get_subworld() const {return *subworld_ptr;}
+    std::size_t get_nsubworld() const {return nsubworld;}
+
+    /// number of times the pool has been handed out to a taskq
+    long get_nuse() const {return nuse;}
+
+    /// set the default process maps of FunctionDefaults to the ones of the subworld
+    void set_pmap() {
+        if (not pmap1) {
+            World& subworld=get_subworld();
+            FunctionDefaults<1>::set_default_pmap(subworld);
+            FunctionDefaults<2>::set_default_pmap(subworld);
+            FunctionDefaults<3>::set_default_pmap(subworld);
+            FunctionDefaults<4>::set_default_pmap(subworld);
+            FunctionDefaults<5>::set_default_pmap(subworld);
+            FunctionDefaults<6>::set_default_pmap(subworld);
+            pmap1=FunctionDefaults<1>::get_pmap();
+            pmap2=FunctionDefaults<2>::get_pmap();
+            pmap3=FunctionDefaults<3>::get_pmap();
+            pmap4=FunctionDefaults<4>::get_pmap();
+            pmap5=FunctionDefaults<5>::get_pmap();
+            pmap6=FunctionDefaults<6>::get_pmap();
+        } else {
+            FunctionDefaults<1>::set_pmap(pmap1);
+            FunctionDefaults<2>::set_pmap(pmap2);
+            FunctionDefaults<3>::set_pmap(pmap3);
+            FunctionDefaults<4>::set_pmap(pmap4);
+            FunctionDefaults<5>::set_pmap(pmap5);
+            FunctionDefaults<6>::set_pmap(pmap6);
+        }
+    }
+
+private:
+    /// for each process create a world using a communicator shared with other processes by round-robin
+    /// copy-paste from test_world.cc
+    static std::shared_ptr<World> split_universe(World& universe, const std::size_t nsubworld) {
+		int color = universe.rank() % nsubworld;
+		SafeMPI::Intracomm comm = universe.mpi.comm().Split(color, universe.rank() / nsubworld);
+
+		std::shared_ptr<World> all_worlds;
+		all_worlds.reset(new World(comm));
+
+		universe.gop.fence();
+		return all_worlds;
+    }
+    friend class MacroTaskQ;
+};
+
+
+class MacroTaskQ : public WorldObject< MacroTaskQ> {
+
+    World& universe;
+    std::shared_ptr<SubworldPool> pool;
 	MacroTaskBase::taskqT taskq;
 	std::mutex taskq_mutex;
 	long printlevel=0;
-	long nsubworld=1;
     std::shared_ptr< WorldDCPmapInterface< Key<1> > > pmap1;
     std::shared_ptr< WorldDCPmapInterface< Key<2> > > pmap2;
     std::shared_ptr< WorldDCPmapInterface< Key<3> > > pmap3;
@@ -122,33 +261,33 @@ class MacroTaskQ : public WorldObject< MacroTaskQ> {
 public:
 
 	madness::Cloud cloud;
-	World& get_subworld() {return *subworld_ptr;}
-	long get_nsubworld() const {return nsubworld;}
+	World& get_subworld() {return pool->get_subworld();}
+	long get_nsubworld() const {return pool->get_nsubworld();}
 	void set_printlevel(const long p) {printlevel=p;}
 
     /// create an empty taskq and initialize the subworlds
+
+    /// the subworlds are taken from the active SubworldPool of the universe
+    /// if there is one, otherwise they are created for this taskq only
 	MacroTaskQ(World& universe, int nworld, const long printlevel=0)
-		  : universe(universe), WorldObject<MacroTaskQ>(universe), taskq(), cloud(universe), printlevel(printlevel),
-		    nsubworld(nworld) {
+		  : universe(universe), WorldObject<MacroTaskQ>(universe), pool(SubworldPool::get(universe,nworld)),
+		    taskq(), cloud(universe), printlevel(printlevel) {
+		this->process_pending();
+	}
 
-		subworld_ptr=create_worlds(universe,nworld);
+    /// create an empty taskq running on the subworlds of the given pool
+	MacroTaskQ(World& universe, const std::shared_ptr<SubworldPool>& pool, const long printlevel=0)
+		  : universe(universe), WorldObject<MacroTaskQ>(universe), pool(pool),
+		    taskq(), cloud(universe), printlevel(printlevel) {
+		MADNESS_CHECK(pool and pool->get_universe().id()==universe.id());
 		this->process_pending();
 	}
 
 	~MacroTaskQ() {}
 
 	/// for each process create a world using a communicator shared with other processes by round-robin
-	/// copy-paste from test_world.cc
 	static std::shared_ptr<World> create_worlds(World& universe, const std::size_t nsubworld) {
-
-		int color = universe.rank() % nsubworld;
-		SafeMPI::Intracomm comm = universe.mpi.comm().Split(color, universe.rank() / nsubworld);
-
-		std::shared_ptr<World> all_worlds;
-		all_worlds.reset(new World(comm));
-
-		universe.gop.fence();
-		return all_worlds;
+		return SubworldPool::split_universe(universe,nsubworld);
 	}
 
 	/// run all tasks, tasks may store the results in the cloud
@@ -167,7 +306,7 @@ public:
         pmap4=FunctionDefaults<4>::get_pmap();
         pmap5=FunctionDefaults<5>::get_pmap();
         pmap6=FunctionDefaults<6>::get_pmap();
-        set_pmap(get_subworld());
+        pool->set_pmap();
 
         double cpu00=cpu_time();
 
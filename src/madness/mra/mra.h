@@ -357,6 +357,31 @@ namespace madness {
             return impl->eval_plot_cube(simlo, simhi, npt, eval_refine);
         }
 
+        /// Evaluates the function at a list of points in user coordinates ... collective but no fence necessary
+
+        /// The points are grouped by the leaf boxes holding them and each box
+        /// evaluates its points with a single contraction of its coefficients,
+        /// which is much faster than calling eval() point by point.  All
+        /// processes must pass the same points and receive all values.
+        /// @param[in] xuser the points
+        /// @return the values, in the order of the points
+        Tensor<T> eval_points(const std::vector<coordT>& xuser) const {
+            PROFILE_MEMBER_FUNC(Function);
+            const double eps=1e-15;
+            verify();
+            reconstruct();
+            std::vector<coordT> xsim(xuser.size());
+            for (std::size_t i=0; i<xuser.size(); ++i) {
+                user_to_sim(xuser[i],xsim[i]);
+                for (std::size_t d=0; d<NDIM; ++d) {
+                    if (xsim[i][d] < -eps or xsim[i][d] > 1.0+eps) {
+                        MADNESS_EXCEPTION("eval_points: coordinate out of bounds in dimension", d);
+                    }
+                }
+            }
+            return impl->eval_points(xsim);
+        }
+
 
         /// Evaluates the function at a point in user coordinates.  Collective operation.
 
@@ -500,6 +525,13 @@ namespace madness {
             impl->print_size(name);
         }
 
+        /// Returns sizes, depth and norm of the tree ... one traversal, one global reduction
+        FunctionTreeStats tree_stats() const {
+            PROFILE_MEMBER_FUNC(Function);
+            if (!impl) return FunctionTreeStats();
+            return impl->tree_stats();
+        }
+
         /// Returns the maximum depth of the function tree ... collective global sum
         std::size_t max_depth() const {
             PROFILE_MEMBER_FUNC(Function);
@@ -703,6 +735,17 @@ namespace madness {
             const_cast<Function<T,NDIM>*>(this)->impl->norm_tree(fence);
         }
 
+        /// Initializes norm_tree and returns the statistics of the tree in the same traversal
+
+        /// Replaces the sequence norm_tree(), tree_size(), max_depth(),
+        /// size() ... collective with fence
+        FunctionTreeStats norm_tree_stats() const {
+            PROFILE_MEMBER_FUNC(Function);
+            verify();
+            if (!is_reconstructed()) reconstruct();
+            return const_cast<Function<T,NDIM>*>(this)->impl->norm_tree_stats();
+        }
+
 
         /// Compresses the function, transforming into wavelet basis.  Possible non-blocking comm.
 
@@ -735,6 +778,7 @@ namespace madness {
         /// world.gop.fence() to assure global completion before using the function
         /// for other purposes.
         ///
+        /// A compressed function is converted in a single downward pass.
         /// Noop if already compressed or if not initialized.
         void make_nonstandard(bool keepleaves, bool fence=true) const {
             PROFILE_MEMBER_FUNC(Function);
@@ -743,6 +787,10 @@ namespace madness {
             if (impl->is_nonstandard_with_leaves()) return;
 
             if (VERIFY_TREE) verify_tree();
+            if (is_compressed()) {
+                const_cast<Function<T,NDIM>*>(this)->impl->nonstandard_from_compressed(keepleaves, fence);
+                return;
+            }
             if (!is_reconstructed()) reconstruct();
             TreeState newstate=TreeState::nonstandard;
             if (keepleaves) newstate=nonstandard_with_leaves;
@@ -1406,6 +1454,44 @@ namespace madness {
             return result;
         }
 
+        /// project this on several low-dim functions: h_i(x) = <f(x,y) | g_i(y)>
+
+        /// Same as project_out for each g_i, but the tree of this is traversed only once
+        /// @param[in]  g   low-dim functions
+        /// @param[in]  dim over which dimensions to be integrated: 0..LDIM-1 or LDIM..NDIM-1
+        /// @return     new functions of dimension NDIM-LDIM
+        template <typename R, size_t LDIM>
+        std::vector<Function<TENSOR_RESULT_TYPE(T,R),NDIM-LDIM> >
+        project_out(const std::vector<Function<R,LDIM> >& g, const int dim) const {
+            if (NDIM<=LDIM) MADNESS_EXCEPTION("confused dimensions in project_out?",1);
+            MADNESS_ASSERT(dim==0 or dim==1);
+            verify();
+            typedef TENSOR_RESULT_TYPE(T,R) resultT;
+            static const size_t KDIM=NDIM-LDIM;
+
+            std::vector<Function<resultT,KDIM> > result(g.size());
+            std::vector<FunctionImpl<resultT,KDIM>*> rimpl(g.size());
+            std::vector<const FunctionImpl<R,LDIM>*> gimpl(g.size());
+            for (std::size_t i=0; i<g.size(); ++i) {
+                result[i]=FunctionFactory<resultT,KDIM>(world()).k(g[i].k()).thresh(g[i].thresh());
+                rimpl[i]=result[i].get_impl().get();
+                gimpl[i]=g[i].get_impl().get();
+            }
+
+            // g may contain the same function several times
+            std::set<FunctionImpl<R,LDIM>*> unique_gimpl;
+            for (const Function<R,LDIM>& gi : g) unique_gimpl.insert(gi.get_impl().get());
+
+            this->reconstruct();
+            for (FunctionImpl<R,LDIM>* gi : unique_gimpl) gi->make_redundant(false);
+            world().gop.fence();
+            this->get_impl()->project_out(rimpl,gimpl,dim,true);
+            for (Function<resultT,KDIM>& r : result) r.get_impl()->trickle_down(false);
+            for (FunctionImpl<R,LDIM>* gi : unique_gimpl) gi->undo_redundant(false);
+            world().gop.fence();
+            return result;
+        }
+
         template<std::size_t LDIM>
         Function<T,LDIM> dirac_convolution(const bool fence=true) const {
 //        	// this will be the result function
@@ -1842,6 +1928,50 @@ namespace madness {
     }
 
 
+    /// Performs the sum of the Hartree products of pairs of low-dimensional functions
+
+    /// \f[ result(1,2) = \sum_i left_i(1) right_i(2) \f]
+    /// The result tree is traversed only once, its coefficients are made in low-rank form
+    template<typename T, std::size_t KDIM, std::size_t LDIM>
+    Function<T,KDIM+LDIM>
+    hartree_product(const std::vector<Function<T,KDIM> >& left, const std::vector<Function<T,LDIM> >& right) {
+        MADNESS_ASSERT(left.size()==right.size());
+        MADNESS_ASSERT(left.size()>0);
+        World& world=left.front().world();
+
+        const double thresh=FunctionDefaults<KDIM+LDIM>::get_thresh();
+        Function<T,KDIM+LDIM> result=FunctionFactory<T,KDIM+LDIM>(world)
+                .k(left.front().k()).thresh(thresh).empty();
+
+        // we need both sum and difference coeffs for error estimation
+        std::vector<const FunctionImpl<T,KDIM>*> limpl;
+        std::vector<const FunctionImpl<T,LDIM>*> rimpl;
+        std::set<const void*> ns;
+        for (const Function<T,KDIM>& f : left) {
+            limpl.push_back(f.get_impl().get());
+            if (ns.insert(f.get_impl().get()).second) f.make_nonstandard(true,false);
+        }
+        for (const Function<T,LDIM>& f : right) {
+            rimpl.push_back(f.get_impl().get());
+            if (ns.insert(f.get_impl().get()).second) f.make_nonstandard(true,false);
+        }
+        world.gop.fence();
+
+        hartree_leaf_op<T,KDIM+LDIM> leaf_op(result.get_impl().get(),result.k());
+        result.get_impl()->hartree_product(limpl,rimpl,leaf_op,true);
+        result.truncate(0.0,false);
+
+        ns.clear();
+        for (const Function<T,KDIM>& f : left)
+            if (ns.insert(f.get_impl().get()).second) const_cast<Function<T,KDIM>&>(f).standard(false);
+        for (const Function<T,LDIM>& f : right)
+            if (ns.insert(f.get_impl().get()).second) const_cast<Function<T,LDIM>&>(f).standard(false);
+        world.gop.fence();
+
+        return result;
+    }
+
+
     /// Performs a Hartree product on the two given low-dimensional functions
     template<typename T, std::size_t KDIM, std::size_t LDIM, typename opT>
     Function<T,KDIM+LDIM>
@@ -2122,7 +2252,9 @@ namespace madness {
 
     /// Apply operator in non-standard form
 
-    /// Returns a new function with the same distribution
+    /// Returns a new function with the same distribution.  The input is
+    /// left in compressed form; applying another operator to it then converts
+    /// it to the nonstandard form in a single pass, cf make_nonstandard.
     ///
     /// !!! For the moment does NOT respect fence option ... always fences
     template <typename opT, typename R, std::size_t NDIM>
@@ -2138,11 +2270,11 @@ namespace madness {
 //        bool print_timings=false;
 
     	if (VERIFY_TREE) ff.verify_tree();
-    	ff.reconstruct();
-        if (print_timings) ff.print_size("ff in apply after reconstruct");
 
     	if (op.modified()) {
 
+    	    ff.reconstruct();
+            if (print_timings) ff.print_size("ff in apply after reconstruct");
     		MADNESS_ASSERT(not op.is_slaterf12);
     	    ff.get_impl()->make_redundant(true);
             result = apply_only(op, ff, fence);
@@ -2168,7 +2300,7 @@ namespace madness {
                 fff.get_impl()->timer_filter.print("filter");
                 fff.get_impl()->timer_compress_svd.print("compress_svd");
             }
-            result = apply_only(op, fff, fence);
+            result = apply_only(op, fff, false);
         	ff.world().gop.fence();
             if (print_timings) result.print_size("result after apply_only");
 
@@ -2182,14 +2314,15 @@ namespace madness {
 				op.print_timer();
 			}
 
-            result.reconstruct();
+            // reconstruct the result and restore the input with a single fence
+            result.reconstruct(false);
 //            fff.clear();
             if (op.destructive()) {
-            	ff.world().gop.fence();
-            	ff.clear();
+            	ff.clear(false);
             } else {
-            	ff.standard();
+            	ff.standard(false);
             }
+        	result.world().gop.fence();
         	if (op.is_slaterf12) result=(result-ftrace).scale(-0.5/op.mu());
 
     	}
@@ -49,29 +49,6 @@ namespace madness {
     template void fcube<std::complex<double>,2>(const Key<2>&, const FunctionFunctorInterface<std::complex<double>,2>&, const Tensor<double>&, Tensor<std::complex<double> >&);
     template Tensor<std::complex<double> > fcube<std::complex<double>, 2>(Key<2> const&, std::complex<double> (*)(Vector<double, 2> const&), Tensor<double> const&);
  
-    template <> volatile std::list<detail::PendingMsg> WorldObject<FunctionImpl<double,2> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<FunctionImpl<double,2> >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<madness::FunctionImpl<std::complex<double>, 2> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<FunctionImpl<std::complex<double>, 2> >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<Key<2>, FunctionNode<double, 2>, Hash<Key<2> > > >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<WorldContainerImpl<Key<2>, FunctionNode<double, 2>, Hash<Key<2> > > >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<Key<2>, FunctionNode<std::complex<double>, 2>, Hash<Key<2> > > >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<WorldContainerImpl<Key<2>, FunctionNode<std::complex<double>, 2>, Hash<Key<2> > > >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<DerivativeBase<double,2> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<DerivativeBase<double,2> >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<DerivativeBase<std::complex<double>,2> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<DerivativeBase<std::complex<double>,2> >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<madness::SeparatedConvolution<double,2> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock madness::WorldObject<madness::SeparatedConvolution<double,2> >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<madness::SeparatedConvolution<std::complex<double>,2> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock madness::WorldObject<madness::SeparatedConvolution<std::complex<double>,2> >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<Key<2>, LBNodeDeux<2>, Hash<Key<2> > > >::pending = std::list<detail::PendingMsg>();
-    template <>  Spinlock WorldObject<WorldContainerImpl<Key<2>, LBNodeDeux<2>, Hash<Key<2> > > >::pending_mutex(0);
-
     // These implicit instantiations must be below the explicit ones above in order not to offend LLVM
     template class FunctionDefaults<2>;
     template class Function<double, 2>;
@@ -49,29 +49,6 @@ namespace madness {
     template void fcube<std::complex<double>,5>(const Key<5>&, const FunctionFunctorInterface<std::complex<double>,5>&, const Tensor<double>&, Tensor<std::complex<double> >&);
     template Tensor<std::complex<double> > fcube<std::complex<double>, 5>(Key<5> const&, std::complex<double> (*)(Vector<double, 5> const&), Tensor<double> const&);
 
-    template <> volatile std::list<detail::PendingMsg> WorldObject<FunctionImpl<double,5> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<FunctionImpl<double,5> >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<madness::FunctionImpl<std::complex<double>, 5> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<FunctionImpl<std::complex<double>, 5> >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<Key<5>, FunctionNode<double, 5>, Hash<Key<5> > > >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<WorldContainerImpl<Key<5>, FunctionNode<double, 5>, Hash<Key<5> > > >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<Key<5>, FunctionNode<std::complex<double>, 5>, Hash<Key<5> > > >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<WorldContainerImpl<Key<5>, FunctionNode<std::complex<double>, 5>, Hash<Key<5> > > >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<DerivativeBase<double,5> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<DerivativeBase<double,5> >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<DerivativeBase<std::complex<double>,5> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock WorldObject<DerivativeBase<std::complex<double>,5> >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<madness::SeparatedConvolution<double,5> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock madness::WorldObject<madness::SeparatedConvolution<double,5> >::pending_mutex(0);
-    template <> volatile std::list<detail::PendingMsg> WorldObject<madness::SeparatedConvolution<std::complex<double>,5> >::pending = std::list<detail::PendingMsg>();
-    template <> Spinlock madness::WorldObject<madness::SeparatedConvolution<std::complex<double>,5> >::pending_mutex(0);
-
-    template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<Key<5>, LBNodeDeux<5>, Hash<Key<5> > > >::pending = std::list<detail::PendingMsg>();
-    template <>  Spinlock WorldObject<WorldContainerImpl<Key<5>, LBNodeDeux<5>, Hash<Key<5> > > >::pending_mutex(0);
-
     // These implicit instantiations must be below the explicit ones above in order not to offend LLVM
     template class FunctionDefaults<5>;
     template class Function<double, 5>;
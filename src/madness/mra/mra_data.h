@@ -0,0 +1,106 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+#ifndef MADNESS_MRA_MRA_DATA_H__INCLUDED
+#define MADNESS_MRA_MRA_DATA_H__INCLUDED
+
+/// \file mra_data.h
+/// \brief Access to the MRA data tables either from file or compiled into the library
+
+#include <madness/madness_config.h>
+#include <cstddef>
+#include <cstdio>
+
+namespace madness {
+    namespace detail {
+
+#ifdef MADNESS_HAS_EMBEDDED_MRA_DATA
+        // Generated from the data files by gen_mra_data.py into mra_data.cc
+        extern const double mra_twoscale_data[];
+        extern const std::size_t mra_twoscale_data_size;
+        extern const double mra_autocorr_data[];
+        extern const std::size_t mra_autocorr_data_size;
+        extern const double mra_gaussleg_data[];
+        extern const std::size_t mra_gaussleg_data_size;
+#endif
+
+        /// Returns true if the data tables were compiled into the library
+        bool have_embedded_mra_data();
+
+        /// Sequential reader of whitespace separated numbers from either a data file or an embedded table
+
+        /// Integer fields (e.g., the indices in autocorr) are read as
+        /// doubles, which represents them exactly.
+        class MRADataReader {
+            FILE* file;
+            const double* data;
+            std::size_t size;
+            std::size_t pos;
+
+            MRADataReader(const MRADataReader&) = delete;
+            MRADataReader& operator=(const MRADataReader&) = delete;
+
+        public:
+            /// Reads from the named file
+            explicit MRADataReader(const char* filename)
+                : file(fopen(filename,"r")), data(0), size(0), pos(0) {}
+
+            /// Reads from an embedded table of \c size entries
+            MRADataReader(const double* data, std::size_t size)
+                : file(0), data(data), size(size), pos(0) {}
+
+            ~MRADataReader() {if (file) fclose(file);}
+
+            /// Returns true if the source could be opened
+            bool good() const {return file || data;}
+
+            /// Reads the next number into \c x returning false at the end of data or on error
+            bool next(double& x) {
+                if (file) return fscanf(file,"%lf",&x) == 1;
+                if (pos < size) {
+                    x = data[pos++];
+                    return true;
+                }
+                return false;
+            }
+
+            /// Reads the next number as an integer
+            bool next(long& i) {
+                double x;
+                if (!next(x)) return false;
+                i = long(x);
+                return true;
+            }
+        };
+    }
+}
+
+#endif // MADNESS_MRA_MRA_DATA_H__INCLUDED
@@ -1048,9 +1048,9 @@ namespace madness {
             const keyT& key = it->first;
             const nodeT& node = it->second;
             if (node.has_coeff()) {
-                Future<argT> left  = D->find_neighbor(f, key,-1);
+                Future<argT> left  = D->find_neighbor(f, this, key,-1);
                 argT center(key,node.coeff());
-                Future<argT> right = D->find_neighbor(f, key, 1);
+                Future<argT> right = D->find_neighbor(f, this, key, 1);
                 world.taskq.add(*this, &implT::do_diff1, D, f, key, left, center, right, TaskAttributes::hipri());
             }
             else {
@@ -1576,46 +1576,11 @@ namespace madness {
     template <typename T, std::size_t NDIM>
     void FunctionImpl<T,NDIM>::norm_tree(bool fence) {
         if (world.rank() == coeffs.owner(cdata.key0))
-            norm_tree_spawn(cdata.key0);
+            upsweep_spawn(cdata.key0,do_norm_tree());
         if (fence)
             world.gop.fence();
     }
 
-    template <typename T, std::size_t NDIM>
-    double FunctionImpl<T,NDIM>::norm_tree_op(const keyT& key, const std::vector< Future<double> >& v) {
-        //PROFILE_MEMBER_FUNC(FunctionImpl);
-        double sum = 0.0;
-        int i=0;
-        for (KeyChildIterator<NDIM> kit(key); kit; ++kit,++i) {
-            double value = v[i].get();
-            sum += value*value;
-        }
-        sum = sqrt(sum);
-        coeffs.task(key, &nodeT::set_norm_tree, sum); // why a task? because send is deprecated to keep comm thread free
-        //if (key.level() == 0) std::cout << "NORM_TREE_TOP " << sum << "\n";
-        return sum;
-    }
-
-    template <typename T, std::size_t NDIM>
-    Future<double> FunctionImpl<T,NDIM>::norm_tree_spawn(const keyT& key) {
-        nodeT& node = coeffs.find(key).get()->second;
-        if (node.has_children()) {
-            std::vector< Future<double> > v = future_vector_factory<double>(1<<NDIM);
-            int i=0;
-            for (KeyChildIterator<NDIM> kit(key); kit; ++kit,++i) {
-                v[i] = woT::task(coeffs.owner(kit.key()), &implT::norm_tree_spawn, kit.key());
-            }
-            return woT::task(world.rank(),&implT::norm_tree_op, key, v);
-        }
-        else {
-            //                return Future<double>(node.coeff().normf());
-            const double norm=node.coeff().normf();
-            // invoked locally anyways
-            node.set_norm_tree(norm);
-            return Future<double>(norm);
-        }
-    }
-
     /// truncate using a tree in reconstructed form
 
     /// must be invoked where key is local
@@ -1795,6 +1760,51 @@ namespace madness {
     }
 
 
+    template <typename T, std::size_t NDIM>
+    void FunctionImpl<T,NDIM>::nonstandard_from_compressed(bool keepleaves, bool fence) {
+        MADNESS_CHECK(is_compressed());
+        // Must set here so that successive calls without fence do the right thing
+        set_tree_state(keepleaves ? nonstandard_with_leaves : nonstandard);
+        if (world.rank() == coeffs.owner(cdata.key0))
+            woT::task(world.rank(), &implT::nonstandard_from_compressed_op, cdata.key0, coeffT(), keepleaves);
+        if (fence) world.gop.fence();
+    }
+
+    template <typename T, std::size_t NDIM>
+    void FunctionImpl<T,NDIM>::nonstandard_from_compressed_op(const keyT& key, const coeffT& s,
+                                                              bool keepleaves) {
+        typename dcT::iterator it = coeffs.find(key).get();
+        MADNESS_ASSERT(it != coeffs.end());
+        nodeT& node = it->second;
+
+        if (node.has_children()) {
+            // interior nodes keep the sum and the difference coefficients
+            coeffT d = node.coeff();
+            if (!d.has_data()) d = coeffT(cdata.v2k,targs);
+            if (key.level() > 0) {
+                d(cdata.s0) += s;       // -- note accumulate for NS summation
+                d.reduce_rank(targs.thresh);
+            }
+            node.set_coeff(d);
+            coeffT u = unfilter(d);
+            for (KeyChildIterator<NDIM> kit(key); kit; ++kit) {
+                const keyT& child = kit.key();
+                coeffT ss = copy(u(child_patch(child)));
+                ss.reduce_rank(targs.thresh);
+                woT::task(coeffs.owner(child), &implT::nonstandard_from_compressed_op, child, ss, keepleaves);
+            }
+        }
+        else if (key.level() == 0) {
+            return;     // a single box is its own nonstandard form
+        }
+        else if (keepleaves) {
+            node.set_coeff(s);
+        }
+        else {
+            node.clear_coeff();
+        }
+    }
+
     /// after apply we need to do some cleanup;
     template <typename T, std::size_t NDIM>
     double FunctionImpl<T,NDIM>::finalize_apply(const bool fence) {
@@ -1957,25 +1967,8 @@ namespace madness {
     /// print tree size and size
     template <typename T, std::size_t NDIM>
     void FunctionImpl<T,NDIM>::print_size(const std::string name) const {
-        const size_t tsize=this->tree_size();
-//        const size_t size=this->size();
-        const size_t ncoeff=this->nCoeff();
-        const double wall=wall_time();
-        const double d=sizeof(T);
-        const double fac=1024*1024*1024;
-
-        double norm=0.0;
-        {
-            double local = norm2sq_local();
-            this->world.gop.sum(local);
-            this->world.gop.fence();
-            norm=sqrt(local);
-        }
-
-        if (this->world.rank()==0) {
-            printf("%40s at time %.1fs: norm/tree/#coeff/size: %7.5f %zu, %6.3f m, %6.3f GByte\n",
-                   (name.c_str()), wall, norm, tsize,double(ncoeff)*1.e-6,double(ncoeff)/fac*d);
-        }
+        const FunctionTreeStats stats=tree_stats();
+        if (this->world.rank()==0) stats.print_size(name,sizeof(T));
     }
 
     /// print the number of configurations per node
@@ -2800,6 +2793,24 @@ namespace madness {
         }
     }
 
+    template <typename T, std::size_t NDIM>
+    std::vector< std::pair<Key<NDIM>,GenTensor<T> > >
+    FunctionImpl<T,NDIM>::find_nodes(const std::vector<keyT>& keys) const {
+        std::vector< std::pair<keyT,coeffT> > result;
+        result.reserve(keys.size());
+        for (const keyT& key : keys) {
+            if (coeffs.probe(key)) {
+                const nodeT& node = coeffs.find(key).get()->second;
+                if (node.has_coeff()) result.push_back(std::pair<keyT,coeffT>(key,node.coeff()));
+                else result.push_back(std::pair<keyT,coeffT>(key,coeffT()));
+            }
+            else {
+                result.push_back(std::pair<keyT,coeffT>(keyT::invalid(),coeffT()));
+            }
+        }
+        return result;
+    }
+
     // like sock_it_to_me, but it replaces empty node with averaged coeffs from further down the tree
     template <typename T, std::size_t NDIM>
     void FunctionImpl<T,NDIM>::sock_it_to_me_too(const keyT& key,
@@ -3342,6 +3353,98 @@ template <typename T, std::size_t NDIM>
         return r;
     }
 
+    template <typename T, std::size_t NDIM>
+    void FunctionImpl<T,NDIM>::eval_points_kernel(archive::archive_ptr< Tensor<T> > ptr,
+                                                  const keyT& key,
+                                                  const std::vector<coordT>& xsim,
+                                                  const std::vector<long>& index) const {
+        Tensor<T>& r = *ptr;
+        const int k = cdata.k;
+        const long npt = xsim.size();
+        const Level n = key.level();
+        const Vector<Translation,NDIM>& l = key.translation();
+        const double twon = pow(2.0,double(n));
+        const tensorT coeff = coeffs.find(key).get()->second.coeff().full_tensor_copy();
+
+        // scaling functions of all points, one (npt,k) matrix per dimension
+        std::vector< Tensor<double> > phi;
+        for (std::size_t d=0; d<NDIM; ++d) {
+            phi.push_back(Tensor<double>(npt,long(k)));
+            for (long p=0; p<npt; ++p) {
+                double x = twon*xsim[p][d] - l[d]; // Offset within box
+                x = std::min(std::max(x,0.0),1.0);
+                legendre_scaling_functions(x,k,&phi[d](p,0));
+            }
+        }
+
+        // the first dimension for all points at once: (npt,k^(NDIM-1))
+        Tensor<T> tmp = inner(phi[0],coeff);
+
+        // the remaining dimensions point by point, in place
+        const long blocksize = tmp.size()/npt;
+        const double scale = pow(2.0,0.5*NDIM*n)/sqrt(FunctionDefaults<NDIM>::get_cell_volume());
+        for (long p=0; p<npt; ++p) {
+            T* MADNESS_RESTRICT t = tmp.ptr() + p*blocksize;
+            long size = blocksize;
+            for (std::size_t d=1; d<NDIM; ++d) {
+                size /= k;
+                const double* ph = phi[d].ptr() + p*k;
+                for (long j=0; j<size; ++j) {
+                    T s = ph[0]*t[j];
+                    for (int i=1; i<k; ++i) s += ph[i]*t[i*size+j];
+                    t[j] = s;
+                }
+            }
+            r(index[p]) = t[0]*scale;
+        }
+    }
+
+    template <typename T, std::size_t NDIM>
+    Tensor<T> FunctionImpl<T,NDIM>::eval_points(const std::vector<coordT>& xsim) const {
+        PROFILE_MEMBER_FUNC(FunctionImpl);
+        MADNESS_ASSERT(is_reconstructed());
+        Tensor<T> r(long(xsim.size()));
+
+        // levels of the local leaves
+        std::set<Level> levels;
+        for (typename dcT::const_iterator it=coeffs.begin(); it!=coeffs.end(); ++it) {
+            if (it->second.has_coeff()) levels.insert(it->first.level());
+        }
+
+        // sort the points into boxes on each of these levels
+        std::map<keyT, std::vector<long> > boxes;
+        for (Level n : levels) {
+            const double twon = pow(2.0,double(n));
+            const Translation lmax = (Translation(1)<<n) - 1;
+            for (std::size_t i=0; i<xsim.size(); ++i) {
+                Vector<Translation,NDIM> l;
+                for (std::size_t d=0; d<NDIM; ++d) {
+                    l[d] = std::min(std::max(Translation(xsim[i][d]*twon),Translation(0)),lmax);
+                }
+                boxes[keyT(n,l)].push_back(i);
+            }
+        }
+
+        // one task for every local leaf that contains points
+        for (typename dcT::const_iterator it=coeffs.begin(); it!=coeffs.end(); ++it) {
+            const keyT& key = it->first;
+            if (not it->second.has_coeff()) continue;
+            typename std::map<keyT, std::vector<long> >::const_iterator box = boxes.find(key);
+            if (box == boxes.end()) continue;
+            std::vector<coordT> x;
+            x.reserve(box->second.size());
+            for (long i : box->second) x.push_back(xsim[i]);
+            woT::task(world.rank(), &implT::eval_points_kernel,
+                      archive::archive_ptr< Tensor<T> >(&r), key, x, box->second);
+        }
+
+        world.taskq.fence();
+        world.gop.sum(r.ptr(), r.size());
+        world.gop.fence();
+
+        return r;
+    }
+
     static inline void dxprintvalue(FILE* f, const double t) {
         fprintf(f,"%.6e\n",t);
     }
@@ -3508,6 +3611,7 @@ template <typename T, std::size_t NDIM>
 
     template <std::size_t NDIM> std::vector< Key<NDIM> > Displacements<NDIM>::disp;
     template <std::size_t NDIM> std::vector< Key<NDIM> > Displacements<NDIM>::disp_periodicsum[64];
+    template <std::size_t NDIM> std::once_flag Displacements<NDIM>::disp_once;
 
 }
 
@@ -83,12 +83,50 @@ namespace madness {
 		}
 	}
 
+	/// Reduces the memory held by an item of a KAIN subspace
+
+	/// The subspace keeps maxsub solution and residual vectors, which for
+	/// large sets of orbitals dominates the memory of an SCF calculation.
+	/// Only the current iterate enters the next update with weight close to
+	/// one, so the history can be stored at a looser truncation threshold.
+	/// The item is owned by the subspace; it is modified in place.
+	/// Types without an overload are stored unchanged.
+	template <typename T>
+	void reduce_subspace_storage(T& item, const double tol) {}
+
+	template <typename T, std::size_t NDIM>
+	void reduce_subspace_storage(Function<T,NDIM>& f, const double tol) {
+		f.truncate(tol);
+	}
+
+	template <typename T, std::size_t NDIM>
+	void reduce_subspace_storage(std::vector<Function<T,NDIM> >& v, const double tol) {
+		if (v.size()>0) truncate(v[0].world(), v, tol);
+	}
+
+	/// Returns a copy of \c item which does not share data with \c item
+
+	/// Function handles are shallow, so the subspace must not truncate the
+	/// caller's iterate in place.
+	template <typename T>
+	T deep_copy_subspace_item(const T& item) {return item;}
+
+	template <typename T, std::size_t NDIM>
+	Function<T,NDIM> deep_copy_subspace_item(const Function<T,NDIM>& f) {return copy(f);}
+
+	template <typename T, std::size_t NDIM>
+	std::vector<Function<T,NDIM> > deep_copy_subspace_item(const std::vector<Function<T,NDIM> >& v) {
+		if (v.size()==0) return v;
+		return copy(v[0].world(), v);
+	}
+
 	/// A simple Krylov-subspace nonlinear equation solver
 
     /// \ingroup nonlinearsolve
 	template<size_t NDIM>
 	class NonlinearSolverND {
 		unsigned int maxsub; ///< Maximum size of subspace dimension
+		double subspace_thresh; ///< Truncation threshold of the stored history, 0 keeps it unchanged
 
 		std::vector<Function<double,NDIM> > ulist, rlist;
 		real_tensor Q;
@@ -103,7 +141,10 @@ namespace madness {
 		}
 		bool do_print;
 
-		NonlinearSolverND(unsigned int maxsub = 10) : maxsub(maxsub), do_print(false) {}
+		NonlinearSolverND(unsigned int maxsub = 10) : maxsub(maxsub), subspace_thresh(0.0), do_print(false) {}
+
+		/// Store the subspace history truncated at \c thresh (e.g. 10*thresh of the functions); 0 disables
+		void set_subspace_thresh(const double thresh) {subspace_thresh = thresh;}
 
 		/// Computes next trial solution vector
 
@@ -143,6 +184,13 @@ namespace madness {
 			}
 			unew.truncate();
 
+			if (subspace_thresh>0.0) {
+				ulist.back() = deep_copy_subspace_item(ulist.back());
+				rlist.back() = deep_copy_subspace_item(rlist.back());
+				reduce_subspace_storage(ulist.back(),subspace_thresh);
+				reduce_subspace_storage(rlist.back(),subspace_thresh);
+			}
+
 			if (ulist.size() == maxsub) {
 				ulist.erase(ulist.begin());
 				rlist.erase(rlist.begin());
@@ -180,6 +228,7 @@ namespace madness {
     template <class T, class C = double, class Alloc = default_allocator<T> >
     class XNonlinearSolver {
         unsigned int maxsub; ///< Maximum size of subspace dimension
+        double subspace_thresh; ///< Truncation threshold of the stored history, 0 keeps it unchanged
         Alloc alloc;
         std::vector<T> ulist, rlist; ///< Subspace information
         Tensor<C> Q;
@@ -189,12 +238,14 @@ namespace madness {
 
 	XNonlinearSolver(const Alloc& alloc = Alloc(),bool print=false)
             : maxsub(10)
+            , subspace_thresh(0.0)
             , alloc(alloc)
     		, do_print(print)
         {}
 
 	XNonlinearSolver(const XNonlinearSolver& other)
             : maxsub(other.maxsub)
+            , subspace_thresh(other.subspace_thresh)
             , alloc(other.alloc)
 			, do_print(other.do_print)
         {}
@@ -206,6 +257,10 @@ namespace madness {
 	void set_maxsub(int maxsub) {this->maxsub = maxsub;}
 	Tensor<C> get_c() const {return c;}
 
+	/// Store the subspace history reduced by reduce_subspace_storage(item, thresh); 0 disables
+	void set_subspace_thresh(const double thresh) {subspace_thresh = thresh;}
+	double get_subspace_thresh() const {return subspace_thresh;}
+
 	void clear_subspace() {
 		ulist.clear();
 		rlist.clear();
@@ -247,6 +302,14 @@ namespace madness {
 			unew += (ulist[i] - rlist[i])*c[i];
 		}
 
+		// the new solution used the full-precision iterate, only the history is reduced
+		if (subspace_thresh>0.0) {
+			ulist.back() = deep_copy_subspace_item(ulist.back());
+			rlist.back() = deep_copy_subspace_item(rlist.back());
+			reduce_subspace_storage(ulist.back(),subspace_thresh);
+			reduce_subspace_storage(rlist.back(),subspace_thresh);
+		}
+
 		if (ulist.size() == maxsub) {
 			ulist.erase(ulist.begin());
 			rlist.erase(rlist.begin());
@@ -258,6 +321,148 @@ namespace madness {
     };
 
 
+	/// KAIN solver for several independent equations of the same kind
+
+	/// \ingroup nonlinearsolve
+	///
+	/// Solves \f$r_j(u_j) = 0\f$ for a block of functions \f$u_j\f$, e.g. the
+	/// response of several right-hand sides. Every column keeps its own
+	/// subspace and KAIN coefficients, exactly as NonlinearSolverND, but the
+	/// inner products of all columns are computed with a single global sum and
+	/// the new trial solutions are formed without intermediate fences.
+	///
+	/// Converged columns can be deflated, which frees their subspace; update()
+	/// then takes and returns only the columns listed in active().
+	template <typename T, std::size_t NDIM>
+	class BlockNonlinearSolver {
+		typedef Function<T,NDIM> functionT;
+		typedef std::vector<functionT> vecfuncT;
+
+		World& world;
+		unsigned int maxsub; ///< Maximum size of subspace dimension
+		double subspace_thresh; ///< Truncation threshold of the stored history, 0 keeps it unchanged
+		std::vector<std::size_t> active_columns;
+		std::vector<vecfuncT> ulist, rlist; ///< Subspace information per column
+		std::vector<Tensor<T> > Q;
+
+	public:
+		bool do_print;
+
+		BlockNonlinearSolver(World& world, std::size_t ncolumn, unsigned int maxsub=10)
+			: world(world), maxsub(maxsub), subspace_thresh(0.0), ulist(ncolumn), rlist(ncolumn), Q(ncolumn), do_print(false) {
+			for (std::size_t j=0; j<ncolumn; ++j) active_columns.push_back(j);
+		}
+
+		void set_maxsub(unsigned int new_maxsub) {maxsub = new_maxsub;}
+
+		unsigned int get_maxsub() const {return maxsub;}
+
+		/// Store the subspace history truncated at \c thresh; 0 disables
+		void set_subspace_thresh(const double thresh) {subspace_thresh = thresh;}
+
+		/// The columns that are still being solved for, in the order expected by update()
+		const std::vector<std::size_t>& active() const {return active_columns;}
+
+		/// Removes a converged column from the block and frees its subspace
+		void deflate(std::size_t column) {
+			auto it = std::find(active_columns.begin(), active_columns.end(), column);
+			MADNESS_CHECK(it != active_columns.end());
+			active_columns.erase(it);
+			ulist[column].clear();
+			rlist[column].clear();
+			Q[column] = Tensor<T>();
+		}
+
+		void clear_subspace() {
+			for (std::size_t j=0; j<ulist.size(); ++j) {
+				ulist[j].clear();
+				rlist[j].clear();
+				Q[j] = Tensor<T>();
+			}
+		}
+
+		/// Computes the next trial solution vectors of the active columns
+
+		/// @param u Current solutions of the active columns
+		/// @param r Corresponding residuals
+		/// @return Next trial solutions of the active columns
+		/// @param[in]          rcondtol rcond less than this will cause the subspace to be shrunk due to linear dependence
+		/// @param[in]          cabsmax  maximum element of c greater than this will cause the subspace to be shrunk due to linear dependence
+		vecfuncT update(const vecfuncT& u, const vecfuncT& r,
+				const double rcondtol=1e-8, const double cabsmax=1000.0) {
+			const std::size_t nact = active_columns.size();
+			MADNESS_CHECK(u.size() == nact and r.size() == nact);
+			if (maxsub == 1) return sub(world, u, r);
+
+			compress(world, u, false);
+			compress(world, r);
+
+			// gather the new subspace matrix elements of all columns into one inner product
+			vecfuncT left, right;
+			for (std::size_t a=0; a<nact; ++a) {
+				const std::size_t j = active_columns[a];
+				ulist[j].push_back(u[a]);
+				rlist[j].push_back(r[a]);
+				const std::size_t iter = ulist[j].size()-1;
+				for (std::size_t i=0; i<=iter; ++i) {
+					left.push_back(ulist[j][i]);
+					right.push_back(rlist[j][iter]);
+				}
+				for (std::size_t i=0; i<iter; ++i) {
+					left.push_back(ulist[j][iter]);
+					right.push_back(rlist[j][i]);
+				}
+			}
+			Tensor<T> q = inner(world, left, right);
+
+			// solve the subspace equations and form the new solutions without fencing
+			vecfuncT unew = zero_functions_compressed<T,NDIM>(world, nact);
+			long k = 0;
+			for (std::size_t a=0; a<nact; ++a) {
+				const std::size_t j = active_columns[a];
+				const long iter = ulist[j].size()-1;
+				Tensor<T> Qnew(iter+1,iter+1);
+				if (iter>0) Qnew(Slice(0,-2),Slice(0,-2)) = Q[j];
+				for (long i=0; i<=iter; ++i) Qnew(i,iter) = q(k++);
+				for (long i=0; i<iter; ++i) Qnew(iter,i) = q(k++);
+				Q[j] = Qnew;
+
+				Tensor<T> c = KAIN(Q[j]);
+				check_linear_dependence(Q[j],c,rcondtol,cabsmax,do_print);
+				if (do_print and world.rank()==0) print("subspace solution of column",j,c);
+
+				for (long i=0; i<=iter; ++i) {
+					unew[a].gaxpy(T(1.0),ulist[j][i],c[i],false);
+					unew[a].gaxpy(T(1.0),rlist[j][i],-c[i],false);
+				}
+
+				if (ulist[j].size() == maxsub) {
+					ulist[j].erase(ulist[j].begin());
+					rlist[j].erase(rlist[j].begin());
+					Q[j] = copy(Q[j](Slice(1,-1),Slice(1,-1)));
+				}
+			}
+			world.gop.fence();
+			truncate(world, unew);
+
+			if (subspace_thresh>0.0) {
+				vecfuncT uhist, rhist;
+				for (std::size_t j : active_columns) {
+					uhist.push_back(ulist[j].back());
+					rhist.push_back(rlist[j].back());
+				}
+				uhist = copy(world, uhist);
+				rhist = copy(world, rhist);
+				truncate(world, uhist, subspace_thresh, false);
+				truncate(world, rhist, subspace_thresh);
+				for (std::size_t a=0; a<nact; ++a) {
+					ulist[active_columns[a]].back() = uhist[a];
+					rlist[active_columns[a]].back() = rhist[a];
+				}
+			}
+			return unew;
+		}
+	};
 
 }
 #endif
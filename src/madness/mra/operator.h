@@ -41,6 +41,7 @@
 #include <limits.h>
 #include <madness/mra/adquad.h>
 #include <madness/tensor/aligned.h>
+#include <madness/tensor/mtxmq_tuned.h>
 #include <madness/tensor/tensor_lapack.h>
 #include <madness/constants.h>
 
@@ -149,6 +150,9 @@ namespace madness {
         mutable SimpleCache< SeparatedConvolutionData<Q,NDIM>, NDIM > data; ///< cache for all terms, dims and displacements
         mutable SimpleCache< SeparatedConvolutionData<Q,NDIM>, 2*NDIM > mod_data; ///< cache for all terms, dims and displacements
 
+        double range_=0.0;  ///< distance beyond which the kernel is negligible, 0 for no cutoff
+        std::vector< std::vector< Key<NDIM> > > disp_range_;  ///< displacements within range_, per level
+
     public:
 
         bool& modified() {return modified_;}
@@ -234,7 +238,7 @@ namespace madness {
 #ifdef HAVE_IBMBGQ
             mTxmq_padding(dimi, trans[0].r, dimk, dimk, w1, f.ptr(), trans[0].U);
 #else
-            mTxmq(dimi, trans[0].r, dimk, w1, f.ptr(), trans[0].U, dimk);
+            mTxmq_tuned(dimi, trans[0].r, dimk, w1, f.ptr(), trans[0].U, dimk);
 #endif
 
             size = trans[0].r * size / dimk;
@@ -243,7 +247,7 @@ namespace madness {
 #ifdef HAVE_IBMBGQ
                 mTxmq_padding(dimi, trans[d].r, dimk, dimk, w2, w1, trans[d].U);
 #else
-                mTxmq(dimi, trans[d].r, dimk, w2, w1, trans[d].U, dimk);
+                mTxmq_tuned(dimi, trans[d].r, dimk, w2, w1, trans[d].U, dimk);
 #endif
                 size = trans[d].r * size / dimk;
                 dimi = size/dimk;
@@ -261,7 +265,7 @@ namespace madness {
 #ifdef HAVE_IBMBGQ
                         mTxmq_padding(dimi, dimk, trans[d].r, dimk, w2, w1, trans[d].VT);
 #else
-                        mTxmq(dimi, dimk, trans[d].r, w2, w1, trans[d].VT);
+                        mTxmq_tuned(dimi, dimk, trans[d].r, w2, w1, trans[d].VT);
 #endif
                         size = dimk*size/trans[d].r;
                     }
@@ -790,6 +794,12 @@ namespace madness {
         }
 
 
+        /// select the mTxmq kernels for the transformations once, not in apply
+        void tune_kernels(World& world) const {
+            if (std::is_same<Q,double>::value) mTxmqTuner::instance().tune(k,world.rank()==0);
+        }
+
+
         void check_cubic() {
             // !!! NB ... cell volume obtained from global defaults
             const Tensor<double>& cell_width = FunctionDefaults<NDIM>::get_cell_width();
@@ -895,6 +905,7 @@ namespace madness {
             for (std::size_t d=1; d<NDIM; ++d) {
                 MADNESS_ASSERT(bc(d,0)==bc(0,0));
             }
+            tune_kernels(world);
             check_cubic();
 
             for (unsigned int mu=0; mu < argops.size(); ++mu) {
@@ -931,6 +942,7 @@ namespace madness {
             for (std::size_t d=1; d<NDIM; ++d) {
                 MADNESS_ASSERT(bc(d,0)==bc(0,0));
             }
+            tune_kernels(world);
             this->process_pending();
         }
 
@@ -962,6 +974,7 @@ namespace madness {
             for (std::size_t d=1; d<NDIM; ++d) {
                 MADNESS_ASSERT(bc(d,0)==bc(0,0));
             }
+            tune_kernels(world);
 
             const Tensor<double>& width = FunctionDefaults<NDIM>::get_cell_width();
             const double pi = constants::pi;
@@ -1007,6 +1020,7 @@ namespace madness {
             for (std::size_t d=1; d<NDIM; ++d) {
                 MADNESS_ASSERT(bc(d,0)==bc(0,0));
             }
+            tune_kernels(world);
 
             const Tensor<double>& width = FunctionDefaults<NDIM>::get_cell_width();
 
@@ -1044,9 +1058,45 @@ namespace madness {
         const BoundaryConditions<NDIM>& get_bc() const {return bc;}
 
         const std::vector< Key<NDIM> >& get_disp(Level n) const {
+            if (n<Level(disp_range_.size())) return disp_range_[n];
             return Displacements<NDIM>().get_disp(n, isperiodicsum);
         }
 
+        /// restrict the displacements to the range of a short-range kernel
+
+        /// get_disp will skip all displacements whose boxes are farther apart
+        /// than range, so their operator norms are never computed.  The lists
+        /// differ from the default ones only on the coarse levels, where
+        /// the boxes are larger than range.
+        /// @param[in]  range   distance beyond which the kernel is negligible
+        void set_range(const double range) {
+            range_=range;
+            disp_range_.clear();
+            if (range_<=0.0) return;
+
+            const Tensor<double>& width = FunctionDefaults<NDIM>::get_cell_width();
+            const Translation bmax=Displacements<NDIM>::bmax_default();
+            for (Level n=0; (bmax-1)*width.normf()/double(Translation(1)<<n)>range_; ++n) {
+                const Translation twonm1 = (Translation(1)<<n)>>1;
+                std::vector< Key<NDIM> > inrange;
+                for (const Key<NDIM>& d : Displacements<NDIM>().get_disp(n, isperiodicsum)) {
+                    double distsq=0.0;
+                    for (std::size_t i=0; i<NDIM; ++i) {
+                        Translation l=d.translation()[i];
+                        if (isperiodicsum and l> twonm1) l-=2*twonm1;
+                        if (isperiodicsum and l<-twonm1) l+=2*twonm1;
+                        const double gap=std::max<Translation>(0,std::abs(l)-1)*width[i]/double(Translation(1)<<n);
+                        distsq+=gap*gap;
+                    }
+                    if (distsq<=range_*range_) inrange.push_back(d);
+                }
+                disp_range_.push_back(inrange);
+            }
+        }
+
+        /// return the distance beyond which the kernel is negligible, 0 for no cutoff
+        double get_range() const {return range_;}
+
         /// return the operator norm for all terms, all dimensions and 1 displacement
         double norm(Level n, const Key<NDIM>& d, const Key<NDIM>& source_key) const {
             // SeparatedConvolutionData keeps data for all terms and all dimensions and 1 displacement
@@ -1630,6 +1680,100 @@ namespace madness {
     }
 
 
+    /// Factory function generating separated kernel for convolution with erfc(omega r)/r in 3D
+
+    /// The short-range part of the Coulomb kernel, e.g. for screened exchange.
+    /// Its fit has no Gaussians more diffuse than exp(-omega^2 r^2), and
+    /// displacements beyond GFit::erfc_range are skipped, cf set_range.
+    static
+    inline
+    SeparatedConvolution<double,3> ErfcCoulombOperator(World& world,
+                                                       double omega,
+                                                       double lo,
+                                                       double eps,
+                                                       const BoundaryConditions<3>& bc=FunctionDefaults<3>::get_bc(),
+                                                       int k=FunctionDefaults<3>::get_k())
+    {
+        const Tensor<double>& cell_width = FunctionDefaults<3>::get_cell_width();
+        double hi = cell_width.normf(); // Diagonal width of cell
+        GFit<double,3> fit=GFit<double,3>::ErfcCoulombFit(omega,lo,hi,eps,false);
+        SeparatedConvolution<double,3> tmp(world, fit.coeffs(), fit.exponents(), bc, k);
+        tmp.set_range(GFit<double,3>::erfc_range(omega,eps));
+        return tmp;
+    }
+
+
+    /// Factory function generating separated kernel for convolution with erfc(omega r)/r in 3D
+    static
+    inline
+    SeparatedConvolution<double,3>* ErfcCoulombOperatorPtr(World& world,
+                                                           double omega,
+                                                           double lo,
+                                                           double eps,
+                                                           const BoundaryConditions<3>& bc=FunctionDefaults<3>::get_bc(),
+                                                           int k=FunctionDefaults<3>::get_k())
+    {
+        const Tensor<double>& cell_width = FunctionDefaults<3>::get_cell_width();
+        double hi = cell_width.normf(); // Diagonal width of cell
+        GFit<double,3> fit=GFit<double,3>::ErfcCoulombFit(omega,lo,hi,eps,false);
+        SeparatedConvolution<double,3>* tmp=new SeparatedConvolution<double,3>(world, fit.coeffs(), fit.exponents(), bc, k);
+        tmp->set_range(GFit<double,3>::erfc_range(omega,eps));
+        return tmp;
+    }
+
+
+    /// Factory function generating separated kernel for convolution with erf(omega r)/r in 3D
+
+    /// The long-range part of the Coulomb kernel, the complement of ErfcCoulombOperator
+    static
+    inline
+    SeparatedConvolution<double,3> ErfCoulombOperator(World& world,
+                                                      double omega,
+                                                      double lo,
+                                                      double eps,
+                                                      const BoundaryConditions<3>& bc=FunctionDefaults<3>::get_bc(),
+                                                      int k=FunctionDefaults<3>::get_k())
+    {
+        const Tensor<double>& cell_width = FunctionDefaults<3>::get_cell_width();
+        double hi = cell_width.normf(); // Diagonal width of cell
+        if (bc(0,0) == BC_PERIODIC) hi *= 100; // Extend range for periodic summation
+
+        GFit<double,3> fit=GFit<double,3>::ErfCoulombFit(omega,lo,hi,eps,false);
+        Tensor<double> coeff=fit.coeffs();
+        Tensor<double> expnt=fit.exponents();
+
+        if (bc(0,0) == BC_PERIODIC) {
+            fit.truncate_periodic_expansion(coeff, expnt, cell_width.max(), true);
+        }
+        return SeparatedConvolution<double,3>(world, coeff, expnt, bc, k);
+    }
+
+
+    /// Factory function generating separated kernel for convolution with erf(omega r)/r in 3D
+    static
+    inline
+    SeparatedConvolution<double,3>* ErfCoulombOperatorPtr(World& world,
+                                                          double omega,
+                                                          double lo,
+                                                          double eps,
+                                                          const BoundaryConditions<3>& bc=FunctionDefaults<3>::get_bc(),
+                                                          int k=FunctionDefaults<3>::get_k())
+    {
+        const Tensor<double>& cell_width = FunctionDefaults<3>::get_cell_width();
+        double hi = cell_width.normf(); // Diagonal width of cell
+        if (bc(0,0) == BC_PERIODIC) hi *= 100; // Extend range for periodic summation
+
+        GFit<double,3> fit=GFit<double,3>::ErfCoulombFit(omega,lo,hi,eps,false);
+        Tensor<double> coeff=fit.coeffs();
+        Tensor<double> expnt=fit.exponents();
+
+        if (bc(0,0) == BC_PERIODIC) {
+            fit.truncate_periodic_expansion(coeff, expnt, cell_width.max(), true);
+        }
+        return new SeparatedConvolution<double,3>(world, coeff, expnt, bc, k);
+    }
+
+
     /// Factory function generating separated kernel for convolution with BSH kernel in general NDIM
     template <std::size_t NDIM>
     static
@@ -36,6 +36,7 @@
 /// \file mra/startup.cc
 
 #include <madness/mra/mra.h>
+#include <madness/mra/mra_data.h>
 #include <madness/tensor/tensor.h>
 #include <madness/world/timers.h>
 //#include <madness/mra/mraimpl.h> !!!!!!!!!!!!!!!!  NOOOOOOOOOOOOOOOOOOOOOOOOOO !!!!!!!!!!!!!!!!!!!!!!!
@@ -81,7 +82,9 @@ namespace madness {
                 redirectio(world);
         }
 
-        // Process environment variables
+        // Process environment variables ... an explicit data directory
+        // overrides the tables compiled into the library
+        const bool use_embedded_data = detail::have_embedded_mra_data() && !getenv("MRA_DATA_DIR");
         if (getenv("MRA_DATA_DIR")) data_dir = getenv("MRA_DATA_DIR");
 
         // Need to add an RC file ...
@@ -99,48 +102,49 @@ namespace madness {
           std::cout << std::setprecision(6);
         }
 
+        // Displacements are now made on first use by the operators
 #ifdef FUNCTION_INSTANTIATE_1
         FunctionDefaults<1>::set_defaults(world);
-        Displacements<1> d1;
 #endif
 #ifdef FUNCTION_INSTANTIATE_2
         FunctionDefaults<2>::set_defaults(world);
-        Displacements<2> d2;
 #endif
 #ifdef FUNCTION_INSTANTIATE_3
         FunctionDefaults<3>::set_defaults(world);
-        Displacements<3> d3;
 #endif
 #ifdef FUNCTION_INSTANTIATE_4
         FunctionDefaults<4>::set_defaults(world);
-        Displacements<4> d4;
 #endif
 #ifdef FUNCTION_INSTANTIATE_5
         FunctionDefaults<5>::set_defaults(world);
-        Displacements<5> d5;
 #endif
 #ifdef FUNCTION_INSTANTIATE_6
         FunctionDefaults<6>::set_defaults(world);
-        Displacements<6> d6;
 #endif
 
         //if (world.rank() == 0) print("loading coeffs, etc.");
 
-        load_coeffs(world, data_dir);
+        load_coeffs(world, use_embedded_data ? 0 : data_dir);
 
         //if (world.rank() == 0) print("loading quadrature, etc.");
 
-        load_quadrature(world, data_dir);
+        load_quadrature(world, use_embedded_data ? 0 : data_dir);
 
         // This to init static data while single threaded
         initialize_legendre_stuff();
 
-        //if (world.rank() == 0) print("testing coeffs, etc.");
-        MADNESS_CHECK(gauss_legendre_test());
-        MADNESS_CHECK(test_two_scale_coefficients());
+        // The compiled-in tables are a verbatim copy of the distributed
+        // data files and are checked by the unit tests; only data read
+        // from disk needs checking here
+        if (!use_embedded_data) {
+            //if (world.rank() == 0) print("testing coeffs, etc.");
+            MADNESS_CHECK(gauss_legendre_test());
+            MADNESS_CHECK(test_two_scale_coefficients());
+        }
 
-	int mflopslo, mflopshi;
-	time_transform(world, mflopslo, mflopshi);
+        // The BLAS calibration is only needed for the banner
+        int mflopslo=0, mflopshi=0;
+        if (doprint) time_transform(world, mflopslo, mflopshi);
 
         // print the configuration options
         if (doprint && world.rank() == 0) {
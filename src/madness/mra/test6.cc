@@ -529,6 +529,75 @@ int test_convolution(World& world, const long& k, const double thresh) {
 }
 
 
+/// max rank and memory of the coefficients of a 6D function
+std::pair<long,std::size_t> rank_and_size(const real_function_6d& f) {
+    long maxrank=0;
+    const auto& coeffs=f.get_impl()->get_coeffs();
+    for (auto it=coeffs.begin(); it!=coeffs.end(); ++it) {
+        const auto& node=it->second;
+        if (node.has_coeff()) maxrank=std::max(maxrank,node.coeff().rank());
+    }
+    f.world().gop.max(maxrank);
+    return std::make_pair(maxrank,f.get_impl()->real_size());
+}
+
+/// test the single-pass conversion compressed -> nonstandard against
+/// the conversion via the reconstructed form
+int test_nonstandard(World& world, const long& k, const double thresh) {
+
+    print("entering nonstandard");
+    int nerror=0;
+
+    // smooth functions and a coarse threshold keep the 6D tree small also
+    // with full-rank tensors
+    const long k0=FunctionDefaults<6>::get_k();
+    const double thresh0=FunctionDefaults<6>::get_thresh();
+    const double eps=1.e-2;
+    FunctionDefaults<3>::set_k(4);
+    FunctionDefaults<6>::set_k(4);
+    FunctionDefaults<3>::set_thresh(eps);
+    FunctionDefaults<6>::set_thresh(eps);
+
+    auto g1=[](const coord_3d& r) {return exp(-inner(r,r));};
+    auto g2=[](const coord_3d& r) {return exp(-2.0*inner(r,r));};
+    real_function_3d phi1=real_factory_3d(world).functor(g1);
+    real_function_3d phi2=real_factory_3d(world).functor(g2);
+    real_function_6d f=hartree_product(phi1,phi2)+hartree_product(phi2,phi1);
+    f.truncate().reduce_rank();
+    f.compress();
+    const double fnorm=f.norm2();
+
+    // old path: compressed -> reconstructed -> nonstandard
+    real_function_6d f1=copy(f);
+    f1.reconstruct();
+    f1.make_nonstandard(true);
+    std::pair<long,std::size_t> rs1=rank_and_size(f1);
+
+    // new path: compressed -> nonstandard in one pass
+    real_function_6d f2=copy(f);
+    f2.make_nonstandard(true);
+    std::pair<long,std::size_t> rs2=rank_and_size(f2);
+
+    print("max rank, size via reconstruct ",rs1.first,rs1.second);
+    print("max rank, size in one pass     ",rs2.first,rs2.second);
+    nerror+=check(rs2.first<=rs1.first+1,"max rank of the nonstandard form");
+    nerror+=check(rs2.second<=1.2*rs1.second,"size of the nonstandard form");
+
+    f1.standard();
+    f2.standard();
+    nerror+=check_small(f2.norm2()-fnorm,eps,"norm after round trip");
+    nerror+=check_small((f1-f2).norm2(),eps,"difference to the old path");
+
+    FunctionDefaults<3>::set_k(k0);
+    FunctionDefaults<6>::set_k(k0);
+    FunctionDefaults<3>::set_thresh(thresh0);
+    FunctionDefaults<6>::set_thresh(thresh0);
+
+    print("all done\n");
+    return nerror;
+}
+
+
 int test_replicate(World& world, const long& k, const double thresh) {
     real_function_3d phi=real_factory_3d(world).f(gauss_3d);
     auto map=phi.get_pmap();
@@ -712,6 +781,7 @@ int main(int argc, char**argv) {
     error+=test_exchange(world,k,thresh);
     error+=test_inner(world,k,thresh);
     error+=test_replicate(world,k,thresh);
+    error+=test_nonstandard(world,k,thresh);
 
     print(ok(error==0),error,"finished test suite\n");
 
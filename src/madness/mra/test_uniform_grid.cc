@@ -0,0 +1,131 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+/// \file test_uniform_grid.cc
+/// \brief test the transforms between functions and uniform grids
+
+#include <madness/mra/mra.h>
+#include <madness/mra/uniform_grid.h>
+#include <madness/constants.h>
+#include <cmath>
+#include <vector>
+
+using namespace madness;
+
+template <std::size_t NDIM>
+double gaussian(const Vector<double,NDIM>& x) {
+    double sum = 0.0;
+    for (std::size_t d=0; d<NDIM; ++d) sum += (x[d]-0.3)*(x[d]-0.3);
+    return exp(-sum);
+}
+
+/// Fills the grid x_j = lo + j*(hi-lo)/npt with the analytic function
+template <std::size_t NDIM>
+Tensor<double> analytic_grid(const std::vector<long>& npt) {
+    Tensor<double> grid(npt);
+    const Tensor<double>& cell = FunctionDefaults<NDIM>::get_cell();
+    Vector<double,NDIM> x;
+    for (IndexIterator it(npt); it; ++it) {
+        for (std::size_t d=0; d<NDIM; ++d)
+            x[d] = cell(d,0) + it[d]*(cell(d,1)-cell(d,0))/npt[d];
+        grid(*it) = gaussian<NDIM>(x);
+    }
+    return grid;
+}
+
+template <std::size_t NDIM>
+int test_uniform_grid(World& world, long n) {
+    FunctionDefaults<NDIM>::set_k(8);
+    FunctionDefaults<NDIM>::set_thresh(1e-7);
+    FunctionDefaults<NDIM>::set_cubic_cell(-10.0,10.0);
+    FunctionDefaults<NDIM>::set_refine(true);
+    int success = 0;
+
+    const std::vector<long> npt(NDIM, n);
+    const Tensor<double> ref = analytic_grid<NDIM>(npt);
+
+    // function -> grid should be exact up to the precision of the function,
+    // whose pointwise error is a few times the threshold per dimension
+    Function<double,NDIM> f = FunctionFactory<double,NDIM>(world).f(gaussian<NDIM>);
+    Tensor<double> grid = function_to_uniform_grid(f, npt);
+    double err = (grid - ref).absmax();
+    if (world.rank() == 0) print(NDIM, "D function to grid: max error", err);
+    if (err > 1e-6*NDIM*NDIM) success++;
+
+    // grid -> function is limited by the interpolation of the grid, the
+    // error of the 6th-order interpolation grows like h^6
+    Function<double,NDIM> g = uniform_grid_to_function<NDIM>(world, ref);
+    double ferr = (f - g).norm2();
+    const double tol = 1e-4*std::pow(128.0/n, 6);
+    if (world.rank() == 0) print(NDIM, "D grid to function: error", ferr, "size", g.size());
+    if (ferr > tol) success++;
+
+    return success;
+}
+
+int main(int argc, char**argv) {
+    initialize(argc,argv);
+    World world(SafeMPI::COMM_WORLD);
+    int success=0;
+
+    try {
+        startup(world,argc,argv);
+        std::cout.precision(8);
+
+        success+=test_uniform_grid<1>(world, 128);
+        success+=test_uniform_grid<2>(world, 128);
+        success+=test_uniform_grid<3>(world, 64);
+    }
+    catch (const SafeMPI::Exception& e) {
+        print(e);
+        error("caught an MPI exception");
+    }
+    catch (const madness::MadnessException& e) {
+        print(e);
+        error("caught a MADNESS exception");
+    }
+    catch (const madness::TensorException& e) {
+        print(e);
+        error("caught a Tensor exception");
+    }
+    catch (const std::exception& e) {
+        print(e.what());
+        error("caught an STL exception");
+    }
+    catch (...) {
+        error("caught unhandled exception");
+    }
+
+    world.gop.fence();
+    finalize();
+
+    return success;
+}
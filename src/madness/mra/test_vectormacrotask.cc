@@ -231,6 +231,32 @@ int test_2d_partitioning(World& universe, const std::vector<real_function_3d>& v
     return success;
 }
 
+int test_pool(World& universe, const std::vector<real_function_3d>& v3,
+              const std::vector<real_function_3d>& ref) {
+    if (universe.rank() == 0) print("\nstarting two taskqs on a persistent subworld pool");
+    int success=0;
+    auto pool=SubworldPool::create(universe, universe.size());
+    World* subworld0=&pool->get_subworld();
+    for (int i=0; i<2; ++i) {
+        auto taskq = std::shared_ptr<MacroTaskQ>(new MacroTaskQ(universe, universe.size()));
+        MicroTask t;
+        MacroTask task(universe, t, taskq);
+        std::vector<real_function_3d> f2a = task(v3[0], 2.0, v3);
+        taskq->run_all();
+        success+=check_vector(universe,ref,f2a,"test pool execution of task");
+        if (&taskq->get_subworld()!=subworld0) success++;
+    }
+    if (pool->get_nuse()!=2) success++;
+
+    // immediate execution uses the pool as well
+    MicroTask t;
+    MacroTask task_immediate(universe, t);
+    std::vector<real_function_3d> v = task_immediate(v3[0], 2.0, v3);
+    success+=check_vector(universe,ref,v,"test pool immediate execution of task");
+    if (pool->get_nuse()!=3) success++;
+    return success;
+}
+
 int main(int argc, char **argv) {
     madness::World &universe = madness::initialize(argc, argv);
     startup(universe, argc, argv);
@@ -273,6 +299,9 @@ int main(int argc, char **argv) {
         success+=test_2d_partitioning(universe,v3);
         timer1.tag("2D partitioning");
 
+        success+=test_pool(universe,v3,ref);
+        timer1.tag("subworld pool");
+
         if (universe.rank() == 0) {
             if (success==0) print("\n --> all tests \033[32m", "passed ", "\033[0m\n");
             else print("\n --> all tests \033[31m", "failed \033[0m \n");
@@ -282,13 +311,3 @@ int main(int argc, char **argv) {
     madness::finalize();
     return 0;
 }
-
-template<> volatile std::list<detail::PendingMsg> WorldObject<MacroTaskQ>::pending = std::list<detail::PendingMsg>();
-template<> Spinlock WorldObject<MacroTaskQ>::pending_mutex(0);
-
-//template <> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<long, MacroTask, madness::Hash<long> > >::pending = std::list<detail::PendingMsg>();
-//template <> Spinlock WorldObject<WorldContainerImpl<long, MacroTask, madness::Hash<long> > >::pending_mutex(0);
-
-template<> volatile std::list<detail::PendingMsg> WorldObject<WorldContainerImpl<long, std::vector<unsigned char>, madness::Hash<long> > >::pending = std::list<detail::PendingMsg>();
-template<> Spinlock WorldObject<WorldContainerImpl<long, std::vector<unsigned char>, madness::Hash<long> > >::pending_mutex(
-        0);
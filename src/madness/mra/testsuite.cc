@@ -222,6 +222,22 @@ int test_basic(World& world) {
     CHECK(err, 3*thresh, "err");
     CHECK(val-(*functor)(point), thresh, "error at a point");
 
+    // fused traversals agree with the separate reductions
+    FunctionTreeStats stats = f.tree_stats();
+    CHECK(double(stats.nnodes)-double(f.tree_size()), 0.5, "tree_stats nnodes");
+    CHECK(double(stats.size)-double(f.size()), 0.5, "tree_stats size");
+    CHECK(double(stats.max_depth)-double(f.max_depth()), 0.5, "tree_stats max_depth");
+    CHECK(sqrt(stats.norm2sq)-norm, 1e-12, "tree_stats norm");
+    FunctionTreeStats nstats = f.norm_tree_stats();
+    CHECK(double(nstats.nnodes)-double(stats.nnodes), 0.5, "norm_tree_stats nnodes");
+    CHECK(double(nstats.ncoeff)-double(stats.ncoeff), 0.5, "norm_tree_stats ncoeff");
+    CHECK(sqrt(nstats.norm2sq)-norm, 1e-12, "norm_tree_stats norm");
+    double norm_tree = 0.0;
+    if (f.get_impl()->get_coeffs().probe(Key<NDIM>(0)))
+        norm_tree = f.get_impl()->get_coeffs().find(Key<NDIM>(0)).get()->second.get_norm_tree();
+    world.gop.sum(norm_tree);
+    CHECK(norm_tree-norm, 1e-12, "norm_tree at the root");
+
     f.compress();
     double new_norm = f.norm2();
     CHECK(new_norm-norm, 1e-14, "new_norm");
@@ -320,13 +336,15 @@ struct myunaryop_square {
 
 template <typename T, int NDIM>
 struct test_multiop {
+    bool batch=false;
+    bool pointwise() const {return batch;}   // pass the values of many boxes at once
     Tensor<T> operator()(const Key<NDIM>& key, const std::vector< Tensor<T> >& c) const {
         Tensor<T> r = copy(c[0]).emul(c[0]);
         for (unsigned int i=1; i<c.size(); ++i) r += copy(c[i]).emul(c[i]);
         return r;
     }
     template <typename Archive>
-    void serialize(Archive& ar) {}
+    void serialize(Archive& ar) {ar & batch;}
 };
 
 template <typename T, std::size_t NDIM>
@@ -536,6 +554,10 @@ int test_math(World& world) {
         refine_to_common_level(world,vin);
         if (world.rank() == 0) print("\nTest multioperation");
         Function<T,NDIM> mop = multiop_values<T,test_multiop<T,NDIM>,NDIM> (test_multiop<T,NDIM>(), vin);
+        test_multiop<T,NDIM> batch_op;
+        batch_op.batch=true;
+        Function<T,NDIM> mop_batch = multiop_values<T,test_multiop<T,NDIM>,NDIM> (batch_op, vin);
+        CHECK((mop-mop_batch).norm2(), 1e-12, "batched multiop");
         compress(world, vin);
         Function<T,NDIM> r(world);
         for (unsigned int i=0; i<vin.size(); i++) r += vin[i]*vin[i];
@@ -661,6 +683,25 @@ int test_diff(World& world) {
 
         if (world.rank() == 0) print("    error", err);
     }
+
+    // one halo for all axes, and rebound to a function with the same tree,
+    // must reproduce the node-by-node neighbor lookup
+    {
+        Derivative<T,NDIM> D0(world, 0);
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=D0.make_halo(f);
+        Function<T,NDIM> g=copy(f).scale(T(2.0));
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > ghalo=
+                std::make_shared<const DerivativeHalo<T,NDIM> >(g.get_impl().get(), *halo);
+        for (std::size_t axis=0; axis<NDIM; ++axis) {
+            Derivative<T,NDIM> D(world, axis);
+            Function<T,NDIM> ref = D(f,false);
+            world.gop.fence();
+            Function<T,NDIM> dfdx = D(f,halo);
+            Function<T,NDIM> dgdx = D(g,ghalo);
+            CHECK((dfdx-ref).norm2(), 1.e-14, "halo diff in test_diff");
+            CHECK((dgdx-2.0*ref).norm2(), 1.e-13, "rebound halo diff in test_diff");
+        }
+    }
     world.gop.fence();
     if (not ok) return 1;
     return 0;
@@ -900,6 +941,45 @@ int test_coulomb(World& world) {
     }
     CHECK(rerr, 10.0*thresh, "err in test_coulomb");
 
+    // apply to the compressed function, which goes to the nonstandard form
+    // in one pass, and apply two operators at once
+    f.standard();
+    Function<double,3> r2 = apply(op,f);
+    CHECK((r2-r).norm2(), thresh, "apply to compressed function");
+
+    std::vector<std::shared_ptr<SeparatedConvolution<double,3> > > ops;
+    ops.push_back(std::shared_ptr<SeparatedConvolution<double,3> >(CoulombOperatorPtr(world, 1e-5, thresh)));
+    ops.push_back(std::shared_ptr<SeparatedConvolution<double,3> >(BSHOperatorPtr3D(world, 1.0, 1e-5, thresh)));
+    std::vector<Function<double,3> > rv = apply(world, ops, f);
+    f.reconstruct();
+    Function<double,3> rbsh = apply(*ops[1], f);
+    CHECK((rv[0]-r).norm2(), thresh, "apply several operators: Coulomb");
+    CHECK((rv[1]-rbsh).norm2(), thresh, "apply several operators: BSH");
+
+    // the same with a minimal-term expansion of 1/r
+    GFit<double,3>::set_minimal_terms(true);
+    SeparatedConvolution<double,3> opmin = CoulombOperator(world, 1e-5, thresh);
+    GFit<double,3>::set_minimal_terms(false);
+    Function<double,3> rmin = apply(opmin,f);
+    CHECK(rmin.err(*fexact), 10.0*thresh, "err with minimal-term operator");
+
+    // range-separated kernels: erf(omega r)/r applied on the Gaussian gives
+    // erf(mu r)/r with 1/mu^2 = 1/expnt + 1/omega^2, and erfc + erf = 1/r
+    const double omega=1.0;
+    const double mu2=1.0/(1.0/expnt+1.0/(omega*omega));
+    functorT flr(new GaussianPotential(origin, mu2, pow(mu2/PI,1.5)));
+    SeparatedConvolution<double,3> opsr = ErfcCoulombOperator(world, omega, 1e-5, thresh);
+    SeparatedConvolution<double,3> oplr = ErfCoulombOperator(world, omega, 1e-5, thresh);
+    Function<double,3> rsr = apply(opsr,f);
+    Function<double,3> rlr = apply(oplr,f);
+    CHECK(rlr.err(*flr), 10.0*thresh, "err with long-range operator");
+    CHECK((rsr+rlr-r).norm2(), 10.0*thresh, "short-range + long-range operator");
+
+    // skipping the displacements beyond the range does not change the result
+    opsr.set_range(0.0);
+    Function<double,3> rsr0 = apply(opsr,f);
+    CHECK((rsr-rsr0).norm2(), thresh, "displacement cutoff of the short-range operator");
+
     if (ok) return 0;
     return 1;
 }
@@ -933,6 +1013,94 @@ public:
     };
 
 
+/// largest error of a Gaussian expansion of f on a logarithmic grid over [lo,hi],
+/// relative to max(|f(r)|,fmin)
+template <typename funcT>
+double gfit_error(const GFit<double,3>& fit, const funcT& f, double lo, double hi,
+                  double fmin) {
+    Tensor<double> c=fit.coeffs(), e=fit.exponents();
+    double err=0.0;
+    const long npt=10000;
+    for (long i=0; i<npt; ++i) {
+        double r=lo*pow(hi/lo,double(i)/(npt-1));
+        double value=0.0;
+        for (long j=0; j<c.dim(0); ++j) value+=c[j]*exp(-e[j]*r*r);
+        err=std::max(err,std::abs(value-f(r))/std::max(std::abs(f(r)),fmin));
+    }
+    return err;
+}
+
+int test_gfit(World& world) {
+    bool ok=true;
+    if (world.rank() == 0)
+        print("Test minimal-term Gaussian expansions");
+
+    const double lo=1.e-4, hi=30.0, eps=1.e-6;
+    const double mu=1.0;
+    auto coulomb=[](double r) {return 1.0/r;};
+    auto bsh=[mu](double r) {return exp(-mu*r)/(4.0*constants::pi*r);};
+    auto slater=[mu](double r) {return exp(-mu*r);};
+
+    GFit<double,3>::set_minimal_terms(false);
+    GFit<double,3> c0=GFit<double,3>::CoulombFit(lo,hi,eps);
+    GFit<double,3> b0=GFit<double,3>::BSHFit(mu,lo,hi,eps);
+    GFit<double,3> s0=GFit<double,3>::SlaterFit(mu,lo,hi,eps);
+    GFit<double,3>::set_minimal_terms(true);
+    GFit<double,3> c1=GFit<double,3>::CoulombFit(lo,hi,eps);
+    GFit<double,3> b1=GFit<double,3>::BSHFit(mu,lo,hi,eps);
+    GFit<double,3> s1=GFit<double,3>::SlaterFit(mu,lo,hi,eps);
+    GFit<double,3>::set_minimal_terms(false);
+
+    // the Coulomb kernel is fit to relative precision, the BSH kernel to
+    // relative precision within its range and the Slater function to
+    // absolute precision away from the cusp
+    double errc0=gfit_error(c0,coulomb,lo,hi,0.0);
+    double errc1=gfit_error(c1,coulomb,lo,hi,0.0);
+    double errb0=gfit_error(b0,bsh,lo,10.0,0.0);
+    double errb1=gfit_error(b1,bsh,lo,10.0,0.0);
+    double errs0=gfit_error(s0,slater,10.0*lo,hi,1.0);
+    double errs1=gfit_error(s1,slater,10.0*lo,hi,1.0);
+    if (world.rank() == 0) {
+        print("  Coulomb: terms",c0.coeffs().dim(0),"->",c1.coeffs().dim(0),
+              " error",errc0,"->",errc1);
+        print("      BSH: terms",b0.coeffs().dim(0),"->",b1.coeffs().dim(0),
+              " error",errb0,"->",errb1);
+        print("   Slater: terms",s0.coeffs().dim(0),"->",s1.coeffs().dim(0),
+              " error",errs0,"->",errs1);
+    }
+    CHECK(std::max(0.0,errc1-1.01*std::max(eps,errc0)), 1.e-14, "Coulomb fit accuracy");
+    CHECK(std::max(0.0,errb1-1.01*std::max(eps,errb0)), 1.e-14, "BSH fit accuracy");
+    CHECK(std::max(0.0,errs1-1.01*std::max(eps,errs0)), 1.e-14, "Slater fit accuracy");
+    CHECK(double(c1.coeffs().dim(0))/c0.coeffs().dim(0), 0.85, "Coulomb fit terms");
+    CHECK(double(b1.coeffs().dim(0))/b0.coeffs().dim(0), 1.01, "BSH fit terms");
+    CHECK(double(s1.coeffs().dim(0))/s0.coeffs().dim(0), 1.01, "Slater fit terms");
+
+    // the long-range kernel is fit to relative precision, the short-range
+    // kernel to precision relative to 1/r, and with fewer terms than 1/r
+    const double omega=0.33;
+    auto erf_coulomb=[omega](double r) {return erf(omega*r)/r;};
+    GFit<double,3> sr=GFit<double,3>::ErfcCoulombFit(omega,lo,hi,eps);
+    GFit<double,3> lr=GFit<double,3>::ErfCoulombFit(omega,lo,hi,eps);
+    double errlr=gfit_error(lr,erf_coulomb,lo,hi,0.0);
+    double errsr=0.0;
+    for (long i=0; i<10000; ++i) {
+        double r=lo*pow(hi/lo,i/9999.0);
+        double value=0.0;
+        for (long j=0; j<sr.coeffs().dim(0); ++j) value+=sr.coeffs()[j]*exp(-sr.exponents()[j]*r*r);
+        errsr=std::max(errsr,std::abs(value-erfc(omega*r)/r)*r);
+    }
+    if (world.rank() == 0) {
+        print("erfc(wr)/r: terms",sr.coeffs().dim(0)," error",errsr);
+        print(" erf(wr)/r: terms",lr.coeffs().dim(0)," error",errlr);
+    }
+    CHECK(errsr, eps, "erfc fit accuracy");
+    CHECK(errlr, eps, "erf fit accuracy");
+    CHECK(double(sr.coeffs().dim(0))/c0.coeffs().dim(0), 0.85, "erfc fit terms");
+
+    if (ok) return 0;
+    return 1;
+}
+
 int test_qm(World& world) {
     /*
 
@@ -1171,6 +1339,21 @@ int test_plot(World& world) {
     }
     world.gop.fence();
 
+    // batched evaluation of a list of points, including the cell boundaries
+    std::vector<coordT> points;
+    for (int i=0; i<npt[0]; ++i) {
+        coordT x;
+        for (std::size_t d=0; d<NDIM; ++d) x[d] = -L + 2.0*L*((i*(d+3))%npt[0])/(npt[0]-1.0);
+        points.push_back(x);
+    }
+    Tensor<T> values = f.eval_points(points);
+    if (world.rank() == 0) {
+        for (std::size_t i=0; i<points.size(); ++i) {
+            CHECK(values(i)-f.eval(points[i]).get(),1e-12,"eval_points");
+        }
+    }
+    world.gop.fence();
+
     r = Tensor<T>();
     plotdx(f, "testplot", FunctionDefaults<NDIM>::get_cell(), npt);
 
@@ -1224,6 +1407,27 @@ int test_io(World& world) {
 
     //    MADNESS_CHECK(err == 0.0);
 
+    // vector of functions, one file per process
+    std::vector<Function<T,NDIM> > vf={f, copy(f).compress(), T(2.0)*f};
+    save_function_parallel(world, vf, "mary");
+    std::vector<Function<T,NDIM> > vg;
+    load_function_parallel(world, vg, "mary");
+    if (world.rank() == 0) {
+        std::remove("mary.manifest");
+        char buf[256];
+        for (int i=0; i<world.size(); ++i) {
+            snprintf(buf, sizeof(buf), "mary.%5.5d", i);
+            std::remove(buf);
+        }
+    }
+    CHECK(double(vg.size())-double(vf.size()), 0.5, "test_io parallel size");
+    CHECK(double(vg[1].is_compressed())-1.0, 0.5, "test_io parallel tree state");
+    for (std::size_t i=0; i<vf.size(); ++i) {
+        err = (vg[i]-vf[i]).norm2();
+        if (world.rank() == 0) print("err parallel = ", err);
+        CHECK(err,1e-12,"test_io parallel");
+    }
+
     if (world.rank() == 0) print("test_io OK");
     world.gop.fence();
     if (ok) return 0;
@@ -1332,6 +1536,12 @@ int main(int argc, char**argv) {
         
         PROFILE_BLOCK(testsuite);
 
+        // startup does not check the tables compiled into the library
+        if (!gauss_legendre_test() || !test_two_scale_coefficients()) {
+            print("testsuite: MRA data tables failed their checks");
+            nfail++;
+        }
+
         std::cout.precision(8);
 
 
@@ -1380,6 +1590,7 @@ int main(int argc, char**argv) {
             nfail+=test_diff<double,3>(world);
             nfail+=test_op<double,3>(world);
             nfail+=test_coulomb(world);
+            nfail+=test_gfit(world);
             nfail+=test_plot<double,3>(world);
             nfail+=test_io<double,3>(world);
             
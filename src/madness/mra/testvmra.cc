@@ -1,6 +1,7 @@
 #define NO_GENTENSOR
 #include <madness/mra/mra.h>
 #include <madness/mra/vmra.h>
+#include <madness/mra/nonlinsol.h>
 #include <madness/misc/ran.h>
 
 const double PI = 3.1415926535897932384;
@@ -301,6 +302,133 @@ void test_rot(World& world) {
 
 }
 
+/// grad with a shared halo against derivatives without halo, also after f
+/// was updated in place while the halo is still alive
+template <typename T, std::size_t NDIM>
+void test_grad(World& world) {
+    typedef std::shared_ptr< FunctionFunctorInterface<T,NDIM> > ffunctorT;
+
+    const double thresh=1.e-5;
+    Tensor<double> cell(NDIM,2);
+    for (std::size_t i=0; i<NDIM; ++i) {
+        cell(i,0) = -11.0-2*i;  // Deliberately asymmetric bounding box
+        cell(i,1) =  10.0+i;
+    }
+    FunctionDefaults<NDIM>::set_cell(cell);
+    FunctionDefaults<NDIM>::set_k(6);
+    FunctionDefaults<NDIM>::set_thresh(thresh);
+    FunctionDefaults<NDIM>::set_refine(true);
+    FunctionDefaults<NDIM>::set_initial_level(3);
+    FunctionDefaults<NDIM>::set_truncate_mode(1);
+
+    if (world.rank() == 0)
+        print("testing grad operator<",archive::get_type_name<T>(),"> on",world.size(),"processes");
+
+    ffunctorT functor(RandomGaussian<T,NDIM>(FunctionDefaults<NDIM>::get_cell(),10.0));
+    Function<T,NDIM> f=FunctionFactory<T,NDIM>(world).functor(functor);
+
+    START_TIMER;
+    std::vector<Function<T,NDIM> > g=grad(f);
+    END_TIMER("grad with halo");
+
+    // without fence and halo the neighbors are fetched node by node
+    double err=0.0;
+    for (std::size_t axis=0; axis<NDIM; ++axis) {
+        Derivative<T,NDIM> D=free_space_derivative<T,NDIM>(world,axis);
+        Function<T,NDIM> ref=D(f,false);
+        world.gop.fence();
+        err+=(g[axis]-ref).norm2();
+    }
+    if (world.rank() == 0) print("error of grad with halo",err);
+    MADNESS_CHECK_THROW(err<1.e-12, "grad with halo differs from the derivatives");
+
+    // a halo that is still alive must not be used for the updated function
+    Derivative<T,NDIM> D=free_space_derivative<T,NDIM>(world,0);
+    std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=D.make_halo(f);
+    Function<T,NDIM> df1=D(f,halo,false);
+    world.gop.fence();
+    f.scale(2.0);
+    Function<T,NDIM> df2=D(f,false);
+    world.gop.fence();
+    err=(df2-2.0*df1).norm2();
+    if (world.rank() == 0) print("error of the derivative after an update",err);
+    MADNESS_CHECK_THROW(err<1.e-12, "derivative used a stale halo");
+}
+
+/// BlockNonlinearSolver on the independent equations u_j = s_j g u_j + f,
+/// against one NonlinearSolverND per column
+template <std::size_t NDIM>
+void test_block_kain(World& world) {
+    typedef Function<double,NDIM> functionT;
+    typedef std::vector<functionT> vecfuncT;
+
+    FunctionDefaults<NDIM>::set_cubic_cell(-10.0,10.0);
+    FunctionDefaults<NDIM>::set_k(8);
+    FunctionDefaults<NDIM>::set_thresh(1.e-6);
+    FunctionDefaults<NDIM>::set_refine(true);
+    FunctionDefaults<NDIM>::set_initial_level(3);
+    FunctionDefaults<NDIM>::set_truncate_mode(1);
+
+    if (world.rank() == 0) print("testing block KAIN solver in",NDIM,"dimensions");
+
+    const std::vector<double> s={0.2,0.4,0.6};
+    const std::size_t n=s.size();
+    const double tol=1.e-5;
+    functionT g=FunctionFactory<double,NDIM>(world)
+            .functor([](const Vector<double,NDIM>& r) {return exp(-inner(r,r));});
+    functionT f=FunctionFactory<double,NDIM>(world)
+            .functor([](const Vector<double,NDIM>& r) {return exp(-0.5*inner(r,r));});
+
+    auto residual=[&](const functionT& u, const double sj) {
+        u.reconstruct();
+        return (u-sj*(g*u)-f).truncate();
+    };
+
+    // all columns in one block, converged columns are deflated
+    BlockNonlinearSolver<double,NDIM> block(world,n);
+    vecfuncT ublock(n);
+    for (std::size_t j=0; j<n; ++j) ublock[j]=copy(f);
+    for (int iter=0; iter<30; ++iter) {
+        const std::vector<std::size_t> active=block.active();
+        vecfuncT u, r;
+        for (std::size_t j : active) {
+            functionT rj=residual(ublock[j],s[j]);
+            if (rj.norm2()<tol) {
+                block.deflate(j);
+            } else {
+                u.push_back(ublock[j]);
+                r.push_back(rj);
+            }
+        }
+        if (u.empty()) break;
+        vecfuncT unew=block.update(u,r);
+        for (std::size_t a=0; a<unew.size(); ++a) ublock[block.active()[a]]=unew[a];
+    }
+    MADNESS_CHECK_THROW(block.active().empty(), "block KAIN did not converge");
+
+    // the same iterations column by column
+    double err=0.0;
+    for (std::size_t j=0; j<n; ++j) {
+        NonlinearSolverND<NDIM> solver;
+        functionT u=copy(f);
+        for (int iter=0; iter<30; ++iter) {
+            functionT r=residual(u,s[j]);
+            if (r.norm2()<tol) break;
+            u=solver.update(u,r);
+        }
+        const double sj=s[j];
+        functionT exact=FunctionFactory<double,NDIM>(world).functor([sj](const Vector<double,NDIM>& r) {
+            return exp(-0.5*inner(r,r))/(1.0-sj*exp(-inner(r,r)));
+        });
+        const double diff=(ublock[j]-u).norm2();
+        const double error=(ublock[j]-exact).norm2();
+        if (world.rank() == 0) print("column",j,"difference to single KAIN",diff,"error",error);
+        err=std::max(err,diff);
+        MADNESS_CHECK_THROW(error<10.0*tol, "block KAIN converged to the wrong solution");
+    }
+    MADNESS_CHECK_THROW(err<1.e-10, "block KAIN differs from single KAIN");
+}
+
 template<typename T, int NDIM>
 void test_matrix_mul_sparse(World &world) {
     typedef std::shared_ptr<FunctionFunctorInterface<T, NDIM> > ffunctorT;
@@ -427,6 +555,8 @@ int main(int argc, char**argv) {
 
         test_rot<double,3>(world);
         test_rot<std::complex<double>,3>(world);
+        test_grad<double,3>(world);
+        test_block_kain<1>(world);
 
         test_matrix_mul_sparse<double,2>(world);
         test_matrix_mul_sparse<double,3>(world);
@@ -41,6 +41,7 @@ using std::ios;
 using std::abs;
 
 #include <madness/mra/twoscale.h>
+#include <madness/mra/mra_data.h>
 #include <madness/tensor/tensor.h>
 #include <madness/misc/misc.h>
 
@@ -64,15 +65,24 @@ namespace madness {
     }
     cache[kmax+1];
 
+    bool detail::have_embedded_mra_data() {
+#ifdef MADNESS_HAS_EMBEDDED_MRA_DATA
+        return true;
+#else
+        return false;
+#endif
+    }
+
     static bool loaded = 0;
+    static bool use_embedded = false;  // If true read from the tables compiled into the library
 
 
-    static Tensor<double> readmat(int k, FILE* file) {
+    static Tensor<double> readmat(int k, detail::MRADataReader& file) {
         Tensor<double> a(k,k);
         for (int i=0; i<k; ++i) {
             for (int j=0; j<k; ++j) {
                 double c;
-                if (fscanf(file,"%lf",&c) != 1) {
+                if (!file.next(c)) {
                     cout << "readmat: twoscale missing coeff?\n";
                     throw "readmat";
                 }
@@ -87,11 +97,19 @@ namespace madness {
     }
 
     static bool read_twoscale(int kmax) {
-        unsigned long correct = 6931979l;
-        unsigned long computed = checksum_file(twoscale_filename);
-        MADNESS_CHECK(correct == computed);
-        FILE* file = fopen(twoscale_filename,"r");
-        if (!file) {
+#ifdef MADNESS_HAS_EMBEDDED_MRA_DATA
+        detail::MRADataReader file = use_embedded ?
+            detail::MRADataReader(detail::mra_twoscale_data, detail::mra_twoscale_data_size) :
+            detail::MRADataReader(twoscale_filename);
+#else
+        detail::MRADataReader file(twoscale_filename);
+#endif
+        if (!use_embedded) {
+            unsigned long correct = 6931979l;
+            unsigned long computed = checksum_file(twoscale_filename);
+            MADNESS_CHECK(correct == computed);
+        }
+        if (!file.good()) {
             cout << "twoscale: failed opening file with twoscale coefficients\n";
             return false;
         }
@@ -102,7 +120,6 @@ namespace madness {
                 g0 = readmat(k,file);
             }
             catch (char *e) {
-                fclose(file);
                 return false;
             }
 
@@ -121,7 +138,6 @@ namespace madness {
             cache[k].g0 = g0;
             cache[k].g1 = g1;
         }
-        fclose(file);
 
         loaded = true;
         return true;
@@ -265,10 +281,16 @@ namespace madness {
     }
 
     static bool read_data(int k) {
-        if (!test_autoc()) return false;
+#ifdef MADNESS_HAS_EMBEDDED_MRA_DATA
+        detail::MRADataReader file = use_embedded ?
+            detail::MRADataReader(detail::mra_autocorr_data, detail::mra_autocorr_data_size) :
+            detail::MRADataReader(autocorr_filename);
+#else
+        detail::MRADataReader file(autocorr_filename);
+#endif
+        if (!use_embedded && !test_autoc()) return false;
         kread = -1;
-        FILE *file = fopen(autocorr_filename,"r");
-        if (!file) {
+        if (!file.good()) {
             cout << "autoc: failed opening file with autocorrelation coefficients" << endl;
             return false;
         }
@@ -279,9 +301,8 @@ namespace madness {
         while (1) {
             long i, j, p;
             double val;
-            if (fscanf(file,"%ld %ld %ld %lf",&i,&j,&p,&val) != 4) {
+            if (!(file.next(i) && file.next(j) && file.next(p) && file.next(val))) {
                 cout<<"autoc: failed reading file " << endl;
-                fclose(file);
                 return false;
             }
             if (i >= k) break;
@@ -294,17 +315,27 @@ namespace madness {
             _cread(j,i,p+twok) = val*ij;
         }
 
-        fclose(file);
         kread = k;
         return true;
     }
 
     /// Collective routine to load and cache twoscale & autorrelation coefficients
 
-    /// Only process rank 0 will access the files.
+    /// Only process rank 0 will access the files.  If \c dir is null
+    /// the tables compiled into the library are used instead, in which
+    /// case every process unpacks them locally and there is no communication.
     void load_coeffs(World& world, const char* dir) {
         if (!loaded) {
             int ktop = kmax_autoc;   // Plausible maximum value
+            if (!dir) {
+                MADNESS_CHECK(detail::have_embedded_mra_data());
+                use_embedded = true;
+                if (!read_twoscale(kmax))
+                    throw "load_coeffs: failed reading embedded twoscale coeffs";
+                if (!read_data(ktop))
+                    throw "load_coeffs: failed reading embedded coeffs";
+                return;
+            }
             if (world.rank() == 0) {
                 char buf[32768];
                 buf[0] = 0;
@@ -0,0 +1,255 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+#ifndef MADNESS_MRA_UNIFORM_GRID_H__INCLUDED
+#define MADNESS_MRA_UNIFORM_GRID_H__INCLUDED
+
+/// \file uniform_grid.h
+/// \brief Transforms between Functions and uniform (FFT) grids over the simulation cell
+
+/// The grid has \c npt[d] points in dimension \c d at the simulation
+/// coordinates \f$ x_j = j/n_d \f$, \f$ j=0,\ldots,n_d-1 \f$, i.e., the
+/// usual grid of a periodic FFT over the cell (the upper face is the image
+/// of the lower one).  Like Function::eval_cube() the grid is replicated on
+/// all processes.
+///
+/// Function to grid evaluates all grid points inside a leaf box at once as
+/// a tensor-product transform of the coefficients with the values of the
+/// scaling functions at the grid points of the box, instead of summing the
+/// basis for every point.
+///
+/// Grid to function projects with per-box quadrature, the values at the
+/// quadrature points being obtained by tensor-product (periodic) Lagrange
+/// interpolation of the grid.
+
+#include <madness/mra/mra.h>
+#include <madness/mra/legendre.h>
+#include <cmath>
+#include <vector>
+
+namespace madness {
+
+    namespace detail {
+
+        /// Index of the first point of an \c npt point grid in box \c l at level \c n
+        inline long uniform_grid_first(Level n, Translation l, long npt) {
+            const Translation twon = Translation(1)<<n;
+            return long((l*npt + twon - 1)/twon);
+        }
+
+        /// Values of the scaling functions of box \c l at level \c n at the grid points j0..j1-1
+
+        /// Returns phi(mu,j-j0), including the normalization 2^(n/2) of the box
+        inline Tensor<double> uniform_grid_phi(Level n, Translation l, long j0, long j1, long npt, int k) {
+            Tensor<double> phi(k, j1-j0);
+            const double twon = std::pow(2.0,double(n));
+            const double scale = std::sqrt(twon);
+            std::vector<double> p(k);
+            for (long j=j0; j<j1; ++j) {
+                legendre_scaling_functions(twon*double(j)/double(npt) - double(l), k, &p[0]);
+                for (int mu=0; mu<k; ++mu) phi(mu,j-j0) = p[mu]*scale;
+            }
+            return phi;
+        }
+
+        /// Evaluates the grid points inside a leaf box (task body of function_to_uniform_grid)
+        template <typename T, std::size_t NDIM>
+        void uniform_grid_box(Tensor<T>* grid, const Key<NDIM>& key, const Tensor<T>& coeff,
+                              const std::vector<long>& npt) {
+            const Level n = key.level();
+            const int k = coeff.dim(0);
+            std::vector<Slice> s(NDIM);
+            Tensor<double> phi[NDIM];
+            for (std::size_t d=0; d<NDIM; ++d) {
+                const Translation l = key.translation()[d];
+                const long j0 = uniform_grid_first(n, l, npt[d]);
+                const long j1 = uniform_grid_first(n, l+1, npt[d]);
+                if (j1 <= j0) return; // no grid point in this box
+                phi[d] = uniform_grid_phi(n, l, j0, j1, npt[d], k);
+                s[d] = Slice(j0, j1-1);
+            }
+            const double scale = 1.0/std::sqrt(FunctionDefaults<NDIM>::get_cell_volume());
+            (*grid)(s) = general_transform(coeff, phi).scale(scale);
+        }
+
+        /// Lagrange interpolation weights of \c order points around \c u on a periodic integer grid
+
+        /// On output \c first is the (unwrapped) index of the first point
+        inline void uniform_grid_lagrange(double u, int order, long& first, double* w) {
+            first = long(std::floor(u)) - (order-1)/2;
+            for (int i=0; i<order; ++i) {
+                double wi = 1.0;
+                for (int m=0; m<order; ++m) {
+                    if (m != i) wi *= (u - double(first+m))/double(i-m);
+                }
+                w[i] = wi;
+            }
+        }
+    }
+
+
+    /// Functor interpolating a replicated uniform grid (see uniform_grid.h)
+
+    /// It provides the coefficients of a box directly by quadrature of the
+    /// interpolant, so projection never evaluates single points.
+    template <typename T, std::size_t NDIM>
+    class UniformGridFunctor : public FunctionFunctorInterface<T,NDIM> {
+        typedef GenTensor<T> coeffT;
+        typedef Vector<double,NDIM> coordT;
+
+        const Tensor<T> grid;
+        const int order;    ///< number of grid points used in each dimension to interpolate
+        const int k;        ///< wavelet order of the projected function
+
+        /// The grid points and interpolation weights for the points \c x of one dimension
+
+        /// W(j,i) is the weight of grid point index[j] for x[i]
+        void weights(int d, const Tensor<double>& x, std::vector<long>& index, Tensor<double>& W) const {
+            const long npt = grid.dim(d);
+            const long nx = x.size();
+            std::vector<long> first(nx);
+            Tensor<double> w(nx, long(order));
+            long lo = 0, hi = 0;
+            for (long i=0; i<nx; ++i) {
+                detail::uniform_grid_lagrange(x(i)*npt, order, first[i], &w(i,0));
+                if (i == 0 || first[i] < lo) lo = first[i];
+                if (i == 0 || first[i]+order-1 > hi) hi = first[i]+order-1;
+            }
+            index.resize(hi-lo+1);
+            for (long j=lo; j<=hi; ++j) index[j-lo] = ((j % npt) + npt) % npt;
+            W = Tensor<double>(hi-lo+1, nx);
+            for (long i=0; i<nx; ++i)
+                for (int m=0; m<order; ++m) W(first[i]+m-lo, i) = w(i,m);
+        }
+
+        /// Copies the grid points used for interpolation (wrapping periodically)
+        Tensor<T> gather(const std::vector<long> index[NDIM]) const {
+            std::vector<long> dims(NDIM);
+            for (std::size_t d=0; d<NDIM; ++d) dims[d] = index[d].size();
+            Tensor<T> patch(dims);
+            std::vector<long> ind(NDIM);
+            for (IndexIterator it(dims); it; ++it) {
+                for (std::size_t d=0; d<NDIM; ++d) ind[d] = index[d][it[d]];
+                patch(*it) = grid(ind);
+            }
+            return patch;
+        }
+
+    public:
+        /// @param[in] grid the values on the uniform grid over the simulation cell
+        /// @param[in] order number of points for the Lagrange interpolation in each dimension
+        /// @param[in] k wavelet order of the function to be projected
+        UniformGridFunctor(const Tensor<T>& grid, int order=6, int k=FunctionDefaults<NDIM>::get_k())
+            : grid(grid), order(order), k(k) {
+            MADNESS_CHECK(grid.ndim() == long(NDIM));
+            for (std::size_t d=0; d<NDIM; ++d) MADNESS_CHECK(grid.dim(d) >= order);
+        }
+
+        bool provides_coeff() const {return true;}
+
+        /// Projects the interpolant onto the box by Gauss-Legendre quadrature
+        coeffT coeff(const Key<NDIM>& key) const {
+            const FunctionCommonData<T,NDIM>& cdata = FunctionCommonData<T,NDIM>::get(k);
+            const Level n = key.level();
+            const double h = std::pow(0.5,double(n));
+
+            std::vector<long> index[NDIM];
+            Tensor<double> W[NDIM];
+            for (std::size_t d=0; d<NDIM; ++d) {
+                Tensor<double> x = (cdata.quad_x + double(key.translation()[d]))*h;
+                weights(d, x, index[d], W[d]);
+            }
+            Tensor<T> values = general_transform(gather(index), W);
+            const double scale = std::pow(0.5,0.5*NDIM*n)*std::sqrt(FunctionDefaults<NDIM>::get_cell_volume());
+            Tensor<T> c = transform(values, cdata.quad_phiw).scale(scale);
+            return coeffT(c, -1.0, TT_FULL);
+        }
+
+        /// Interpolates the grid at a point in user coordinates
+        T operator()(const coordT& xuser) const {
+            coordT xsim;
+            user_to_sim(xuser, xsim);
+            std::vector<long> index[NDIM];
+            Tensor<double> W[NDIM];
+            for (std::size_t d=0; d<NDIM; ++d) {
+                Tensor<double> x(1L);
+                x[0] = xsim[d];
+                weights(d, x, index[d], W[d]);
+            }
+            return general_transform(gather(index), W).sum();
+        }
+    };
+
+
+    /// Evaluates a function on a uniform grid over the simulation cell (see uniform_grid.h)
+
+    /// Collective with fence, the result is replicated on all processes.
+    /// @param[in] f the function
+    /// @param[in] npt number of grid points in each dimension
+    /// @return the values at the grid points x_j = j/npt in simulation coordinates
+    template <typename T, std::size_t NDIM>
+    Tensor<T> function_to_uniform_grid(const Function<T,NDIM>& f, const std::vector<long>& npt) {
+        MADNESS_CHECK(npt.size() >= NDIM);
+        World& world = f.world();
+        f.reconstruct();
+        Tensor<T> grid(NDIM, &npt[0]);
+
+        typedef typename FunctionImpl<T,NDIM>::dcT dcT;
+        const dcT& coeffs = f.get_impl()->get_coeffs();
+        for (typename dcT::const_iterator it=coeffs.begin(); it!=coeffs.end(); ++it) {
+            if (it->second.has_coeff()) {
+                world.taskq.add(&detail::uniform_grid_box<T,NDIM>, &grid, it->first,
+                                it->second.coeff().full_tensor_copy(), npt);
+            }
+        }
+        world.taskq.fence();
+        world.gop.sum(grid.ptr(), grid.size());
+        world.gop.fence();
+        return grid;
+    }
+
+
+    /// Makes a function from its values on a uniform grid over the simulation cell (see uniform_grid.h)
+
+    /// Collective.  The grid must be the same on all processes.
+    /// Call as uniform_grid_to_function<NDIM>(world, grid).
+    /// @param[in] world the world
+    /// @param[in] grid values at the grid points x_j = j/npt in simulation coordinates
+    /// @param[in] order number of points for the Lagrange interpolation in each dimension
+    template <std::size_t NDIM, typename T>
+    Function<T,NDIM> uniform_grid_to_function(World& world, const Tensor<T>& grid, int order=6) {
+        std::shared_ptr< FunctionFunctorInterface<T,NDIM> > functor(new UniformGridFunctor<T,NDIM>(grid, order));
+        return FunctionFactory<T,NDIM>(world).functor(functor);
+    }
+
+}
+
+#endif // MADNESS_MRA_UNIFORM_GRID_H__INCLUDED
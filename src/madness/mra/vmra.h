@@ -123,6 +123,7 @@
 #include <madness/mra/derivative.h>
 #include <madness/tensor/distributed_matrix.h>
 #include <cstdio>
+#include <unistd.h>
 
 namespace madness {
 
@@ -1325,6 +1326,47 @@ namespace madness {
     }
 
 
+    /// Applies several operators to one function --- q[i] = apply(op[i],f)
+
+    /// The function is converted to the nonstandard form once for all
+    /// operators, which are applied without intermediate fences; the results
+    /// are reconstructed together while the input is restored.
+    template <typename opT, typename R, std::size_t NDIM>
+    std::vector< Function<TENSOR_RESULT_TYPE(typename opT::opT,R), NDIM> >
+    apply(World& world,
+          const std::vector< std::shared_ptr<opT> >& op,
+          const Function<R,NDIM>& f) {
+
+        PROFILE_BLOCK(Vapplyop);
+        Function<R,NDIM>& ff = const_cast< Function<R,NDIM>& >(f);
+
+        bool keepleaves=false;
+        for (const auto& o : op) {
+            MADNESS_CHECK(not o->modified() and not o->is_slaterf12 and not o->destructive());
+            keepleaves = keepleaves or o->doleaves;
+        }
+        ff.make_nonstandard(keepleaves, true);
+
+        std::vector< Function<TENSOR_RESULT_TYPE(typename opT::opT,R), NDIM> > result(op.size());
+        for (unsigned int i=0; i<op.size(); ++i) {
+            result[i] = apply_only(*op[i], ff, false);
+        }
+        world.gop.fence();
+
+        // svd-tensor requires some cleanup after apply
+        if (result.size() and result[0].get_impl()->get_tensor_type()==TT_2D) {
+            for (auto& r : result) r.get_impl()->finalize_apply(false);
+            world.gop.fence();
+        }
+
+        ff.standard(false);  // restores promise of logical constness
+        reconstruct(world, result, false);
+        world.gop.fence();
+
+        return result;
+    }
+
+
     /// Applies an operator to a vector of functions --- q[i] = apply(op,f[i])
     template <typename T, typename R, std::size_t NDIM, std::size_t KDIM>
     std::vector< Function<TENSOR_RESULT_TYPE(T,R), NDIM> >
@@ -1385,15 +1427,26 @@ namespace madness {
         if (fence) world.gop.fence();
     }
 
+    /// Returns the tree statistics of all functions ... one global reduction for the whole vector
+    template <typename T, std::size_t NDIM>
+    std::vector<FunctionTreeStats> tree_stats(World& world, const std::vector<Function<T,NDIM> >& v) {
+        std::vector<FunctionTreeStats> stats(v.size());
+        if (v.empty()) return stats;
+        for (std::size_t i=0; i<v.size(); ++i) {
+            if (v[i].is_initialized()) stats[i]=v[i].get_impl()->tree_stats_local();
+        }
+        world.gop.reduce(&stats[0], stats.size(), FunctionTreeStats::combine());
+        return stats;
+    }
+
     template <typename T, std::size_t NDIM>
     void print_size(World &world, const std::vector<Function<T,NDIM> > &v, const std::string &msg = "vectorfunction" ){
     	if(v.empty()){
     		if(world.rank()==0) std::cout << "print_size: " << msg << " is empty" << std::endl;
-    	}else if(v.size()==1){
-    		v.front().print_size(msg);
     	}else{
-    		for(auto x:v){
-    			x.print_size(msg);
+    		std::vector<FunctionTreeStats> stats=tree_stats(world,v);
+    		if (world.rank()==0) {
+    			for (const FunctionTreeStats& s : stats) s.print_size(msg,sizeof(T));
     		}
     	}
     }
@@ -1408,9 +1461,7 @@ namespace madness {
         const double fac=1024*1024*1024;
 
         double size=0.0;
-        for(unsigned int i=0;i<v.size();i++){
-            if (v[i].is_initialized()) size+=v[i].size();
-        }
+        for (const FunctionTreeStats& s : tree_stats(world,v)) size+=s.size;
 
         return size/fac*d;
 
@@ -1596,8 +1647,10 @@ namespace madness {
         std::vector< std::shared_ptr< Derivative<T,NDIM> > > grad=
                 gradient_operator<T,NDIM>(world);
 
+        // one halo exchange serves all axes
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=grad[0]->make_halo(f);
         std::vector<Function<T,NDIM> > result(NDIM);
-        for (size_t i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
+        for (std::size_t i=0; i<NDIM; ++i) result[i]=(*grad[i])(f,halo,false);
         if (fence) world.gop.fence();
         return result;
     }
@@ -1617,8 +1670,10 @@ namespace madness {
         // Read in new coeff for each operator
         for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_ble1();
 
+        // one halo exchange serves all axes
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=grad[0]->make_halo(f);
         std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
+        for (std::size_t i=0; i<NDIM; ++i) result[i]=(*grad[i])(f,halo,false);
         if (fence) world.gop.fence();
         return result;
     }
@@ -1638,8 +1693,10 @@ namespace madness {
         // Read in new coeff for each operator
         for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_ble2();
 
+        // one halo exchange serves all axes
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=grad[0]->make_halo(f);
         std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
+        for (std::size_t i=0; i<NDIM; ++i) result[i]=(*grad[i])(f,halo,false);
         if (fence) world.gop.fence();
         return result;
     }
@@ -1659,8 +1716,10 @@ namespace madness {
         // Read in new coeff for each operator
         for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_bspline1();
 
+        // one halo exchange serves all axes
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=grad[0]->make_halo(f);
         std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
+        for (std::size_t i=0; i<NDIM; ++i) result[i]=(*grad[i])(f,halo,false);
         if (fence) world.gop.fence();
         return result;
     }
@@ -1680,8 +1739,10 @@ namespace madness {
         // Read in new coeff for each operator
         for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_bspline2();
 
+        // one halo exchange serves all axes
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=grad[0]->make_halo(f);
         std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
+        for (std::size_t i=0; i<NDIM; ++i) result[i]=(*grad[i])(f,halo,false);
         if (fence) world.gop.fence();
         return result;
     }
@@ -1701,8 +1762,10 @@ namespace madness {
         // Read in new coeff for each operator
         for (unsigned int i=0; i<NDIM; ++i) (*grad[i]).set_bspline3();
 
+        // one halo exchange serves all axes
+        std::shared_ptr<const DerivativeHalo<T,NDIM> > halo=grad[0]->make_halo(f);
         std::vector<Function<T,NDIM> > result(NDIM);
-        for (unsigned int i=0; i<NDIM; ++i) result[i]=apply(*(grad[i]),f,false);
+        for (std::size_t i=0; i<NDIM; ++i) result[i]=(*grad[i])(f,halo,false);
         if (fence) world.gop.fence();
         return result;
     }
@@ -1839,6 +1902,94 @@ namespace madness {
         }
     }
 
+    namespace detail {
+        /// file names of save_function_parallel: the manifest and the nodes of each writer
+        inline std::string parallel_function_file(const std::string name, const int iwriter=-1) {
+            if (iwriter<0) return name+".manifest";
+            char buf[16];
+            snprintf(buf,sizeof(buf),".%5.5d",iwriter);
+            return name+buf;
+        }
+
+        static const long parallel_function_magic=7776769;
+    }
+
+    /// save a vector of functions, every process writing its own file
+
+    /// In contrast to save_function the coefficients are not funneled through
+    /// io nodes: each process writes the nodes it owns of all functions to
+    /// name.<rank>, concurrently and without communication.  Process 0
+    /// writes the parameters of the functions to name.manifest.
+    /// The files must be visible to all processes when loading.
+    template<typename T, size_t NDIM>
+    void save_function_parallel(World& world, const std::vector<Function<T,NDIM> >& f,
+            const std::string name) {
+        if (world.rank()==0) print("saving vector of functions in parallel",name);
+        world.gop.fence();
+        if (world.rank()==0) {
+            archive::BinaryPosixOutputArchive ar(detail::parallel_function_file(name).c_str());
+            ar & detail::parallel_function_magic & long(TensorTypeData<T>::id) & long(NDIM);
+            ar & int(world.size()) & f.size();
+            for (const Function<T,NDIM>& ff : f) {
+                ff.verify();
+                ar & long(ff.k());
+                ff.get_impl()->store_parameters(ar);
+            }
+        }
+        archive::BinaryPosixOutputArchive ar(detail::parallel_function_file(name,world.rank()).c_str());
+        ar & detail::parallel_function_magic & f.size();
+        for (const Function<T,NDIM>& ff : f) ff.get_impl()->store_local_nodes(ar);
+        ar.close();
+        world.gop.fence();
+    }
+
+    /// load a vector of functions written by save_function_parallel
+
+    /// The number of processes may differ from that of the writer: the files
+    /// are distributed round robin and their nodes sent to the owners.
+    template<typename T, size_t NDIM>
+    void load_function_parallel(World& world, std::vector<Function<T,NDIM> >& f,
+            const std::string name) {
+        if (world.rank()==0) print("loading vector of functions in parallel",name);
+        int nwriter=0;
+        {
+            archive::BinaryPosixInputArchive ar(detail::parallel_function_file(name).c_str());
+            long magic=0, id=0, ndim=0;
+            ar & magic & id & ndim;
+            MADNESS_CHECK(magic==detail::parallel_function_magic);
+            MADNESS_CHECK(id==TensorTypeData<T>::id);
+            MADNESS_CHECK(ndim==long(NDIM));
+            std::size_t fsize=0;
+            ar & nwriter & fsize;
+            f.resize(fsize);
+            for (Function<T,NDIM>& ff : f) {
+                long k=0;
+                ar & k;
+                ff=FunctionFactory<T,NDIM>(world).k(k).empty();
+                ff.get_impl()->load_parameters(ar);
+            }
+        }
+        world.gop.fence();
+
+        for (int iwriter=world.rank(); iwriter<nwriter; iwriter+=world.size()) {
+            archive::BinaryPosixInputArchive ar(detail::parallel_function_file(name,iwriter).c_str());
+            long magic=0;
+            std::size_t fsize=0;
+            ar & magic & fsize;
+            MADNESS_CHECK(magic==detail::parallel_function_magic and fsize==f.size());
+            for (Function<T,NDIM>& ff : f) ff.get_impl()->load_nodes(ar);
+        }
+        world.gop.fence();
+    }
+
+    /// true if name.manifest exists, i.e. name was written by save_function_parallel
+    inline bool is_parallel_function_file(World& world, const std::string name) {
+        bool status=false;
+        if (world.rank()==0) status=(access(detail::parallel_function_file(name).c_str(),F_OK|R_OK)==0);
+        world.gop.broadcast(status);
+        return status;
+    }
+
 
 }
 #endif // MADNESS_MRA_VMRA_H__INCLUDED
@@ -0,0 +1,463 @@
+#ifndef MADNESS_BLOCK_CYCLIC_MATRIX_H
+#define MADNESS_BLOCK_CYCLIC_MATRIX_H
+
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+/// \file block_cyclic_matrix.h
+/// \brief 2D block-cyclic distributed matrix with SUMMA-style multiplication
+
+// The 1D (row/column) distributions in distributed_matrix.h place one
+// tile per process, which is fine for the systolic algorithms but does
+// not permit a distributed matrix multiply.  The classes here lay the
+// matrix out as (nb,mb) blocks dealt cyclically over a (Pr,Pc) process
+// grid.  All data motion goes through the WorldObject active-message
+// layer so that communication overlaps with the tasks consuming it.
+
+#include <madness/world/MADworld.h>
+#include <madness/tensor/tensor.h>
+#include <madness/tensor/distributed_matrix.h>
+#include <map>
+#include <memory>
+#include <utility>
+#include <cmath>
+
+namespace madness {
+
+    template <typename T> class BlockCyclicMatrix;
+
+    namespace detail {
+
+        /// Accumulates c += a*b for a single block and returns c
+        template <typename T>
+        Tensor<T> block_gemm_accumulate(Tensor<T> c, const Tensor<T>& a, const Tensor<T>& b) {
+            inner_result(a, b, 1, 0, c);
+            return c;
+        }
+
+        /// Copies the transpose of \c a into \c c
+        template <typename T>
+        void block_copy_transposed(Tensor<T> c, const Tensor<T>& a) {
+            c(___) = a.swapdim(0,1);
+        }
+
+        /// Copies \c patch into \c c at local offset (i0,j0)
+        template <typename T>
+        void block_copy_patch(Tensor<T> c, int64_t i0, int64_t j0, const Tensor<T>& patch) {
+            c(Slice(i0,i0+patch.dim(0)-1),Slice(j0,j0+patch.dim(1)-1)) = patch;
+        }
+
+        /// Holds the local blocks of a BlockCyclicMatrix and answers remote requests for them
+
+        /// Not for direct use ... access is via BlockCyclicMatrix which
+        /// holds a shared pointer to the implementation (PIMPL, as for WorldContainer).
+        template <typename T>
+        class BlockCyclicMatrixImpl : public WorldObject< BlockCyclicMatrixImpl<T> > {
+            typedef WorldObject< BlockCyclicMatrixImpl<T> > baseT;
+            typedef std::pair<int64_t,int64_t> keyT;
+            friend class BlockCyclicMatrix<T>;
+
+            const int64_t n;            ///< Column dimension of A(n,m)
+            const int64_t m;            ///< Row dimension of A(n,m)
+            const int64_t nb;           ///< Block size for the column dimension
+            const int64_t mb;           ///< Block size for the row dimension
+            const int64_t nblockn;      ///< No. of blocks in the column dimension
+            const int64_t nblockm;      ///< No. of blocks in the row dimension
+            const int64_t Pr;           ///< No. of process rows in the grid
+            const int64_t Pc;           ///< No. of process columns in the grid
+            const int64_t myrow;        ///< Process row of this process
+            const int64_t mycol;        ///< Process column of this process
+
+            /// Local blocks ... the map is only modified in the constructor
+            /// so concurrent lookups from active messages and tasks are safe
+            std::map<keyT,Tensor<T> > blocks;
+
+        public:
+            BlockCyclicMatrixImpl(World& world, int64_t n, int64_t m, int64_t nb, int64_t mb, int64_t Pr)
+                : baseT(world)
+                , n(n)
+                , m(m)
+                , nb(nb)
+                , mb(mb)
+                , nblockn((n-1)/nb+1)
+                , nblockm((m-1)/mb+1)
+                , Pr(Pr)
+                , Pc(world.size()/Pr)
+                , myrow(world.rank()/Pc)
+                , mycol(world.rank()-myrow*Pc)
+            {
+                MADNESS_CHECK(n>0 && m>0 && nb>0 && mb>0);
+                MADNESS_CHECK(Pr>0 && Pr*Pc==world.size());
+                if (myrow < Pr) {
+                    for (int64_t bi=myrow; bi<nblockn; bi+=Pr) {
+                        for (int64_t bj=mycol; bj<nblockm; bj+=Pc) {
+                            blocks[keyT(bi,bj)] = Tensor<T>(block_coldim(bi),block_rowdim(bj));
+                        }
+                    }
+                }
+                this->process_pending();
+            }
+
+            virtual ~BlockCyclicMatrixImpl() {}
+
+            int64_t block_coldim(int64_t bi) const {return std::min(nb, n-bi*nb);}
+
+            int64_t block_rowdim(int64_t bj) const {return std::min(mb, m-bj*mb);}
+
+            ProcessID owner(int64_t bi, int64_t bj) const {
+                return (bi%Pr)*Pc + (bj%Pc);
+            }
+
+            bool is_local(int64_t bi, int64_t bj) const {
+                return owner(bi,bj) == this->get_world().rank();
+            }
+
+            /// Returns a (shallow) reference to a local block
+            Tensor<T> local_block(int64_t bi, int64_t bj) const {
+                typename std::map<keyT,Tensor<T> >::const_iterator it = blocks.find(keyT(bi,bj));
+                MADNESS_CHECK(it != blocks.end());
+                return it->second;
+            }
+
+            /// Returns a copy of the patch [i0,i1]x[j0,j1] (local indices) of a local block
+            Tensor<T> get_patch(int64_t bi, int64_t bj, int64_t i0, int64_t i1, int64_t j0, int64_t j1) const {
+                return copy(local_block(bi,bj)(Slice(i0,i1),Slice(j0,j1)));
+            }
+
+            /// Stores a patch into a local block at local offset (i0,j0)
+            void set_patch(int64_t bi, int64_t bj, int64_t i0, int64_t j0, const Tensor<T>& patch) {
+                block_copy_patch(local_block(bi,bj), i0, j0, patch);
+            }
+
+            /// Returns a future to block (bi,bj) which may be remote
+            Future< Tensor<T> > fetch(int64_t bi, int64_t bj) const {
+                if (is_local(bi,bj)) return Future< Tensor<T> >(local_block(bi,bj));
+                return this->task(owner(bi,bj), &BlockCyclicMatrixImpl<T>::local_block, bi, bj);
+            }
+        };
+    }
+
+
+    /// A matrix distributed in (nb,mb) blocks cyclically over a 2D process grid
+
+    /// Block (bi,bj) lives on process (bi%Pr)*Pc + (bj%Pc) of the (Pr,Pc)
+    /// grid.  The local data is a set of contiguous tensors, one per
+    /// owned block.
+    ///
+    /// Construction is collective and, as for \c WorldContainer, must be
+    /// executed in the same order on all processes.  Assignment and copy
+    /// are shallow.  Operations that move data between processes (gemm,
+    /// transpose, redistribution) are collective and end with a fence.
+    template <typename T>
+    class BlockCyclicMatrix {
+        typedef detail::BlockCyclicMatrixImpl<T> implT;
+        typedef std::pair<int64_t,int64_t> keyT;
+
+        std::shared_ptr<implT> p;
+
+    public:
+
+        /// Default constructor makes an empty matrix that cannot be used except as a target for assignemnt
+        BlockCyclicMatrix() : p() {}
+
+        /// Makes a zero (n,m) matrix with block sizes (nb,mb) (collective)
+
+        /// @param[in] world The world
+        /// @param[in] n The matrix column dimension
+        /// @param[in] m The matrix row dimension
+        /// @param[in] nb Block size for the column dimension
+        /// @param[in] mb Block size for the row dimension
+        /// @param[in] Pr No. of process rows (default is the most square grid)
+        BlockCyclicMatrix(World& world, int64_t n, int64_t m, int64_t nb, int64_t mb, int64_t Pr=0)
+            : p(new implT(world, n, m, nb, mb, Pr>0 ? Pr : default_process_rows(world.size())))
+        {}
+
+        virtual ~BlockCyclicMatrix() {
+            if (p) detail::deferred_cleanup(p->get_world(), p);
+        }
+
+        /// Returns the largest divisor of \c nproc that does not exceed its square root
+        static int64_t default_process_rows(int64_t nproc) {
+            int64_t pr = int64_t(std::sqrt(double(nproc)));
+            while (pr>1 && (nproc%pr)) --pr;
+            return std::max(pr,int64_t(1));
+        }
+
+        World& get_world() const {return p->get_world();}
+
+        /// Returns the column dimension of the matrix ... i.e., n for A(n,m)
+        int64_t coldim() const {return p->n;}
+
+        /// Returns the row dimension of the matrix ... i.e., m for A(n,m)
+        int64_t rowdim() const {return p->m;}
+
+        /// Returns the block size of the column dimension
+        int64_t colblock() const {return p->nb;}
+
+        /// Returns the block size of the row dimension
+        int64_t rowblock() const {return p->mb;}
+
+        /// Returns the number of blocks in the column dimension
+        int64_t nblock_col() const {return p->nblockn;}
+
+        /// Returns the number of blocks in the row dimension
+        int64_t nblock_row() const {return p->nblockm;}
+
+        /// Returns the number of process rows of the grid
+        int64_t process_rowdim() const {return p->Pr;}
+
+        /// Returns the number of process columns of the grid
+        int64_t process_coldim() const {return p->Pc;}
+
+        /// Returns the process owning block (bi,bj)
+        ProcessID block_owner(int64_t bi, int64_t bj) const {return p->owner(bi,bj);}
+
+        /// Returns the process owning element (i,j)
+        ProcessID owner(int64_t i, int64_t j) const {return p->owner(i/p->nb, j/p->mb);}
+
+        /// Returns true if block (bi,bj) is stored on this process
+        bool is_local(int64_t bi, int64_t bj) const {return p->is_local(bi,bj);}
+
+        /// Returns the total no. of elements stored on this process
+        int64_t local_size() const {
+            int64_t sz = 0;
+            for (auto& kv : p->blocks) sz += kv.second.size();
+            return sz;
+        }
+
+        /// Returns a (shallow) reference to local block (bi,bj) (throws if not local)
+        Tensor<T> block(int64_t bi, int64_t bj) const {return p->local_block(bi,bj);}
+
+        /// Returns a future to block (bi,bj) which may be remote
+        Future< Tensor<T> > fetch(int64_t bi, int64_t bj) const {return p->fetch(bi,bj);}
+
+        /// Returns a future to a copy of the patch [i0,i1]x[j0,j1] (indices local to the block) of block (bi,bj)
+        Future< Tensor<T> > get_patch(int64_t bi, int64_t bj, int64_t i0, int64_t i1, int64_t j0, int64_t j1) const {
+            if (is_local(bi,bj)) return Future< Tensor<T> >(p->get_patch(bi, bj, i0, i1, j0, j1));
+            return p->task(block_owner(bi,bj), &implT::get_patch, bi, bj, i0, i1, j0, j1);
+        }
+
+        /// Stores a patch into block (bi,bj) at offset (i0,j0) local to the block ... completion is only guaranteed after a fence
+        void send_patch(int64_t bi, int64_t bj, int64_t i0, int64_t j0, const Tensor<T>& patch) const {
+            if (is_local(bi,bj)) p->set_patch(bi, bj, i0, j0, patch);
+            else p->send(block_owner(bi,bj), &implT::set_patch, bi, bj, i0, j0, patch);
+        }
+
+        /// Returns the list of local block indices
+        std::vector<keyT> local_blocks() const {
+            std::vector<keyT> v;
+            v.reserve(p->blocks.size());
+            for (auto& kv : p->blocks) v.push_back(kv.first);
+            return v;
+        }
+
+        /// Fills the matrix with the provided function of the indices
+
+        /// @param[in] f The matrix is filled using \c a[i,j]=f(i,j)
+        template <typename funcT>
+        void fill(const funcT& f) {
+            for (auto& kv : p->blocks) {
+                const int64_t i0 = kv.first.first*p->nb, j0 = kv.first.second*p->mb;
+                Tensor<T>& t = kv.second;
+                for (int64_t i=0; i<t.dim(0); ++i)
+                    for (int64_t j=0; j<t.dim(1); ++j)
+                        t(i,j) = f(i0+i,j0+j);
+            }
+        }
+
+        /// Fills the matrix with a scalar
+        void fill(T value) {
+            for (auto& kv : p->blocks) kv.second.fill(value);
+        }
+
+        /// Copy from the replicated \c (n,m) matrix into the distributed matrix
+        void copy_from_replicated(const Tensor<T>& s) {
+            for (auto& kv : p->blocks) {
+                const int64_t i0 = kv.first.first*p->nb, j0 = kv.first.second*p->mb;
+                Tensor<T>& t = kv.second;
+                t(___) = s(Slice(i0,i0+t.dim(0)-1),Slice(j0,j0+t.dim(1)-1));
+            }
+        }
+
+        /// Copy from the distributed matrix into the replicated \c (n,m) matrix (collective call)
+        void copy_to_replicated(Tensor<T>& s) const {
+            MADNESS_CHECK(s.iscontiguous());
+            s = 0.0;
+            for (auto& kv : p->blocks) {
+                const int64_t i0 = kv.first.first*p->nb, j0 = kv.first.second*p->mb;
+                const Tensor<T>& t = kv.second;
+                s(Slice(i0,i0+t.dim(0)-1),Slice(j0,j0+t.dim(1)-1)) = t;
+            }
+            get_world().gop.sum(s.ptr(), s.size());
+        }
+
+        /// Returns true if both matrices have identical dimensions and distribution
+        template <typename R>
+        bool has_same_dimension_and_distribution(const BlockCyclicMatrix<R>& A) const {
+            return coldim()==A.coldim() && rowdim()==A.rowdim() && colblock()==A.colblock()
+                && rowblock()==A.rowblock() && process_rowdim()==A.process_rowdim();
+        }
+    };
+
+
+    /// Matrix multiplication \c C=A*B using the SUMMA algorithm (collective)
+
+    /// The column block size of \c A must equal the row block size of
+    /// \c B , and \c C must be blocked conformingly.  Each process pulls
+    /// the A row-panel and B column-panel blocks it needs exactly once (the
+    /// SUMMA broadcast, done by active messages) and chains the block
+    /// updates of each local C block as tasks on the arriving futures, so
+    /// computation on early panels overlaps the communication of later ones.
+    /// @param[in] A Left matrix (n,k)
+    /// @param[in] B Right matrix (k,m)
+    /// @param[in,out] C Result matrix (n,m), overwritten
+    template <typename T>
+    void gemm(const BlockCyclicMatrix<T>& A, const BlockCyclicMatrix<T>& B, BlockCyclicMatrix<T>& C) {
+        MADNESS_CHECK(A.rowdim()==B.coldim() && A.rowblock()==B.colblock());
+        MADNESS_CHECK(C.coldim()==A.coldim() && C.rowdim()==B.rowdim());
+        MADNESS_CHECK(C.colblock()==A.colblock() && C.rowblock()==B.rowblock());
+
+        World& world = C.get_world();
+        typedef std::pair<int64_t,int64_t> keyT;
+        std::map<keyT, Future< Tensor<T> > > apanel, bpanel;
+        const int64_t nk = A.nblock_row();
+
+        for (const keyT& key : C.local_blocks()) {
+            const int64_t bi = key.first, bj = key.second;
+            Tensor<T> c = C.block(bi,bj);
+            c.fill(T(0));
+            Future< Tensor<T> > acc(c);
+            for (int64_t kk=0; kk<nk; ++kk) {
+                // rotate the starting panel so processes do not all hit the same owner at once
+                const int64_t bk = (kk + bi + bj) % nk;
+                auto ait = apanel.find(keyT(bi,bk));
+                if (ait == apanel.end()) ait = apanel.insert(std::make_pair(keyT(bi,bk), A.fetch(bi,bk))).first;
+                auto bit = bpanel.find(keyT(bk,bj));
+                if (bit == bpanel.end()) bit = bpanel.insert(std::make_pair(keyT(bk,bj), B.fetch(bk,bj))).first;
+                acc = world.taskq.add(&detail::block_gemm_accumulate<T>, acc, ait->second, bit->second);
+            }
+        }
+        world.gop.fence();
+    }
+
+
+    /// Matrix multiplication returning a new matrix \c A*B (collective)
+    template <typename T>
+    BlockCyclicMatrix<T> gemm(const BlockCyclicMatrix<T>& A, const BlockCyclicMatrix<T>& B) {
+        BlockCyclicMatrix<T> C(A.get_world(), A.coldim(), B.rowdim(), A.colblock(), B.rowblock(), A.process_rowdim());
+        gemm(A, B, C);
+        return C;
+    }
+
+
+    /// Returns the transpose of \c A with the same process grid (collective)
+    template <typename T>
+    BlockCyclicMatrix<T> transpose(const BlockCyclicMatrix<T>& A) {
+        World& world = A.get_world();
+        BlockCyclicMatrix<T> At(world, A.rowdim(), A.coldim(), A.rowblock(), A.colblock(), A.process_rowdim());
+        for (const auto& key : At.local_blocks()) {
+            world.taskq.add(&detail::block_copy_transposed<T>, At.block(key.first,key.second),
+                            A.fetch(key.second,key.first));
+        }
+        world.gop.fence();
+        return At;
+    }
+
+
+    /// Redistributes a row/column (1D) distributed matrix into 2D block-cyclic layout (collective)
+
+    /// Each process pushes the pieces of its local data to the owners
+    /// of the overlapping blocks by active message.
+    /// @param[in] A The 1D distributed matrix
+    /// @param[in] nb Block size for the column dimension
+    /// @param[in] mb Block size for the row dimension
+    /// @param[in] Pr No. of process rows (default is the most square grid)
+    /// @return A new block-cyclic matrix with the content of \c A
+    template <typename T>
+    BlockCyclicMatrix<T> block_cyclic_matrix(const DistributedMatrix<T>& A, int64_t nb, int64_t mb, int64_t Pr=0) {
+        World& world = A.get_world();
+        BlockCyclicMatrix<T> B(world, A.coldim(), A.rowdim(), nb, mb, Pr);
+        redistribute(A, B);
+        return B;
+    }
+
+
+    /// Copies a 1D distributed matrix into an existing block-cyclic matrix of the same dimension (collective)
+    template <typename T>
+    void redistribute(const DistributedMatrix<T>& A, BlockCyclicMatrix<T>& B) {
+        MADNESS_CHECK(A.coldim()==B.coldim() && A.rowdim()==B.rowdim());
+        int64_t ilo, ihi, jlo, jhi;
+        A.local_colrange(ilo, ihi);
+        A.local_rowrange(jlo, jhi);
+        if (A.local_size() > 0) {
+            const int64_t nb = B.colblock(), mb = B.rowblock();
+            const Tensor<T>& t = A.data();
+            for (int64_t bi=ilo/nb; bi<=ihi/nb; ++bi) {
+                const int64_t i0 = std::max(ilo, bi*nb), i1 = std::min(ihi, (bi+1)*nb-1);
+                for (int64_t bj=jlo/mb; bj<=jhi/mb; ++bj) {
+                    const int64_t j0 = std::max(jlo, bj*mb), j1 = std::min(jhi, (bj+1)*mb-1);
+                    Tensor<T> patch = copy(t(Slice(i0-ilo,i1-ilo),Slice(j0-jlo,j1-jlo)));
+                    B.send_patch(bi, bj, i0-bi*nb, j0-bj*mb, patch);
+                }
+            }
+        }
+        B.get_world().gop.fence();
+    }
+
+
+    /// Copies a block-cyclic matrix into an existing 1D distributed matrix of the same dimension (collective)
+
+    /// Each process pulls the patches overlapping its local 1D range.
+    template <typename T>
+    void redistribute(const BlockCyclicMatrix<T>& B, DistributedMatrix<T>& A) {
+        MADNESS_CHECK(A.coldim()==B.coldim() && A.rowdim()==B.rowdim());
+        World& world = B.get_world();
+        int64_t ilo, ihi, jlo, jhi;
+        A.local_colrange(ilo, ihi);
+        A.local_rowrange(jlo, jhi);
+        if (A.local_size() > 0) {
+            const int64_t nb = B.colblock(), mb = B.rowblock();
+            Tensor<T> t = A.data();
+            for (int64_t bi=ilo/nb; bi<=ihi/nb; ++bi) {
+                const int64_t i0 = std::max(ilo, bi*nb), i1 = std::min(ihi, (bi+1)*nb-1);
+                for (int64_t bj=jlo/mb; bj<=jhi/mb; ++bj) {
+                    const int64_t j0 = std::max(jlo, bj*mb), j1 = std::min(jhi, (bj+1)*mb-1);
+                    world.taskq.add(&detail::block_copy_patch<T>, t, i0-ilo, j0-jlo,
+                                    B.get_patch(bi, bj, i0-bi*nb, i1-bi*nb, j0-bj*mb, j1-bj*mb));
+                }
+            }
+        }
+        world.gop.fence();
+    }
+
+}
+
+#endif
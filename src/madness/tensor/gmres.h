@@ -83,6 +83,38 @@ namespace madness {
 	         virtual ~Operator() {}
     };
 
+    /** \brief A generic operator acting on a block of vectors at once.
+
+        Solvers for several right-hand sides with the same operator call
+        this once per iteration with all the vectors that still need the
+        operator, so that implementations can use the vector apply path
+        (e.g. apply(world, op, vector) for MADNESS Functions) with a single
+        fence instead of one application per vector.
+    */
+    template <typename T>
+    class BlockOperator {
+        protected:
+            /** \brief The action of the operator on each vector of a block
+
+                \param[in] in The input vectors
+                \param[out] out The action of the operator on each input
+                                vector, resized to the size of \c in
+            */
+            virtual void action(const std::vector<T> &in, std::vector<T> &out)
+                const = 0;
+
+        public:
+            /** \brief Public access to the operator's action, returns out for
+                convenience. */
+            std::vector<T> & applyOp(const std::vector<T> &in,
+                std::vector<T> &out) const {
+                action(in, out);
+                return out;
+            }
+
+            virtual ~BlockOperator() {}
+    };
+
     /** \brief A generic vector space which provides common operations needed
                by linear algebra routines (norm, inner product, etc.)
 
@@ -515,6 +547,150 @@ namespace madness {
         maxiters = iter;
     }
 
+    /** \brief A GMRES solver for several linear systems with the same
+                operator, \f$ \mathbf{A} \vec{x}_j = \vec{b}_j \f$.
+
+        Each right-hand side keeps its own Krylov space and least-squares
+        problem, exactly as in GMRES above, but the operator is applied to
+        the newest basis vectors of all unconverged systems with a single
+        call of the BlockOperator per iteration.  Systems that meet either
+        threshold, or whose Krylov space becomes invariant, are deflated:
+        they drop out of the block and no longer cost operator applications.
+
+        \param[in] space The AbstractVectorSpace interface for the type
+        \param[in] op The BlockOperator \f$\mathbf{A}\f$
+        \param[in] b The right-hand-side vectors \f$\vec{b}_j\f$
+        \param[in,out] x Input: The initial guesses.  Output: The computed
+                         solutions.
+        \param[in,out] maxiters Input: Maximum number of iterations to perform.
+                         Output: Iterations performed by the slowest system.
+        \param[in,out] resid_thresh Input: Convergence threshold for the
+                         residual of each system.  Output: The largest
+                         residual after the final iteration.
+        \param[in,out] update_thresh Input: Convergence threshold for the
+                         update vector of each system.  Output: The largest
+                         value after the final iteration.
+        \param[in] outp True if output to stdout is desired, false otherwise.
+    */
+    template <typename T, typename real_type, typename scalar_type>
+    void BlockGMRES(const AbstractVectorSpace<T, real_type, scalar_type> &space,
+        const BlockOperator<T> &op, const std::vector<T> &b, std::vector<T> &x,
+        int &maxiters, real_type &resid_thresh, real_type &update_thresh,
+        const bool outp = false) {
+
+        const std::size_t nrhs = b.size();
+        MADNESS_ASSERT(x.size() == nrhs);
+        World &world = space.world;
+
+        std::vector<std::vector<T> > V(nrhs);
+        std::vector<Tensor<scalar_type> > H(nrhs), betae(nrhs), y(nrhs), yold(nrhs);
+        std::vector<real_type> resid(nrhs, 0.0), updatenorm(nrhs, 0.0);
+        std::vector<int> niter(nrhs, 0);
+        std::vector<std::size_t> active;
+        Tensor<real_type> s, sumsq;
+        long rank;
+
+        // construct the first subspace basis vector of every system
+        std::vector<T> r;
+        op.applyOp(x, r);
+        for(std::size_t j = 0; j < nrhs; ++j) {
+            space.gaxpy(r[j], -1.0, b[j], 1.0);
+            resid[j] = space.norm(r[j]);
+            if(outp && world.rank() == 0)
+                printf("rhs %.3zu itr rnk update_norm  resid\n"
+                    "    %.3d N/A N/A          %.6e\n", j, 0, resid[j]);
+            niter[j] = 1;
+            if(resid[j] < resid_thresh) {
+                space.destroy(r[j]);
+                continue;
+            }
+            H[j] = Tensor<scalar_type>(maxiters+1, maxiters);
+            betae[j] = Tensor<scalar_type>(maxiters+1);
+            betae[j][0] = resid[j];
+            space.scale(r[j], 1.0 / resid[j]);
+            V[j].push_back(r[j]);
+            active.push_back(j);
+        }
+
+        for(int iter = 1; iter <= maxiters && active.size() > 0; ++iter) {
+            // one application of the operator for all unconverged systems
+            std::vector<T> in, out;
+            for(std::size_t j : active) in.push_back(V[j][iter - 1]);
+            op.applyOp(in, out);
+
+            std::vector<std::size_t> still_active;
+            for(std::size_t a = 0; a < active.size(); ++a) {
+                const std::size_t j = active[a];
+                T &w = out[a];
+
+                // orthogonalize the new vector
+                for(int i = 0; i < iter; ++i) {
+                    H[j](i, iter-1) = space.inner(V[j][i], w);
+                    space.gaxpy(w, 1.0, V[j][i], -H[j](i, iter-1));
+                }
+                const real_type norm = space.norm(w);
+                H[j](iter, iter-1) = norm;
+
+                // solve Hy == betae for y
+                gelss(H[j](Slice(0, iter), Slice(0, iter-1)),
+                    betae[j](Slice(0, iter)), 1.0e-12, y[j], s, rank, sumsq);
+                resid[j] = sumsq[0];
+
+                // the update norm as in GMRES above
+                if(iter == 1)
+                    updatenorm[j] = y[j].normf();
+                else {
+                    real_type sum = 0.0;
+                    for(int i = 0; i < iter; ++i) {
+                        scalar_type temp = y[j][i] - (i < iter-1 ? yold[j][i] : scalar_type(0));
+                        sum += real(temp)*real(temp) + imag(temp)*imag(temp);
+                    }
+                    updatenorm[j] = sqrt(sum);
+                }
+                yold[j] = copy(y[j]);
+                niter[j] = iter;
+
+                const bool invariant = (norm < 1.0e-10);
+                if(outp && world.rank() == 0) {
+                    printf("rhs %.3zu %.3d %.3ld %.6e %.6e", j, iter, rank,
+                        updatenorm[j], resid[j]);
+                    if(invariant) printf(" ** Zero Vector Encountered **");
+                    else if(iter != rank) printf(" ** Questionable Progress **");
+                    printf("\n");
+                }
+
+                // deflate converged systems
+                if(invariant || resid[j] <= resid_thresh ||
+                    updatenorm[j] <= update_thresh) {
+                    space.destroy(w);
+                    continue;
+                }
+                space.scale(w, 1.0 / norm);
+                V[j].push_back(w);
+                still_active.push_back(j);
+            }
+            active.swap(still_active);
+        }
+
+        // build the solution vectors and destroy the basis vectors
+        real_type maxresid = 0.0, maxupdate = 0.0;
+        int maxiter = 0;
+        for(std::size_t j = 0; j < nrhs; ++j) {
+            for(std::size_t i = 0; i < V[j].size(); ++i) {
+                if(i < std::size_t(y[j].size()))
+                    space.gaxpy(x[j], 1.0, V[j][i], y[j][i]);
+                space.destroy(V[j][i]);
+            }
+            maxresid = std::max(maxresid, resid[j]);
+            maxupdate = std::max(maxupdate, updatenorm[j]);
+            maxiter = std::max(maxiter, niter[j]);
+        }
+
+        resid_thresh = maxresid;
+        update_thresh = maxupdate;
+        maxiters = maxiter;
+    }
+
 } // end of madness namespace
 
 #endif // MADNESS_LINALG_GMRES_H__INCLUDED
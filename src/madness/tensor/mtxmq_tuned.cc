@@ -0,0 +1,211 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+/// \file mtxmq_tuned.cc
+/// \brief Register-blocked mTxmq kernels and their selection by timing
+
+#include <madness/tensor/mtxmq_tuned.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+
+namespace madness {
+
+    namespace {
+
+        /// c(i,j) = sum(k) a(k,i)*b(k,j) for a single row i and columns j0..dimj-1
+        inline void mTxmq_row(long i, long j0, long dimi, long dimj, long dimk,
+                              double* MADNESS_RESTRICT c, const double* a, const double* b, long ldb) {
+            double* MADNESS_RESTRICT ci=c+i*dimj;
+            for (long j=j0; j<dimj; ++j) ci[j]=0.0;
+            for (long k=0; k<dimk; ++k) {
+                const double aki=a[k*dimi+i];
+                const double* bk=b+k*ldb;
+                for (long j=j0; j<dimj; ++j) ci[j]+=aki*bk[j];
+            }
+        }
+
+        /// Kernel computing blocks of IB rows and JB columns of c in registers
+        template <int IB, int JB>
+        void mTxmq_block(long dimi, long dimj, long dimk,
+                         double* MADNESS_RESTRICT c, const double* a, const double* b, long ldb) {
+            const long jfull=dimj-dimj%JB;
+            long i=0;
+            for (; i+IB<=dimi; i+=IB) {
+                for (long j=0; j<jfull; j+=JB) {
+                    double acc[IB][JB];
+                    for (int ii=0; ii<IB; ++ii)
+                        for (int jj=0; jj<JB; ++jj) acc[ii][jj]=0.0;
+                    const double* ak=a+i;
+                    const double* bk=b+j;
+                    for (long k=0; k<dimk; ++k, ak+=dimi, bk+=ldb) {
+                        for (int ii=0; ii<IB; ++ii) {
+                            const double aki=ak[ii];
+                            for (int jj=0; jj<JB; ++jj) acc[ii][jj]+=aki*bk[jj];
+                        }
+                    }
+                    for (int ii=0; ii<IB; ++ii)
+                        for (int jj=0; jj<JB; ++jj) c[(i+ii)*dimj+j+jj]=acc[ii][jj];
+                }
+                if (jfull<dimj) {
+                    for (int ii=0; ii<IB; ++ii) mTxmq_row(i+ii,jfull,dimi,dimj,dimk,c,a,b,ldb);
+                }
+            }
+            for (; i<dimi; ++i) mTxmq_row(i,0,dimi,dimj,dimk,c,a,b,ldb);
+        }
+
+        void mTxmq_default(long dimi, long dimj, long dimk,
+                           double* MADNESS_RESTRICT c, const double* a, const double* b, long ldb) {
+            mTxmq(dimi,dimj,dimk,c,a,b,ldb);
+        }
+
+        const mTxmq_kernelT candidates[] = {
+            mTxmq_default,
+            mTxmq_block<1,4>, mTxmq_block<1,8>, mTxmq_block<1,16>,
+            mTxmq_block<2,4>, mTxmq_block<2,8>, mTxmq_block<2,16>,
+            mTxmq_block<4,4>, mTxmq_block<4,8>,
+            mTxmq_block<8,4>
+        };
+
+        const int ncandidates=sizeof(candidates)/sizeof(candidates[0]);
+    }
+
+
+    int mTxmqTuner::ncandidate() {
+        return ncandidates;
+    }
+
+
+    mTxmq_kernelT mTxmqTuner::candidate(int i) {
+        MADNESS_ASSERT(i>=0 and i<ncandidates);
+        return candidates[i];
+    }
+
+
+    mTxmqTuner& mTxmqTuner::instance() {
+        static mTxmqTuner tuner;
+        return tuner;
+    }
+
+
+    mTxmqTuner::mTxmqTuner() {
+        for (auto& t : table) t.store(-1);
+
+        const char* env=getenv("MAD_MTXMQ_TUNE_FILE");
+        if (env) filename=env;
+        load();
+    }
+
+
+    void mTxmqTuner::load() {
+        if (filename.empty()) return;
+        std::ifstream in(filename.c_str());
+        long dimj, dimk;
+        int choice;
+        while (in >> dimj >> dimk >> choice) {
+            if (dimj<1 or dimj>maxdim or dimk<1 or dimk>maxdim) continue;
+            if (choice<0 or choice>=ncandidates) continue;
+            table[dimj*(maxdim+1)+dimk].store(choice);
+        }
+    }
+
+
+    void mTxmqTuner::save() const {
+        if (filename.empty()) return;
+        // readers never see a partially written file
+        const std::string tmp=filename+".tmp."+std::to_string(getpid());
+        {
+            std::ofstream out(tmp.c_str());
+            if (not out) return;
+            for (long dimj=1; dimj<=maxdim; ++dimj) {
+                for (long dimk=1; dimk<=maxdim; ++dimk) {
+                    const int choice=table[dimj*(maxdim+1)+dimk].load();
+                    if (choice>=0) out << dimj << " " << dimk << " " << choice << "\n";
+                }
+            }
+            if (not out) {
+                out.close();
+                std::remove(tmp.c_str());
+                return;
+            }
+        }
+        if (std::rename(tmp.c_str(),filename.c_str())!=0) std::remove(tmp.c_str());
+    }
+
+
+    void mTxmqTuner::tune(long k, bool write) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool changed=false;
+        for (long dimk : {k, 2*k}) {
+            if (dimk>maxdim) continue;
+            const long dimi=std::min(512L,dimk*dimk);   // representative for 3D
+            for (long r=1; r<=dimk; ++r) {
+                for (const auto& shape : {std::make_pair(r,dimk), std::make_pair(dimk,r)}) {
+                    if (table[shape.first*(maxdim+1)+shape.second].load()>=0) continue;
+                    tune_shape(dimi,shape.first,shape.second);
+                    changed=true;
+                }
+            }
+        }
+        if (changed and write) save();
+    }
+
+
+    void mTxmqTuner::tune_shape(long dimi, long dimj, long dimk) {
+        // time with a representative number of rows, the best of a few trials
+        std::vector<double> a(dimk*dimi), b(dimk*dimj), c(dimi*dimj);
+        for (std::size_t i=0; i<a.size(); ++i) a[i]=1.0/(1.0+i%13);
+        for (std::size_t i=0; i<b.size(); ++i) b[i]=1.0/(1.0+i%7);
+        const long nrep=std::max(1L,200000L/(dimi*dimj*dimk));
+
+        typedef std::chrono::steady_clock clockT;
+        int best=0;
+        double tbest=0.0;
+        for (int icand=0; icand<ncandidates; ++icand) {
+            double tmin=0.0;
+            for (int trial=0; trial<3; ++trial) {
+                const clockT::time_point start=clockT::now();
+                for (long rep=0; rep<nrep; ++rep) candidates[icand](dimi,dimj,dimk,&c[0],&a[0],&b[0],dimj);
+                const double t=std::chrono::duration<double>(clockT::now()-start).count();
+                if (trial==0 or t<tmin) tmin=t;
+            }
+            if (icand==0 or tmin<tbest) {
+                tbest=tmin;
+                best=icand;
+            }
+        }
+        table[dimj*(maxdim+1)+dimk].store(best);
+    }
+
+}
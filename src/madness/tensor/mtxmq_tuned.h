@@ -0,0 +1,133 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+#ifndef MADNESS_TENSOR_MTXMQ_TUNED_H__INCLUDED
+#define MADNESS_TENSOR_MTXMQ_TUNED_H__INCLUDED
+
+/// \file mtxmq_tuned.h
+/// \brief mTxmq with register-blocked kernels selected by timing for each matrix shape
+
+/// The transformations in the operator application are small matrix
+/// products c(i,j) = sum(k) a(k,i)*b(k,j) with dimj, dimk <= 2k and a long
+/// dimi.  Which kernel is fastest for such a shape depends on the machine,
+/// so mTxmqTuner::tune(k) times the plain mTxmq (BLAS or reference) against
+/// a set of register-blocked kernels for all shapes of an operator of order
+/// k and keeps the fastest.  SeparatedConvolution does this once in its
+/// constructor; mTxmq_tuned itself only looks up the choice and uses mTxmq
+/// for shapes that have not been tuned.
+///
+/// The choices can be kept across runs in a cache file, named by the
+/// environment variable \c MAD_MTXMQ_TUNE_FILE.  Without it there is no
+/// cache.  The file is read by every process and written by one only,
+/// through a temporary file that is renamed over it.
+
+#include <madness/tensor/mxm.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+namespace madness {
+
+    /// Signature of the double precision kernels, cf mTxmq
+    typedef void (*mTxmq_kernelT)(long dimi, long dimj, long dimk,
+                                  double* MADNESS_RESTRICT c, const double* a, const double* b, long ldb);
+
+    /// Selects the fastest mTxmq kernel for each shape (singleton)
+    class mTxmqTuner {
+    public:
+        /// Largest dimj and dimk that are tuned; larger shapes use mTxmq
+        static const long maxdim = 64;
+
+        static mTxmqTuner& instance();
+
+        /// The kernel to use for this shape, mTxmq if it has not been tuned
+        mTxmq_kernelT kernel(long dimj, long dimk) const {
+            if (dimj>maxdim or dimk>maxdim) return candidate(0);
+            const int choice=table[dimj*(maxdim+1)+dimk].load(std::memory_order_relaxed);
+            return candidate(std::max(choice,0));
+        }
+
+        /// Tunes all shapes of the transformations of an operator of order k
+
+        /// These are (r,dimk) and (dimk,r) with dimk=k or 2k and r<=dimk.
+        /// Shapes that are tuned already are skipped, so this is cheap after
+        /// the first call for a given k.
+        /// @param[in]  k       the wavelet order
+        /// @param[in]  write   write the cache file if shapes were added;
+        ///                     true on one process only
+        void tune(long k, bool write);
+
+        /// Number of candidate kernels, candidate 0 is the untuned mTxmq
+        static int ncandidate();
+
+        /// The candidate kernels, for testing
+        static mTxmq_kernelT candidate(int i);
+
+        /// Name of the cache file, empty if there is none
+        const std::string& cache_file() const {return filename;}
+
+    private:
+        mTxmqTuner();
+
+        /// Times all candidates for this shape and records the fastest
+        void tune_shape(long dimi, long dimj, long dimk);
+
+        void load();
+
+        void save() const;
+
+        std::atomic<int> table[(maxdim+1)*(maxdim+1)];  ///< chosen kernel, -1 if not tuned yet
+        std::mutex mutex;                               ///< serializes tuning
+        std::string filename;
+    };
+
+    /// Matrix = Matrix transpose * matrix ... tuned kernel for double
+
+    /// Same as mTxmq, does not accumulate into c.  ldb is the last dimension
+    /// of b in C storage.
+    inline void mTxmq_tuned(long dimi, long dimj, long dimk,
+                            double* MADNESS_RESTRICT c, const double* a, const double* b, long ldb=-1) {
+        if (ldb == -1) ldb=dimj;
+        if (dimi==0 || dimj==0) return;
+        mTxmqTuner::instance().kernel(dimj,dimk)(dimi,dimj,dimk,c,a,b,ldb);
+    }
+
+    /// Matrix = Matrix transpose * matrix ... other types use mTxmq
+    template <typename aT, typename bT, typename cT>
+    inline void mTxmq_tuned(long dimi, long dimj, long dimk,
+                            cT* MADNESS_RESTRICT c, const aT* a, const bT* b, long ldb=-1) {
+        mTxmq(dimi, dimj, dimk, c, a, b, ldb);
+    }
+
+}
+
+#endif // MADNESS_TENSOR_MTXMQ_TUNED_H__INCLUDED
@@ -0,0 +1,77 @@
+#define WORLD_INSTANTIATE_STATIC_TEMPLATES
+
+#include <madness/madness_config.h>
+#include <madness/world/MADworld.h>
+#include <madness/tensor/block_cyclic_matrix.h>
+
+using namespace madness;
+
+double ij(int64_t i, int64_t j) {return double(i) - 0.5*double(j);}
+
+double ji(int64_t i, int64_t j) {return 1.0/(1.0 + i + 2.0*j);}
+
+void check_fill(BlockCyclicMatrix<double>& A) {
+    A.fill(ij);
+    const ProcessID me = A.get_world().rank();
+    for (const auto& key : A.local_blocks()) {
+        MADNESS_CHECK(A.block_owner(key.first,key.second) == me);
+        const Tensor<double> t = A.block(key.first,key.second);
+        for (int64_t i=0; i<t.dim(0); ++i)
+            for (int64_t j=0; j<t.dim(1); ++j)
+                MADNESS_CHECK(t(i,j) == ij(key.first*A.colblock()+i, key.second*A.rowblock()+j));
+    }
+}
+
+void check_gemm(World& world, int64_t n, int64_t k, int64_t m, int64_t nb) {
+    BlockCyclicMatrix<double> A(world, n, k, nb, nb), B(world, k, m, nb, nb);
+    A.fill(ij);
+    B.fill(ji);
+
+    BlockCyclicMatrix<double> C = gemm(A, B);
+
+    Tensor<double> a(n,k), b(k,m), c(n,m);
+    A.copy_to_replicated(a);
+    B.copy_to_replicated(b);
+    C.copy_to_replicated(c);
+    double err = (c - inner(a,b)).normf();
+    if (world.rank() == 0) print("gemm", n, k, m, nb, "error", err);
+    MADNESS_CHECK(err < 1e-10*c.normf());
+
+    BlockCyclicMatrix<double> At = transpose(A);
+    Tensor<double> at(k,n);
+    At.copy_to_replicated(at);
+    MADNESS_CHECK((at - transpose(a)).normf() == 0.0);
+}
+
+void check_redistribute(World& world, int64_t n, int64_t m, int64_t nb) {
+    DistributedMatrix<double> A = column_distributed_matrix<double>(world, n, m);
+    A.fill(ij);
+
+    BlockCyclicMatrix<double> B = block_cyclic_matrix(A, nb, nb+1);
+    Tensor<double> b(n,m), ref(n,m);
+    B.copy_to_replicated(b);
+    A.copy_to_replicated(ref);
+    MADNESS_CHECK((b - ref).normf() == 0.0);
+
+    DistributedMatrix<double> R = row_distributed_matrix<double>(world, n, m);
+    redistribute(B, R);
+    R.copy_to_replicated(b);
+    MADNESS_CHECK((b - ref).normf() == 0.0);
+}
+
+int main(int argc, char** argv) {
+    initialize(argc, argv);
+    World world(SafeMPI::COMM_WORLD);
+
+    {
+        BlockCyclicMatrix<double> A(world, 103, 77, 8, 5);
+        check_fill(A);
+    }
+    check_gemm(world, 67, 45, 31, 7);
+    check_gemm(world, 64, 64, 64, 16);
+    check_redistribute(world, 53, 41, 6);
+
+    world.gop.fence();
+    finalize();
+    return 0;
+}
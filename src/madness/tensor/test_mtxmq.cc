@@ -53,6 +53,7 @@ bool smalltest = false;
 #include <madness/tensor/cblas.h>
 #include <madness/tensor/tensor.h>
 #include <madness/tensor/mxm.h>
+#include <madness/tensor/mtxmq_tuned.h>
 
 using namespace madness;
 
@@ -165,6 +166,30 @@ void trantimer(const char* s, long ni, long nj, long nk, double *a, double *b, d
   printf("%20s %3ld %3ld %3ld %8.2f %8.2f\n",s, ni,nj,nk, fastest, fastest_dgemm);
 }
 
+void tunedtimer(const char* s, long ni, long nj, long nk, double *a, double *b, double *c) {
+  double fastest=0.0, fastest_tuned=0.0;
+
+  double nflop = 2.0*ni*nj*nk;
+  long loop;
+  for (int t=0; t<100; t++) {
+    double start = SafeMPI::Wtime();
+    for (loop=0; loop<100; ++loop) mTxmq(ni,nj,nk,c,a,b);
+    start = SafeMPI::Wtime() - start;
+    double rate = 1.e-9*nflop/(start/100.0);
+    crap(rate,fastest,start);
+    if (rate > fastest) fastest = rate;
+  }
+  for (int t=0; t<100; t++) {
+    double start = SafeMPI::Wtime();
+    for (loop=0; loop<100; ++loop) mTxmq_tuned(ni,nj,nk,c,a,b);
+    start = SafeMPI::Wtime() - start;
+    double rate = 1.e-9*nflop/(start/100.0);
+    crap(rate,fastest_tuned,start);
+    if (rate > fastest_tuned) fastest_tuned = rate;
+  }
+  printf("%20s %3ld %3ld %3ld %8.2f %8.2f\n",s, ni,nj,nk, fastest, fastest_tuned);
+}
+
 int main(int argc, char * argv[]) {
 
     if (getenv("MAD_SMALL_TESTS")) smalltest=true;
@@ -225,12 +250,38 @@ int main(int argc, char * argv[]) {
     }
     printf("... OK!\n");
 
+    // the register-blocked kernels, including a b with leading dimension larger than nj
+    printf("Starting to test the tuned kernels ... \n");
+    mTxmqTuner::instance().tune(10,false);  // mTxmq_tuned then uses the chosen kernels
+    for (int icand=0; icand<mTxmqTuner::ncandidate(); ++icand) {
+        for (ni=1; ni<std::min(40L,nimax); ni+=3) {
+            for (nj=1; nj<std::min(40L,njmax); nj+=1) {
+                for (nk=1; nk<std::min(40L,nkmax); nk+=2) {
+                    const long ldb=nj+icand%3;
+                    for (i=0; i<ni*nj; ++i) d[i] = c[i] = 0.0;
+                    mTxmq_reference(ni,nj,nk,c,a,b,ldb);
+                    mTxmqTuner::candidate(icand)(ni,nj,nk,d,a,b,ldb);
+                    if (icand==0) mTxmq_tuned(ni,nj,nk,d,a,b,ldb);
+                    for (i=0; i<ni*nj; ++i) {
+                        double err = std::abs(d[i]-c[i]);
+                        if (err > 1e-13) {
+                            printf("test_mtxmq: kernel %d error %ld %ld %ld %e\n",icand,ni,nj,nk,err);
+                            exit(1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    printf("... OK!\n");
+
     if (!smalltest) {
         printf("%20s %3s %3s %3s %8s %8s (GF/s)\n", "type", "M", "N", "K", "LOOP", "BLAS");
         for (ni=2; ni<60; ni+=2) timer("(m*m)T*(m*m)", ni,ni,ni,a,b,c);
         for (m=2; m<=30; m+=2) timer("(m*m,m)T*(m*m)", m*m,m,m,a,b,c);
         for (m=2; m<=30; m+=2) trantimer("tran(m,m,m)", m*m,m,m,a,b,c);
         for (m=2; m<=20; m+=2) timer("(20*20,20)T*(20,m)", 20*20,m,20,a,b,c);
+        for (m=2; m<=30; m+=2) tunedtimer("tuned (m*m,m)T*(m*m)", m*m,m,m,a,b,c);
     }
 
     SafeMPI::Finalize();
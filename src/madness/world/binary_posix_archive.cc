@@ -0,0 +1,273 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+/**
+ \file binary_posix_archive.cc
+ \brief Implements a binary file archive with large-block POSIX I/O.
+ \ingroup serialization
+*/
+
+#include <madness/world/binary_posix_archive.h>
+#include <madness/world/madness_exception.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace madness {
+    namespace archive {
+
+        namespace {
+
+            const std::size_t ALIGNMENT = 4096; ///< Alignment of buffers, offsets and sizes for direct I/O
+
+            /// Allocates an I/O buffer aligned for direct I/O
+            std::shared_ptr<char> aligned_buffer(std::size_t size) {
+                void* p = nullptr;
+                if (posix_memalign(&p, ALIGNMENT, size))
+                    MADNESS_EXCEPTION("BinaryPosixArchive: failed to allocate the I/O buffer", size);
+                return std::shared_ptr<char>(static_cast<char*>(p), std::free);
+            }
+
+            /// True if direct I/O is requested in the environment
+            bool direct_io_requested() {
+                const char* env = getenv("MAD_ARCHIVE_DIRECT_IO");
+                return env && std::atoi(env) == 1;
+            }
+
+            /// Opens a file, with O_DIRECT if requested and supported by the file system
+            int open_file(const char* filename, int flags, bool& direct) {
+                int fd = -1;
+#ifdef O_DIRECT
+                if (direct) {
+                    fd = ::open(filename, flags | O_DIRECT, 0644);
+                    if (fd >= 0) return fd;
+                }
+#endif
+                direct = false;
+                return ::open(filename, flags, 0644);
+            }
+
+            /// Switches an open file from direct to buffered I/O
+            void clear_direct(int fd) {
+#ifdef O_DIRECT
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+#endif
+            }
+
+            /// Writes all of the data described by iov at offset, returns the new offset
+            off_t pwritev_all(int fd, struct iovec* iov, int iovcnt, off_t offset) {
+                while (iovcnt > 0) {
+                    ssize_t n = pwritev(fd, iov, iovcnt, offset);
+                    if (n < 0) {
+                        if (errno == EINTR) continue;
+                        MADNESS_EXCEPTION("BinaryPosixOutputArchive: write failed", errno);
+                    }
+                    offset += n;
+                    while (iovcnt > 0 && std::size_t(n) >= iov->iov_len) {
+                        n -= iov->iov_len;
+                        ++iov;
+                        --iovcnt;
+                    }
+                    if (iovcnt > 0) {
+                        iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+                        iov->iov_len -= n;
+                    }
+                }
+                return offset;
+            }
+        }
+
+
+        BinaryPosixOutputArchive::BinaryPosixOutputArchive(const char* filename, std::ios_base::openmode mode)
+                : iobuf(), fd(-1), direct(false), offset(0), nbuf(0)
+        {
+            if (filename) open(filename, mode);
+        }
+
+        BinaryPosixOutputArchive::~BinaryPosixOutputArchive() {
+            close();
+        }
+
+        void BinaryPosixOutputArchive::open(const char* filename, std::ios_base::openmode mode) {
+            close();
+            iobuf = aligned_buffer(IOBUFSIZE);
+            nbuf = 0;
+            int flags = O_WRONLY | O_CREAT;
+            if (not (mode & std::ios_base::app)) flags |= O_TRUNC;
+            direct = direct_io_requested();
+            fd = open_file(filename, flags, direct);
+            if (fd < 0) MADNESS_EXCEPTION("BinaryPosixOutputArchive: open: failed", errno);
+            offset = 0;
+            if (mode & std::ios_base::app) {
+                offset = lseek(fd, 0, SEEK_END);
+                // direct I/O needs aligned file offsets
+                if (direct && offset%ALIGNMENT) {
+                    clear_direct(fd);
+                    direct = false;
+                }
+            }
+
+            store(ARCHIVE_COOKIE, strlen(ARCHIVE_COOKIE)+1);
+        }
+
+        void BinaryPosixOutputArchive::write_buffer(bool all) const {
+            std::size_t nwrite = nbuf;
+            if (direct) {
+                nwrite -= nbuf%ALIGNMENT;
+                if (all && nwrite < nbuf) {
+                    // the tail cannot be written with direct I/O
+                    if (nwrite) write_buffer(false);
+                    clear_direct(fd);
+                    direct = false;
+                    write_buffer(true);
+                    return;
+                }
+            }
+            if (nwrite == 0) return;
+            struct iovec iov = {iobuf.get(), nwrite};
+            offset = pwritev_all(fd, &iov, 1, offset);
+            nbuf -= nwrite;
+            if (nbuf) std::memmove(iobuf.get(), iobuf.get()+nwrite, nbuf);
+        }
+
+        void BinaryPosixOutputArchive::store_large(const char* data, std::size_t nbyte) const {
+            if (direct) {
+                // stage everything through the aligned buffer
+                while (nbyte) {
+                    std::size_t n = std::min(nbyte, IOBUFSIZE-nbuf);
+                    std::memcpy(iobuf.get()+nbuf, data, n);
+                    nbuf += n;
+                    data += n;
+                    nbyte -= n;
+                    if (nbuf == IOBUFSIZE) write_buffer(false);
+                }
+                return;
+            }
+            // the buffered data and the new data in one call, the latter
+            // straight from its memory
+            struct iovec iov[2] = {{iobuf.get(), nbuf}, {const_cast<char*>(data), nbyte}};
+            offset = pwritev_all(fd, iov, 2, offset);
+            nbuf = 0;
+        }
+
+        void BinaryPosixOutputArchive::close() {
+            if (fd >= 0) {
+                write_buffer(true);
+                ::close(fd);
+                fd = -1;
+                iobuf.reset();
+            }
+        }
+
+        void BinaryPosixOutputArchive::flush() {
+            if (fd >= 0) write_buffer(false);
+        }
+
+
+        BinaryPosixInputArchive::BinaryPosixInputArchive(const char* filename, std::ios_base::openmode mode)
+                : iobuf(), fd(-1), direct(false), offset(0), ibuf(0), nbuf(0)
+        {
+            if (filename) open(filename, mode);
+        }
+
+        BinaryPosixInputArchive::~BinaryPosixInputArchive() {
+            close();
+        }
+
+        void BinaryPosixInputArchive::open(const char* filename, std::ios_base::openmode mode) {
+            close();
+            iobuf = aligned_buffer(IOBUFSIZE);
+            ibuf = nbuf = 0;
+            offset = 0;
+            direct = direct_io_requested();
+            fd = open_file(filename, O_RDONLY, direct);
+            if (fd < 0) MADNESS_EXCEPTION("BinaryPosixInputArchive: open: failed", errno);
+            char cookie[255];
+            int n = strlen(ARCHIVE_COOKIE)+1;
+            load(cookie, n);
+            if (strncmp(cookie,ARCHIVE_COOKIE,n) != 0)
+                MADNESS_EXCEPTION("BinaryPosixInputArchive: open: not an archive?", 1);
+        }
+
+        void BinaryPosixInputArchive::load_large(char* data, std::size_t nbyte) const {
+            // first what is left in the buffer
+            std::size_t n = nbuf-ibuf;
+            std::memcpy(data, iobuf.get()+ibuf, n);
+            data += n;
+            nbyte -= n;
+            ibuf = nbuf = 0;
+
+            while (nbyte) {
+                ssize_t nread;
+                if (direct) {
+                    // whole buffers at aligned offsets only
+                    nread = pread(fd, iobuf.get(), IOBUFSIZE, offset);
+                }
+                else {
+                    // straight into the destination, refilling the buffer in the same call
+                    struct iovec iov[2] = {{data, nbyte}, {iobuf.get(), IOBUFSIZE}};
+                    nread = preadv(fd, iov, 2, offset);
+                }
+                if (nread < 0) {
+                    if (errno == EINTR) continue;
+                    MADNESS_EXCEPTION("BinaryPosixInputArchive: read failed", errno);
+                }
+                if (nread == 0) MADNESS_EXCEPTION("BinaryPosixInputArchive: read past the end of the file", nbyte);
+                offset += nread;
+
+                if (direct) {
+                    nbuf = nread;
+                    n = std::min(nbyte, nbuf);
+                    std::memcpy(data, iobuf.get(), n);
+                    ibuf = n;
+                }
+                else {
+                    n = std::min(nbyte, std::size_t(nread));
+                    nbuf = nread-n;
+                }
+                data += n;
+                nbyte -= n;
+            }
+        }
+
+        void BinaryPosixInputArchive::close() {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+                iobuf.reset();
+            }
+        }
+
+    } // namespace archive
+} // namespace madness
@@ -0,0 +1,205 @@
+/*
+  This file is part of MADNESS.
+
+  Copyright (C) 2007,2010 Oak Ridge National Laboratory
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+
+  For more information please contact:
+
+  Robert J. Harrison
+  Oak Ridge National Laboratory
+  One Bethel Valley Road
+  P.O. Box 2008, MS-6367
+
+  email: harrisonrj@ornl.gov
+  tel:   865-241-3937
+  fax:   865-572-0680
+*/
+
+#ifndef MADNESS_WORLD_BINARY_POSIX_ARCHIVE_H__INCLUDED
+#define MADNESS_WORLD_BINARY_POSIX_ARCHIVE_H__INCLUDED
+
+/**
+ \file binary_posix_archive.h
+ \brief Implements a binary file archive with large-block POSIX I/O.
+ \ingroup serialization
+
+ The file format is identical to that of \c BinaryFstreamOutputArchive,
+ so files written by one can be read by the other.  Small items are
+ collected in a large aligned buffer; items that do not fit in the
+ buffer are written with \c pwritev straight from their memory, and read
+ with \c preadv straight into it, which avoids copying large tensors.
+
+ With the environment variable \c MAD_ARCHIVE_DIRECT_IO set to 1 the
+ files are opened with \c O_DIRECT where the file system supports it,
+ bypassing the page cache.  All I/O then goes through the aligned buffer.
+*/
+
+#include <type_traits>
+#include <cstring>
+#include <ios>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <madness/world/archive.h>
+
+namespace madness {
+    namespace archive {
+
+        /// \addtogroup serialization
+        /// @{
+
+        /// Wraps an archive around a binary file for output, using large-block POSIX I/O.
+        class BinaryPosixOutputArchive : public BaseOutputArchive {
+            static const std::size_t IOBUFSIZE = 8*1024*1024; ///< Buffer size.
+            std::shared_ptr<char> iobuf; ///< Buffer, aligned for direct I/O.
+            int fd; ///< The file descriptor, -1 if closed.
+            mutable bool direct; ///< True if the file is written with O_DIRECT.
+            mutable off_t offset; ///< File position of the start of the buffer.
+            mutable std::size_t nbuf; ///< Number of bytes in the buffer.
+
+            /// Writes data that do not fit in the buffer, together with the buffer.
+            void store_large(const char* data, std::size_t nbyte) const;
+
+            /// Writes the buffer to the file.
+
+            /// \param[in] all If false and the file is opened for direct
+            ///     I/O, only the aligned part of the buffer is written.
+            void write_buffer(bool all) const;
+
+        public:
+            /// Default constructor.
+
+            /// The filename and open modes are optional here; they can be
+            /// specified later by calling \c open().
+            /// \param[in] filename Name of the file to write to.
+            /// \param[in] mode I/O attributes for opening the file; the file is truncated unless \c app is given.
+            BinaryPosixOutputArchive(const char* filename = nullptr,
+                                     std::ios_base::openmode mode = std::ios_base::binary | \
+                                                                    std::ios_base::out | std::ios_base::trunc);
+
+            BinaryPosixOutputArchive(const std::string name,
+                                     std::ios_base::openmode mode = std::ios_base::binary | \
+                                                                    std::ios_base::out | std::ios_base::trunc)
+                    : BinaryPosixOutputArchive(name.c_str(),mode) {}
+
+            BinaryPosixOutputArchive(const BinaryPosixOutputArchive&) = delete;
+            BinaryPosixOutputArchive& operator=(const BinaryPosixOutputArchive&) = delete;
+
+            ~BinaryPosixOutputArchive();
+
+            /// Write to the file.
+
+            /// The function only appears (due to \c enable_if) if \c T is
+            /// serializable.
+            /// \tparam T The type of data to be written.
+            /// \param[in] t Location of the data to be written.
+            /// \param[in] n The number of data items to be written.
+            template <class T>
+            inline
+            typename std::enable_if< is_trivially_serializable<T>::value, void >::type
+            store(const T* t, long n) const {
+                const std::size_t nbyte = n*sizeof(T);
+                if (nbuf+nbyte <= IOBUFSIZE) {
+                    std::memcpy(iobuf.get()+nbuf, t, nbyte);
+                    nbuf += nbyte;
+                }
+                else {
+                    store_large((const char*) t, nbyte);
+                }
+            }
+
+            /// Open the file.
+
+            /// \param[in] filename The name of the file.
+            /// \param[in] mode I/O attributes for opening the file.
+            void open(const char* filename,
+                      std::ios_base::openmode mode = std::ios_base::binary | \
+                                                     std::ios_base::out | std::ios_base::trunc);
+
+            /// Close the file.
+            void close();
+
+            /// Write the buffered data to the file.
+            void flush();
+        };
+
+        /// Wraps an archive around a binary file for input, using large-block POSIX I/O.
+        class BinaryPosixInputArchive : public BaseInputArchive {
+            static const std::size_t IOBUFSIZE = 8*1024*1024; ///< Buffer size.
+            std::shared_ptr<char> iobuf; ///< Buffer, aligned for direct I/O.
+            int fd; ///< The file descriptor, -1 if closed.
+            bool direct; ///< True if the file was opened with O_DIRECT.
+            mutable off_t offset; ///< File position of the end of the buffered data.
+            mutable std::size_t ibuf; ///< Position of the next byte in the buffer.
+            mutable std::size_t nbuf; ///< Number of bytes in the buffer.
+
+            /// Reads data that are not (completely) in the buffer, refilling the buffer.
+            void load_large(char* data, std::size_t nbyte) const;
+
+        public:
+            /// Default constructor.
+
+            /// The filename and open modes are optional here; they can be
+            /// specified later by calling \c open().
+            /// \param[in] filename Name of the file to read from.
+            /// \param[in] mode I/O attributes for opening the file (ignored).
+            BinaryPosixInputArchive(const char* filename = nullptr, std::ios_base::openmode mode = std::ios_base::binary | std::ios_base::in);
+
+            BinaryPosixInputArchive(const std::string name,
+                                    std::ios_base::openmode mode = std::ios_base::binary | std::ios_base::in)
+                    : BinaryPosixInputArchive(name.c_str(),mode) {}
+
+            BinaryPosixInputArchive(const BinaryPosixInputArchive&) = delete;
+            BinaryPosixInputArchive& operator=(const BinaryPosixInputArchive&) = delete;
+
+            ~BinaryPosixInputArchive();
+
+            /// Load from the file.
+
+            /// The function only appears (due to \c enable_if) if \c T is
+            /// serializable.
+            /// \tparam T The type of data to be read.
+            /// \param[out] t Where to put the loaded data.
+            /// \param[in] n The number of data items to be loaded.
+            template <class T>
+            inline
+            typename std::enable_if< is_trivially_serializable<T>::value, void >::type
+            load(T* t, long n) const {
+                const std::size_t nbyte = n*sizeof(T);
+                if (ibuf+nbyte <= nbuf) {
+                    std::memcpy((char*) t, iobuf.get()+ibuf, nbyte);
+                    ibuf += nbyte;
+                }
+                else {
+                    load_large((char*) t, nbyte);
+                }
+            }
+
+            /// Open the file.
+
+            /// \param[in] filename Name of the file to read from.
+            /// \param[in] mode I/O attributes for opening the file (ignored).
+            void open(const char* filename, std::ios_base::openmode mode = std::ios_base::binary | std::ios_base::in);
+
+            /// Close the file.
+            void close();
+        };
+
+        /// @}
+    }
+}
+#endif // MADNESS_WORLD_BINARY_POSIX_ARCHIVE_H__INCLUDED
@@ -41,6 +41,7 @@
 #include <type_traits>
 #include <madness/world/archive.h>
 #include <madness/world/binary_fstream_archive.h>
+#include <madness/world/binary_posix_archive.h>
 #include <madness/world/world.h>
 #include <madness/world/worldgop.h>
 
@@ -58,9 +59,17 @@ namespace madness {
         class ParallelSerializableObject {};
 
 
+        /// True for the local archives that write one binary file per I/O node.
+
+        /// The fstream and POSIX archives share a file format and are interchangeable.
+        template <typename X>
+        inline constexpr bool is_binary_file_archive_v =
+                std::is_same<X,BinaryFstreamInputArchive>::value || std::is_same<X,BinaryFstreamOutputArchive>::value
+                || std::is_same<X,BinaryPosixInputArchive>::value || std::is_same<X,BinaryPosixOutputArchive>::value;
+
         /// Base class for input and output parallel archives.
 
-        /// \tparam Archive The local archive. Only tested for \c BinaryFstreamInputArchive and \c BinaryFstreamOutputArchive.
+        /// \tparam Archive The local archive. Only tested for the binary fstream and POSIX archives.
         /// \todo Should this class derive from \c BaseArchive?
         template <typename Archive>
         class BaseParallelArchive {
@@ -86,7 +95,7 @@ namespace madness {
 
             /// Default constructor.
             template <typename X=Archive>
-            BaseParallelArchive(typename std::enable_if_t<std::is_same<X,BinaryFstreamInputArchive>::value || std::is_same<X,BinaryFstreamOutputArchive>::value,int> nio=0)
+            BaseParallelArchive(typename std::enable_if_t<is_binary_file_archive_v<X>,int> nio=0)
                 : world(nullptr), ar(), nio(nio), do_fence(true) {
             }
 
@@ -151,7 +160,7 @@ namespace madness {
             /// \param[in] nwriter The number of writers.
 
             template <typename X=Archive>
-            typename std::enable_if_t<std::is_same<X,BinaryFstreamInputArchive>::value || std::is_same<X,BinaryFstreamOutputArchive>::value,
+            typename std::enable_if_t<is_binary_file_archive_v<X>,
                                       void>
             open(World& world, const char* filename, int nwriter=1) {
                 this->world = &world;
@@ -212,7 +221,7 @@ namespace madness {
             /// \return True if the named, unopened archive exists and is readable.
             template <typename X=Archive>
             static
-            typename std::enable_if_t<std::is_same<X,BinaryFstreamInputArchive>::value || std::is_same<X,BinaryFstreamOutputArchive>::value,
+            typename std::enable_if_t<is_binary_file_archive_v<X>,
                                       bool>
             exists(World& world, const char* filename) {
                 char buf[256];
@@ -261,7 +270,7 @@ namespace madness {
             /// \param[in] filename Base name of the file.
             template <typename X=Archive>
             static
-            typename std::enable_if_t<std::is_same<X,BinaryFstreamInputArchive>::value || std::is_same<X,BinaryFstreamOutputArchive>::value,
+            typename std::enable_if_t<is_binary_file_archive_v<X>,
                                       void>
             remove(World& world, const char* filename) {
                 if (world.rank() == 0) {
@@ -53,6 +53,10 @@ using madness::archive::TextFstreamOutputArchive;
 using madness::archive::BinaryFstreamInputArchive;
 using madness::archive::BinaryFstreamOutputArchive;
 
+#include <madness/world/binary_posix_archive.h>
+using madness::archive::BinaryPosixInputArchive;
+using madness::archive::BinaryPosixOutputArchive;
+
 #include <madness/world/vector_archive.h>
 using madness::archive::VectorInputArchive;
 using madness::archive::VectorOutputArchive;
@@ -870,6 +874,61 @@ int main(int argc, char* argv[]) {
     world.gop.barrier();
   }
 
+  // the POSIX archive, also across archive types since the format is shared;
+  // the large vector does not fit in the I/O buffer
+  {
+    const char *f = "test.dat";
+    std::vector<double> big(3*1024*1024+7);
+    for (std::size_t i=0; i<big.size(); ++i) big[i] = 0.5*i;
+
+    if (is_write_proc) {
+      cout << endl << "testing binary posix archive" << endl;
+      BinaryPosixOutputArchive oar(f);
+      test_out(oar);
+      oar & big & 42;
+      oar.close();
+    }
+    world.gop.barrier();
+
+    if (is_read_proc) {
+      std::vector<double> big2;
+      int tail = 0;
+      BinaryPosixInputArchive iar(f);
+      test_in(iar);
+      iar & big2 & tail;
+      iar.close();
+      MADNESS_CHECK(big2 == big && tail == 42);
+
+      cout << endl << "testing binary posix archive read by fstream archive" << endl;
+      BinaryFstreamInputArchive iar2(f);
+      test_in(iar2);
+      iar2 & big2 & tail;
+      iar2.close();
+      MADNESS_CHECK(big2 == big && tail == 42);
+    }
+    world.gop.barrier();
+
+    if (is_write_proc) {
+      BinaryFstreamOutputArchive oar(f);
+      test_out(oar);
+      oar & big & 42;
+      oar.close();
+    }
+    world.gop.barrier();
+
+    if (is_read_proc) {
+      cout << endl << "testing binary fstream archive read by posix archive" << endl;
+      std::vector<double> big2;
+      int tail = 0;
+      BinaryPosixInputArchive iar(f);
+      test_in(iar);
+      iar & big2 & tail;
+      iar.close();
+      MADNESS_CHECK(big2 == big && tail == 42);
+    }
+    world.gop.barrier();
+  }
+
   if (me == 0) {
     cout << endl << "testing vector archive" << endl;
     std::vector<unsigned char> f;
@@ -32,6 +32,7 @@
 #include <vector>
 #include <numeric>
 #include <algorithm>
+#include <atomic>
 
 #define WORLD_INSTANTIATE_STATIC_TEMPLATES
 #include <madness/world/MADworld.h>
@@ -1179,6 +1180,126 @@ void test15(World& world) {
   world.gop.fence();
 }
 
+/// Counts messages; incoming messages are held back until activate() is called
+class Counter : public WorldObject<Counter> {
+    AtomicInt n;
+public:
+    Counter(World& world) : WorldObject<Counter>(world) {
+        n=0;
+    }
+
+    void activate() {
+        process_pending();
+    }
+
+    void inc(int i) {
+        n++;
+    }
+
+    int count() const {
+        return n;
+    }
+};
+
+void activate_counter(Counter* c) {
+    c->activate();
+}
+
+void test16(World& world) {
+    PROFILE_FUNC;
+    // Many objects receive messages before they are constructed (rank
+    // skew) or before they process their pending messages, which then
+    // happens concurrently and in reverse order of construction.
+    const int nobj=2000, nmsg=3;
+    const ProcessID nproc=world.size();
+    const std::size_t npending0=detail::PendingMsgQueues::instance().size();
+
+    if (world.rank()%2) myusleep(50000);
+    std::vector<std::unique_ptr<Counter> > obj(nobj);
+    for (int i=0; i<nobj; ++i) {
+        obj[i].reset(new Counter(world));
+        for (ProcessID p=0; p<nproc; ++p)
+            for (int m=0; m<nmsg; ++m) obj[i]->send(p, &Counter::inc, m);
+    }
+    world.gop.fence();
+
+    // messages to self run directly, only the remote ones are held back
+    const std::size_t npending=detail::PendingMsgQueues::instance().size()-npending0;
+    MADNESS_CHECK(npending==std::size_t(nobj*nmsg*(nproc-1)));
+
+    for (int i=nobj-1; i>=0; --i) world.taskq.add(activate_counter, obj[i].get());
+    world.gop.fence();
+    MADNESS_CHECK(detail::PendingMsgQueues::instance().size()==npending0);
+    for (int i=0; i<nobj; ++i) MADNESS_CHECK(obj[i]->count()==nmsg*nproc);
+
+    // once active, messages are processed directly
+    for (int i=0; i<nobj; i+=7) obj[i]->send((world.rank()+1)%nproc, &Counter::inc, 0);
+    world.gop.fence();
+    MADNESS_CHECK(detail::PendingMsgQueues::instance().size()==npending0);
+    for (int i=0; i<nobj; i+=7) MADNESS_CHECK(obj[i]->count()==nmsg*nproc+1);
+
+    print("Test16 OK");
+    world.gop.fence();
+}
+
+/// Leaf task that records the largest number of pending tasks it sees
+void count_leaf(World* world, AtomicInt* nleaf, std::atomic<std::size_t>* peak) {
+    const std::size_t n=world->taskq.size();
+    std::size_t p=*peak;
+    while (n>p && !peak->compare_exchange_weak(p,n));
+    (*nleaf)++;
+}
+
+/// Binary tree of tasks, each spawning its children before it returns
+void spawn_tree(World* world, int depth, AtomicInt* nleaf, std::atomic<std::size_t>* peak) {
+    if (depth==0) {
+        count_leaf(world, nleaf, peak);
+        return;
+    }
+    for (int i=0; i<2; ++i) world->taskq.add(spawn_tree, world, depth-1, nleaf, peak);
+}
+
+void test17(World& world) {
+    PROFILE_FUNC;
+    // with a bound, the main thread runs the tasks it adds inline
+    // instead of queuing all of them
+    const std::size_t max_pending0=WorldTaskQueue::get_max_pending();
+    const std::size_t bound=64;
+    const int depth=15;
+    const TaskQStats stats0=world.taskq.get_stats();
+    WorldTaskQueue::set_max_pending(bound);
+
+    AtomicInt nleaf;
+    nleaf=0;
+    std::atomic<std::size_t> peak{0};
+    for (int i=0; i<(1<<depth); ++i) world.taskq.add(count_leaf, &world, &nleaf, &peak);
+    world.taskq.fence();
+
+    const TaskQStats stats1=world.taskq.get_stats();
+    MADNESS_CHECK(nleaf==(1<<depth));
+#if !(defined(HAVE_INTEL_TBB) || defined(HAVE_PARSEC))
+    MADNESS_CHECK(stats1.nthrottle>stats0.nthrottle);
+    MADNESS_CHECK(stats1.ninline>stats0.ninline);
+    MADNESS_CHECK(peak<4*bound);
+#endif
+    const std::size_t peak1=peak;
+
+    // tasks adding tasks are never throttled, they might wait for
+    // one another
+    nleaf=0;
+    world.taskq.add(spawn_tree, &world, depth, &nleaf, &peak);
+    world.taskq.fence();
+    WorldTaskQueue::set_max_pending(max_pending0);
+
+    const TaskQStats stats=world.taskq.get_stats();
+    MADNESS_CHECK(nleaf==(1<<depth));
+    MADNESS_CHECK(stats.nthrottle==stats1.nthrottle);
+
+    print("Test17 OK, peak #pending tasks", peak1,
+          "#throttled adds", stats1.nthrottle-stats0.nthrottle);
+    world.gop.fence();
+}
+
 inline bool is_odd(int i) {
     return i & 0x1;
 }
@@ -1352,6 +1473,8 @@ int main(int argc, char** argv) {
         test13(world);
         test14(world);
         test15(world);
+        test16(world);
+        test17(world);
 
         for (int i=0; i<10; ++i) {
           print("REPETITION",i);
@@ -75,6 +75,7 @@ namespace madness {
 
     ThreadPool* ThreadPool::instance_ptr = 0;
     double ThreadPool::await_timeout = 900.0;
+    thread_local int ThreadPool::task_depth = 0;
 #if HAVE_INTEL_TBB
     std::unique_ptr<tbb::global_control> ThreadPool::tbb_control = nullptr;
 #endif
@@ -1158,6 +1158,7 @@ namespace madness {
         static ThreadPool* instance_ptr; ///< Singleton pointer.
         static const int nmax = 128; ///< Number of task a worker thread will pop from the task queue
         static double await_timeout; ///< Waiter timeout.
+        static thread_local int task_depth; ///< Number of pool tasks the calling thread is running.
 
 #if defined(HAVE_IBMBGQ) and defined(HPM)
         static unsigned int main_hpmctx; ///< HPM context for main thread.
@@ -1173,6 +1174,12 @@ namespace madness {
         /// \return The number of threads.
         int default_nthread();
 
+        /// Counts the pool tasks run by this thread for the lifetime of the object.
+        struct TaskDepthGuard {
+            TaskDepthGuard() {++task_depth;}
+            ~TaskDepthGuard() {--task_depth;}
+        };
+
        /// Run the next task.
 
         /// \todo Verify and complete this documentation.
@@ -1195,6 +1202,7 @@ namespace madness {
 #ifdef MADNESS_TASK_PROFILING
                 t.first->set_event(event_list->event());
 #endif // MADNESS_TASK_PROFILING
+                TaskDepthGuard guard;
                 if (t.first->run_multi_threaded())         // What we are here to do
                     delete t.first;
             }
@@ -1234,6 +1242,7 @@ namespace madness {
 #ifdef MADNESS_TASK_PROFILING
                     taskbuf[i]->set_event(event_list->event());
 #endif // MADNESS_TASK_PROFILING
+                    TaskDepthGuard guard;
                     if (taskbuf[i]->run_multi_threaded()) {
                         delete taskbuf[i];
                     }
@@ -1394,6 +1403,16 @@ namespace madness {
 #endif // HAVE_INTEL_TBB
         }
 
+        /// Returns the number of pool tasks the calling thread is running.
+
+        /// This is 0 for the main thread and for a worker between tasks, and
+        /// larger while a task runs further tasks, e.g. when it waits for a
+        /// future.
+        /// \return The task nesting depth of the calling thread.
+        static int get_task_depth() {
+            return task_depth;
+        }
+
         /// Returns the number of threads in the pool.
 
         /// \return The number of threads in the pool.
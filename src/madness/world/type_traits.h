@@ -467,6 +467,8 @@ namespace madness {
     class BaseOutputArchive;
     class BinaryFstreamOutputArchive;
     class BinaryFstreamInputArchive;
+    class BinaryPosixOutputArchive;
+    class BinaryPosixInputArchive;
     class BufferOutputArchive;
     class BufferInputArchive;
     class VectorOutputArchive;
@@ -541,6 +543,10 @@ namespace madness {
     template <typename T>
     struct is_default_serializable_helper<archive::BinaryFstreamInputArchive, T, std::enable_if_t<is_trivially_serializable<T>::value>> : std::true_type {};
     template <typename T>
+    struct is_default_serializable_helper<archive::BinaryPosixOutputArchive, T, std::enable_if_t<is_trivially_serializable<T>::value>> : std::true_type {};
+    template <typename T>
+    struct is_default_serializable_helper<archive::BinaryPosixInputArchive, T, std::enable_if_t<is_trivially_serializable<T>::value>> : std::true_type {};
+    template <typename T>
     struct is_default_serializable_helper<archive::BufferOutputArchive, T, std::enable_if_t<is_trivially_serializable<T>::value>> : std::true_type {};
     template <typename T>
     struct is_default_serializable_helper<archive::BufferInputArchive, T, std::enable_if_t<is_trivially_serializable<T>::value>> : std::true_type {};
@@ -578,6 +584,10 @@ namespace madness {
     template <>
     struct is_archive<archive::BinaryFstreamInputArchive> : std::true_type {};
     template <>
+    struct is_archive<archive::BinaryPosixOutputArchive> : std::true_type {};
+    template <>
+    struct is_archive<archive::BinaryPosixInputArchive> : std::true_type {};
+    template <>
     struct is_archive<archive::BufferOutputArchive> : std::true_type {};
     template <>
     struct is_archive<archive::BufferInputArchive> : std::true_type {};
@@ -609,6 +619,8 @@ namespace madness {
     template <>
     struct is_output_archive<archive::BinaryFstreamOutputArchive> : std::true_type {};
     template <>
+    struct is_output_archive<archive::BinaryPosixOutputArchive> : std::true_type {};
+    template <>
     struct is_output_archive<archive::BufferOutputArchive> : std::true_type {};
     template <>
     struct is_output_archive<archive::VectorOutputArchive> : std::true_type {};
@@ -626,6 +638,8 @@ namespace madness {
     template <>
     struct is_input_archive<archive::BinaryFstreamInputArchive> : std::true_type {};
     template <>
+    struct is_input_archive<archive::BinaryPosixInputArchive> : std::true_type {};
+    template <>
     struct is_input_archive<archive::BufferInputArchive> : std::true_type {};
     template <>
     struct is_input_archive<archive::VectorInputArchive> : std::true_type {};
@@ -350,6 +350,15 @@ namespace madness {
         world.gop.min(min_ntask);
         world.gop.min(min_nmax);
 
+        TaskQStats tq = world.taskq.get_stats();
+        double throttle[5] = {double(tq.nthrottle), double(tq.ninline), double(tq.nrun),
+                              double(tq.nyield), double(tq.ngiveup)};
+        double max_throttle[5], min_throttle[5];
+        for (int i=0; i<5; ++i) max_throttle[i] = min_throttle[i] = throttle[i];
+        world.gop.sum(throttle, 5);
+        world.gop.max(max_throttle, 5);
+        world.gop.min(min_throttle, 5);
+
 #ifdef HAVE_PAPI
         double val[NUMEVENTS], max_val[NUMEVENTS], min_val[NUMEVENTS];
         for (int i=0; i<NUMEVENTS; ++i) {
@@ -399,6 +408,22 @@ namespace madness {
             printf("  #hi-pri tasks per node    %.2e / %.2e / %.2e\n",
                    min_npush_front, npush_front/world.size(), max_npush_front);
             printf("\n");
+            if (WorldTaskQueue::get_max_pending()) {
+                printf("  Task queue backpressure (min / avg / max), bound %zu tasks\n",
+                       WorldTaskQueue::get_max_pending());
+                printf("  -----------------------\n");
+                printf("#throttled adds per node    %.2e / %.2e / %.2e\n",
+                       min_throttle[0], throttle[0]/world.size(), max_throttle[0]);
+                printf("  #inline tasks per node    %.2e / %.2e / %.2e\n",
+                       min_throttle[1], throttle[1]/world.size(), max_throttle[1]);
+                printf("  #queue drains per node    %.2e / %.2e / %.2e\n",
+                       min_throttle[2], throttle[2]/world.size(), max_throttle[2]);
+                printf("        #yields per node    %.2e / %.2e / %.2e\n",
+                       min_throttle[3], throttle[3]/world.size(), max_throttle[3]);
+                printf("      #give-ups per node    %.2e / %.2e / %.2e\n",
+                       min_throttle[4], throttle[4]/world.size(), max_throttle[4]);
+                printf("\n");
+            }
 #ifdef HAVE_PAPI
             printf("         PAPI statistics (min / avg / max)\n");
             printf("         ---------------\n");
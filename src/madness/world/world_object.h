@@ -39,8 +39,10 @@
 #define MADNESS_WORLD_WORLD_OBJECT_H__INCLUDED
 
 #include <type_traits>
+#include <unordered_map>
 #include <madness/world/thread.h>
 #include <madness/world/world_task_queue.h>
+#include <madness/world/worldhash.h>
 
 /// \addtogroup world_object
 /// @{
@@ -70,6 +72,65 @@ namespace madness {
             }
         };
 
+        /// Messages that arrived before their object was constructed, queued per object.
+
+        /// The queues are held in a number of independently locked shards of
+        /// a hash map keyed by the object id, so that buffering a message and
+        /// collecting the messages of a newly constructed object cost O(1)
+        /// and objects in different shards never contend for a lock.  There
+        /// is one instance shared by all \c WorldObject types and worlds; the
+        /// ids are unique across both.
+        class PendingMsgQueues {
+        public:
+            typedef std::list<PendingMsg> queueT;
+
+            /// A part of the map with its own lock.
+            struct Shard {
+                Spinlock mutex;
+                std::unordered_map<uniqueidT, queueT, Hash<uniqueidT> > queues;
+            };
+
+        private:
+            static const std::size_t nshard = 64;
+
+            Shard shards[nshard];
+
+            PendingMsgQueues() = default;
+
+        public:
+            PendingMsgQueues(const PendingMsgQueues&) = delete;
+            PendingMsgQueues& operator=(const PendingMsgQueues&) = delete;
+
+            /// The queues of this process.
+            static PendingMsgQueues& instance();
+
+            /// The shard holding the queue of object \c id.
+
+            /// Callers lock \c mutex of the shard while they use \c queues.
+            Shard& shard(const uniqueidT& id) {
+                return shards[(id.get_obj_id() ^ (id.get_world_id() << 5)) % nshard];
+            }
+
+            /// Appends a message to the queue of its object; the caller must hold the shard lock.
+            void push(Shard& s, const uniqueidT& id, am_handlerT handler, const AmArg& arg) {
+                s.queues[id].push_back(PendingMsg(id, handler, arg));
+            }
+
+            /// Moves the queue of object \c id into \c q; the caller must hold the shard lock.
+
+            /// \return False if there were no messages for this object.
+            bool take(Shard& s, const uniqueidT& id, queueT& q) {
+                auto it = s.queues.find(id);
+                if (it == s.queues.end()) return false;
+                q.swap(it->second);
+                s.queues.erase(it);
+                return true;
+            }
+
+            /// Total number of buffered messages (locks each shard in turn).
+            std::size_t size();
+        };
+
         /// \todo Brief description needed.
 
         /// We cannot use the normal task forwarding stuff here because pending
@@ -364,8 +425,8 @@ namespace madness {
         WorldObject& operator=(const WorldObject&) = delete;
 
     private:
-        /// \todo Description needed.
-        typedef std::list<detail::PendingMsg> pendingT;
+        /// Queue of the messages that arrived for one object before it was ready.
+        typedef detail::PendingMsgQueues::queueT pendingT;
 
         /// \todo Description needed.
         typedef detail::voidT voidT;
@@ -378,10 +439,6 @@ namespace madness {
         uniqueidT objid; ///< Sense of self.
 
 
-        static Spinlock pending_mutex; ///< \todo Description needed.
-        static volatile pendingT pending; ///< Buffer for pending messages.
-
-
         /// \todo Complete: Determine if [unknown] is ready (for ...).
 
         /// The slightly convoluted logic is to ensure ordering when
@@ -407,10 +464,9 @@ namespace madness {
                 if (obj->ready || arg.is_pending()) return true;
             }
 
-            MADNESS_PRAGMA_CLANG(diagnostic push)
-            MADNESS_PRAGMA_CLANG(diagnostic ignored "-Wundefined-var-template")
-
-            ScopedMutex<Spinlock> lock(pending_mutex); // BEGIN CRITICAL SECTION
+            detail::PendingMsgQueues& pending = detail::PendingMsgQueues::instance();
+            auto& shard = pending.shard(id);
+            ScopedMutex<Spinlock> lock(shard.mutex); // BEGIN CRITICAL SECTION
 
             if (!obj) obj = static_cast<objT*>(arg.get_world()->template ptr_from_id<Derived>(id));
 
@@ -419,9 +475,7 @@ namespace madness {
                     return true; // END CRITICAL SECTION
             }
             const_cast<AmArg&>(arg).set_pending();
-            const_cast<pendingT&>(pending).push_back(detail::PendingMsg(id, ptr, arg));
-
-            MADNESS_PRAGMA_CLANG(diagnostic pop)
+            pending.push(shard, id, ptr, arg);
 
             return false; // END CRITICAL SECTION
         }
@@ -627,31 +681,17 @@ namespace madness {
         /// until this routine is invoked.
         void process_pending() {
             // Messages may be arriving while we are processing the
-            // pending queue.  To maximize concurrency copy messages
-            // out of queue before processing outside critical section.
+            // pending queue.  To maximize concurrency move the messages
+            // out of the queue before processing outside critical section.
             //int ndone = 0;
+            detail::PendingMsgQueues& pending = detail::PendingMsgQueues::instance();
+            auto& shard = pending.shard(objid);
             while (!ready) {
                 pendingT tmp;
 
-                MADNESS_PRAGMA_CLANG(diagnostic push)
-                MADNESS_PRAGMA_CLANG(diagnostic ignored "-Wundefined-var-template")
-
-                pending_mutex.lock(); // BEGIN CRITICAL SECTION
-                pendingT& nv = const_cast<pendingT&>(pending);
-                for (pendingT::iterator it=nv.begin(); it!=nv.end();) {
-                    detail::PendingMsg& p = *it;
-                    if (p.id == objid) {
-                        tmp.push_back(p);
-                        it = nv.erase(it);
-                    }
-                    else {
-                        ++it;
-                    }
-                }
-                if (tmp.size() == 0) ready=true;
-                pending_mutex.unlock(); // END CRITICAL SECTION
-
-                MADNESS_PRAGMA_CLANG(diagnostic pop)
+                shard.mutex.lock(); // BEGIN CRITICAL SECTION
+                if (!pending.take(shard, objid, tmp)) ready=true;
+                shard.mutex.unlock(); // END CRITICAL SECTION
 
                 while (tmp.size()) {
                     tmp.front().invokehandler();
@@ -1440,15 +1480,6 @@ namespace madness {
     }
 }
 
-#ifdef WORLD_INSTANTIATE_STATIC_TEMPLATES
-template <typename Derived>
-volatile std::list<madness::detail::PendingMsg> madness::WorldObject<Derived>::pending;
-
-template <typename Derived>
-madness::Spinlock madness::WorldObject<Derived>::pending_mutex;
-
-#endif
-
 #endif // MADNESS_WORLD_WORLD_OBJECT_H__INCLUDED
 
 /// @}
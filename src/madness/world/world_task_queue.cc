@@ -36,6 +36,9 @@
 */
 
 #include <madness/world/world_task_queue.h>
+#include <madness/world/worldrmi.h>
+#include <cstdlib>
+#include <thread>
 
 namespace madness {
 
@@ -51,10 +54,80 @@ namespace madness {
         if (debug) std::cerr << w->rank() << ": Task " << (void*) this << " has completed" << std::endl;
     }
 
+    std::size_t WorldTaskQueue::max_pending = 0;
+
+    namespace {
+
+        /// Reads the default bound on pending tasks from the environment, once
+        void init_max_pending() {
+            static bool done = false;
+            if (done) return;
+            done = true;
+            const char* env = getenv("MAD_MAX_PENDING_TASKS");
+            if (env) {
+                const long n = std::atol(env);
+                WorldTaskQueue::set_max_pending(n > 0 ? std::size_t(n) : 0);
+            }
+        }
+
+    }  // namespace
+
     WorldTaskQueue::WorldTaskQueue(World& world)
             : world(world)
             , me(world.rank()) {
         nregistered = 0;
+        init_max_pending();
+    }
+
+    bool WorldTaskQueue::throttle(TaskInterface* t) {
+#if !(defined(HAVE_INTEL_TBB) || defined(HAVE_PARSEC))
+        // Only a thread that is not inside a task waits here: a task that
+        // waits may hold back the very tasks the queue needs to drain, and
+        // tasks run from here add tasks themselves.  The server thread never
+        // runs tasks.
+        static thread_local bool busy = false;
+        if (busy || (ThreadPool::get_task_depth() > 0) || RMI::get_this_thread_is_server()) return false;
+        struct guard {
+            guard() {busy = true;}
+            ~guard() {busy = false;}
+        } g;
+        nthrottle++;
+
+        // A ready task is run right away by the adding thread, as the pool
+        // would run it.
+        if (t->probe() && (t->get_nthread() == 1)) {
+            ninline++;
+            nregistered++;
+            t->set_info(&world, this);
+            t->run(TaskThreadEnv(1,0,0));
+            delete t;       // notifies completion
+            return true;
+        }
+
+        // Otherwise help draining the queue.  Give up once nothing has been
+        // run for a while, e.g. when the pending tasks wait for remote data
+        // or for the caller itself, and let the queue grow to twice its size
+        // before throttling again.
+        const int maxidle = 1000;
+        int idle = 0;
+        while (std::size_t(nregistered) >= max_pending) {
+            if (ThreadPool::run_task()) {
+                nrun++;
+                idle = 0;
+            }
+            else if (++idle > maxidle) {
+                ngiveup++;
+                slack = std::size_t(nregistered);
+                return false;
+            }
+            else {
+                nyield++;
+                std::this_thread::yield();
+            }
+        }
+        slack = 0;
+#endif
+        return false;
     }
 
 }  // namespace madness
@@ -38,6 +38,8 @@
 #ifndef MADNESS_WORLD_WORLD_TASK_QUEUE_H__INCLUDED
 #define MADNESS_WORLD_WORLD_TASK_QUEUE_H__INCLUDED
 
+#include <atomic>
+#include <cstdint>
 #include <type_traits>
 #include <iostream>
 
@@ -313,6 +315,19 @@ namespace madness {
     }  // namespace detail
 
 
+    /// Statistics of the backpressure in \c WorldTaskQueue::add()
+    struct TaskQStats {
+        uint64_t nthrottle;     ///< #adds that found the queue over its bound
+        uint64_t ninline;       ///< #new tasks run inline by the adding thread
+        uint64_t nrun;          ///< #batches of queued tasks run by throttled adds
+        uint64_t nyield;        ///< #times a throttled add found no ready task and yielded
+        uint64_t ngiveup;       ///< #throttled adds that gave up waiting for the queue to drain
+
+        TaskQStats()
+            : nthrottle(0), ninline(0), nrun(0), nyield(0), ngiveup(0) {}
+    };
+
+
     /// Multi-threaded queue to manage and run tasks.
 
     /// \todo A concise description of the inner workings...
@@ -323,11 +338,20 @@ namespace madness {
         const ProcessID me; ///< This process.
         AtomicInt nregistered; ///< Count of pending tasks.
 
+        static std::size_t max_pending; ///< Pending tasks at which add() throttles, 0 for no bound
+        std::atomic<std::size_t> slack{0}; ///< Raises the bound after an add gave up waiting
+        std::atomic<uint64_t> nthrottle{0}, ninline{0}, nrun{0}, nyield{0}, ngiveup{0};
+
         /// \todo Brief description needed.
         void notify() {
             nregistered--;
         }
 
+        /// Apply backpressure to an add over the bound
+
+        /// \return True if the task was run inline and must not be queued.
+        bool throttle(TaskInterface* t);
+
         /// \todo Brief description needed.
 
         /// This template is used in the reduce kernel.
@@ -452,6 +476,42 @@ namespace madness {
             return nregistered;
         }
 
+        /// Bound the number of pending tasks, 0 for no bound.
+
+        /// A thread that adds a task to a queue holding \c n or more pending
+        /// tasks runs the new task itself if its dependencies are satisfied,
+        /// which keeps a loop adding tasks from queuing millions of them
+        /// before any completes.  Otherwise it runs queued tasks, or yields
+        /// if none is ready, until the queue drains below the bound.  Only
+        /// the main thread and pool threads between tasks are throttled,
+        /// never a thread inside a task, which might hold back the tasks
+        /// the queue waits for, or the RMI server thread.  An add that makes
+        /// no progress gives up waiting, so the bound is soft.  The default
+        /// is taken from the environment variable \c MAD_MAX_PENDING_TASKS,
+        /// and otherwise there is no bound.
+        /// \note Code that adds tasks while holding a lock that other tasks
+        /// need, such as a container accessor, must not run with a bound.
+        /// \param[in] n The bound for all task queues of this process.
+        static void set_max_pending(std::size_t n) {
+            max_pending = n;
+        }
+
+        /// Returns the bound on the number of pending tasks, 0 for no bound.
+        static std::size_t get_max_pending() {
+            return max_pending;
+        }
+
+        /// Returns the statistics of the backpressure.
+        TaskQStats get_stats() const {
+            TaskQStats stats;
+            stats.nthrottle = nthrottle;
+            stats.ninline = ninline;
+            stats.nrun = nrun;
+            stats.nyield = nyield;
+            stats.ngiveup = ngiveup;
+            return stats;
+        }
+
 
         /// Add a new local task, taking ownership of the pointer.
 
@@ -464,6 +524,7 @@ namespace madness {
         /// tasks and be deleted.
         /// \param[in] t Pointer to the task.
         void add(TaskInterface* t)  {
+            if (max_pending && (std::size_t(nregistered) >= max_pending + slack) && throttle(t)) return;
             nregistered++;
 
             t->set_info(&world, this);       // Stuff info